@@ -6,6 +6,8 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 #include "cpp-common/bt2s/string-view.hpp"
 
@@ -65,6 +67,76 @@ void StrScanner::skipWhitespaces() noexcept
     }
 }
 
+namespace {
+
+/*
+ * Returns a word of which all the bytes are `byte`.
+ */
+constexpr std::uint64_t wordOfBytes(const std::uint8_t byte) noexcept
+{
+    return UINT64_C(0x0101010101010101) * byte;
+}
+
+/*
+ * Returns whether or not any byte of `word` is less than `byte`, which
+ * must be less than or equal to 0x80.
+ */
+constexpr bool wordHasByteLt(const std::uint64_t word, const std::uint8_t byte) noexcept
+{
+    return ((word - wordOfBytes(byte)) & ~word & wordOfBytes(0x80)) != 0;
+}
+
+/*
+ * Returns whether or not any byte of `word` is `byte`.
+ */
+constexpr bool wordHasByte(const std::uint64_t word, const std::uint8_t byte) noexcept
+{
+    return wordHasByteLt(word ^ wordOfBytes(byte), 1);
+}
+
+/*
+ * Returns whether or not StrScanner::tryScanLitStr() needs to handle
+ * the character `ch` specifically.
+ */
+bool isLitStrSpecialChar(const char ch) noexcept
+{
+    return ch == '"' || ch == '\\' || std::iscntrl(ch);
+}
+
+} /* namespace */
+
+StrScanner::Iter StrScanner::_findLitStrSpecialChar() const noexcept
+{
+    auto at = _mAt;
+
+    /*
+     * Skip eight regular characters at a time, testing all the bytes
+     * of a word at once.
+     *
+     * With the C locale, which Babeltrace uses, std::iscntrl() is true
+     * for 0 to 0x1f and for 0x7f.
+     */
+    while (_mStr.end() - at >= 8) {
+        std::uint64_t word;
+
+        std::memcpy(&word, &(*at), sizeof(word));
+
+        if (wordHasByteLt(word, 0x20) || wordHasByte(word, 0x7f) || wordHasByte(word, '"') ||
+            wordHasByte(word, '\\')) {
+            break;
+        }
+
+        at += sizeof(word);
+    }
+
+    /* Find the exact position */
+    while (at != _mStr.end() && !isLitStrSpecialChar(*at)) {
+        ++at;
+    }
+
+    return at;
+}
+
 void StrScanner::_appendEscapedUnicodeChar(const Iter at)
 {
     /* Create array of four hex characters */
@@ -204,6 +276,18 @@ bt2s::string_view StrScanner::tryScanLitStr(const bt2s::string_view escapeSeqSta
      * process.
      */
     while (!this->isDone()) {
+        {
+            /* Append the next regular characters at once */
+            const auto specialCharAt = this->_findLitStrSpecialChar();
+
+            _mStrBuf.append(_mAt, specialCharAt);
+            this->_incrAt(specialCharAt - _mAt);
+
+            if (this->isDone()) {
+                break;
+            }
+        }
+
         /* Check for illegal control character */
         if (std::iscntrl(*_mAt)) {
             BT_CPPLOGE_TEXT_LOC_APPEND_CAUSE_AND_THROW(
@@ -256,6 +256,14 @@ private:
      */
     bool _tryAppendEscapedChar(bt2s::string_view escapeSeqStartList);
 
+    /*
+     * Returns the position of the first character, from the current
+     * position, which tryScanLitStr() can't append as is to
+     * `_mStrBuf` (`"`, `\`, or a control character), or `str().end()`
+     * if there's none.
+     */
+    Iter _findLitStrSpecialChar() const noexcept;
+
     /*
      * Tries to scan any character, returning it and advancing the
      * current position on success, or returning -1 if the current
@@ -179,6 +179,45 @@ end:
 	return ret;
 }
 
+/*
+ * Makes sure that the current packet has at least `size_bits` bits
+ * left after the current offset, increasing its size as needed.
+ *
+ * On success, the caller may write up to `size_bits` bits (including
+ * any alignment padding) with the `_no_align()` and `_no_check()`
+ * functions below without any other bounds check.
+ */
+static inline
+int bt_ctfser_reserve_in_current_packet(struct bt_ctfser *ctfser,
+		uint64_t size_bits)
+{
+	int ret = 0;
+
+	while (G_UNLIKELY(!_bt_ctfser_has_space_left(ctfser, size_bits))) {
+		ret = _bt_ctfser_increase_cur_packet_size(ctfser);
+		if (G_UNLIKELY(ret)) {
+			break;
+		}
+	}
+
+	return ret;
+}
+
+/*
+ * Like bt_ctfser_align_offset_in_current_packet(), but without checking
+ * the space left: the caller must have reserved enough space with
+ * bt_ctfser_reserve_in_current_packet().
+ */
+static inline
+void _bt_ctfser_align_offset_in_current_packet_no_check(
+		struct bt_ctfser *ctfser, uint64_t alignment_bits)
+{
+	BT_ASSERT_DBG(alignment_bits > 0);
+	_bt_ctfser_incr_offset(ctfser,
+		BT_ALIGN(ctfser->offset_in_cur_packet_bits, alignment_bits) -
+			ctfser->offset_in_cur_packet_bits);
+}
+
 static inline
 int _bt_ctfser_write_byte_aligned_unsigned_int_no_align(
 		struct bt_ctfser *ctfser, uint64_t value,
@@ -501,30 +540,37 @@ int bt_ctfser_write_float64(struct bt_ctfser *ctfser, double value,
 
 /*
  * Writes bytes at the current offset within the current packet.
+ *
+ * This function reserves the space for all the bytes at once and then
+ * copies them with a single memcpy() call.
  */
 static inline
 int bt_ctfser_write_data(struct bt_ctfser *ctfser, const uint8_t *value, uint64_t len)
 {
 	int ret = 0;
-	uint64_t i;
 
 	ret = bt_ctfser_align_offset_in_current_packet(ctfser, 8);
 	if (G_UNLIKELY(ret)) {
 		goto end;
 	}
 
-	for (i = 0; i < len; i++) {
-		if (G_UNLIKELY(!_bt_ctfser_has_space_left(ctfser, 8))) {
-			ret = _bt_ctfser_increase_cur_packet_size(ctfser);
-			if (G_UNLIKELY(ret)) {
-				goto end;
-			}
-		}
+	if (G_UNLIKELY(len == 0)) {
+		goto end;
+	}
 
-		memcpy(_bt_ctfser_get_addr(ctfser), &value[i], sizeof(value[i]));
-		_bt_ctfser_incr_offset(ctfser, 8);
+	if (G_UNLIKELY(len > UINT64_MAX / 8)) {
+		ret = -1;
+		goto end;
+	}
+
+	ret = bt_ctfser_reserve_in_current_packet(ctfser, len * 8);
+	if (G_UNLIKELY(ret)) {
+		goto end;
 	}
 
+	memcpy(_bt_ctfser_get_addr(ctfser), value, len);
+	_bt_ctfser_incr_offset(ctfser, len * 8);
+
 end:
 	return ret;
 }
@@ -536,34 +582,8 @@ end:
 static inline
 int bt_ctfser_write_string(struct bt_ctfser *ctfser, const char *value)
 {
-	int ret = 0;
-	const char *at = value;
-
-	ret = bt_ctfser_align_offset_in_current_packet(ctfser, 8);
-	if (G_UNLIKELY(ret)) {
-		goto end;
-	}
-
-	while (true) {
-		if (G_UNLIKELY(!_bt_ctfser_has_space_left(ctfser, 8))) {
-			ret = _bt_ctfser_increase_cur_packet_size(ctfser);
-			if (G_UNLIKELY(ret)) {
-				goto end;
-			}
-		}
-
-		memcpy(_bt_ctfser_get_addr(ctfser), at, sizeof(*at));
-		_bt_ctfser_incr_offset(ctfser, 8);
-
-		if (G_UNLIKELY(*at == '\0')) {
-			break;
-		}
-
-		at++;
-	}
-
-end:
-	return ret;
+	return bt_ctfser_write_data(ctfser, (const uint8_t *) value,
+		strlen(value) + 1);
 }
 
 /*
@@ -8,8 +8,11 @@
 
 #define BT_LOG_OUTPUT_LEVEL (fdc->log_level)
 #define BT_LOG_TAG          "FD-CACHE"
+#include <errno.h>
 #include <fcntl.h>
 #include <glib.h>
+#include <inttypes.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -31,8 +34,23 @@ struct fd_handle_internal
     struct bt_fd_cache_handle fd_handle;
     uint64_t ref_count;
     struct file_key *key;
+
+    /*
+     * Link within the unused handle queue of the cache when
+     * `ref_count` is 0.
+     */
+    GList lru_link;
 };
 
+/*
+ * Default maximum number of open file descriptors when the limit of
+ * the process is unknown or unlimited.
+ */
+#define DEFAULT_MAX_OPEN_FDS 256
+
+/* Minimum default maximum number of open file descriptors */
+#define MIN_DEFAULT_MAX_OPEN_FDS 16
+
 static void fd_cache_handle_internal_destroy(struct fd_handle_internal *internal_fd)
 {
     if (!internal_fd) {
@@ -80,17 +98,73 @@ static void file_key_destroy(gpointer data)
     g_free(fk);
 }
 
-int bt_fd_cache_init(struct bt_fd_cache *fdc, int log_level)
+/*
+ * Returns the default maximum number of open file descriptors of a
+ * cache: half of the soft file descriptor limit of the process, leaving
+ * the other half to the rest of the process.
+ */
+static unsigned int default_max_open_fds(void)
+{
+    struct rlimit rlim;
+
+    if (getrlimit(RLIMIT_NOFILE, &rlim) != 0 || rlim.rlim_cur == RLIM_INFINITY ||
+        rlim.rlim_cur / 2 > G_MAXUINT) {
+        return DEFAULT_MAX_OPEN_FDS;
+    }
+
+    return MAX((unsigned int) (rlim.rlim_cur / 2), MIN_DEFAULT_MAX_OPEN_FDS);
+}
+
+/*
+ * Closes unreferenced handles of `fdc`, from the least recently used
+ * one, until `fdc` has at most `max_open_fds` open file descriptors or
+ * it has no unreferenced handles.
+ *
+ * `fdc->lock` must be held.
+ */
+static void evict_unused_handles(struct bt_fd_cache *fdc, unsigned int max_open_fds)
+{
+    while (g_hash_table_size(fdc->cache) > max_open_fds &&
+           !g_queue_is_empty(&fdc->unused_handles)) {
+        GList *link = g_queue_pop_head_link(&fdc->unused_handles);
+        struct fd_handle_internal *fd_internal = static_cast<fd_handle_internal *>(link->data);
+        gboolean ret;
+
+        BT_ASSERT(fd_internal->ref_count == 0);
+        BT_LOGD("Closing least recently used file descriptor: fd=%d",
+                fd_internal->fd_handle.fd);
+        fdc->stats.evictions++;
+
+        /* This closes the file descriptor */
+        ret = g_hash_table_remove(fdc->cache, fd_internal->key);
+        BT_ASSERT(ret);
+    }
+}
+
+int bt_fd_cache_init(struct bt_fd_cache *fdc, unsigned int max_open_fds, int log_level)
 {
     int ret = 0;
 
     fdc->log_level = log_level;
+    fdc->max_open_fds = max_open_fds > 0 ? max_open_fds : default_max_open_fds();
+    fdc->stats = {};
+    g_queue_init(&fdc->unused_handles);
     fdc->cache = g_hash_table_new_full(file_key_hash, file_key_equal, file_key_destroy,
                                        (GDestroyNotify) fd_cache_handle_internal_destroy);
     if (!fdc->cache) {
         ret = -1;
+        goto end;
+    }
+
+    ret = pthread_mutex_init(&fdc->lock, NULL);
+    if (ret) {
+        BT_LOGE("Failed to initialize mutex: ret=%d", ret);
+        g_hash_table_destroy(fdc->cache);
+        fdc->cache = NULL;
+        ret = -1;
     }
 
+end:
     return ret;
 }
 
@@ -101,10 +175,19 @@ void bt_fd_cache_fini(struct bt_fd_cache *fdc)
     }
 
     /*
-     * All handle should have been removed for the hashtable at this point.
+     * All handle should have been put at this point: only the
+     * unreferenced handles remain.
      */
-    BT_ASSERT(g_hash_table_size(fdc->cache) == 0);
+    BT_ASSERT(g_hash_table_size(fdc->cache) == fdc->unused_handles.length);
+    BT_LOGD("Finalizing file descriptor cache: max-open-fds=%u, opens=%" PRIu64
+            ", hits=%" PRIu64 ", evictions=%" PRIu64,
+            fdc->max_open_fds, fdc->stats.opens, fdc->stats.hits, fdc->stats.evictions);
+
+    /* The links of `unused_handles` belong to the handles */
+    g_queue_init(&fdc->unused_handles);
     g_hash_table_destroy(fdc->cache);
+    fdc->cache = NULL;
+    pthread_mutex_destroy(&fdc->lock);
 
 end:
     return;
@@ -117,6 +200,7 @@ struct bt_fd_cache_handle *bt_fd_cache_get_handle(struct bt_fd_cache *fdc, const
     struct file_key fk;
     int ret, fd = -1;
 
+    pthread_mutex_lock(&fdc->lock);
     ret = stat(path, &statbuf);
     if (ret < 0) {
         /*
@@ -141,7 +225,17 @@ struct bt_fd_cache_handle *bt_fd_cache_get_handle(struct bt_fd_cache *fdc, const
     if (!fd_internal) {
         struct file_key *file_key;
 
+        /* Make room for the new file descriptor */
+        evict_unused_handles(fdc, fdc->max_open_fds - 1);
         fd = open(path, O_RDONLY);
+        if (fd < 0 && (errno == EMFILE || errno == ENFILE)) {
+            /* Out of file descriptors: close all the unused ones and retry */
+            BT_LOGD_ERRNO("Failed to open file: retrying after closing unused file descriptors",
+                          ": path=%s", path);
+            evict_unused_handles(fdc, 0);
+            fd = open(path, O_RDONLY);
+        }
+
         if (fd < 0) {
             BT_LOGE_ERRNO("Failed to open file", "path=%s", path);
             goto error;
@@ -164,9 +258,18 @@ struct bt_fd_cache_handle *bt_fd_cache_get_handle(struct bt_fd_cache *fdc, const
         fd_internal->fd_handle.fd = fd;
         fd_internal->ref_count = 0;
         fd_internal->key = file_key;
+        fd_internal->lru_link.data = fd_internal;
 
         /* Insert the newly created fd handle. */
         g_hash_table_insert(fdc->cache, fd_internal->key, fd_internal);
+        fdc->stats.opens++;
+    } else {
+        fdc->stats.hits++;
+
+        if (fd_internal->ref_count == 0) {
+            /* Not unused anymore */
+            g_queue_unlink(&fdc->unused_handles, &fd_internal->lru_link);
+        }
     }
 
     fd_internal->ref_count++;
@@ -187,6 +290,7 @@ error:
     fd_cache_handle_internal_destroy(fd_internal);
     fd_internal = NULL;
 end:
+    pthread_mutex_unlock(&fdc->lock);
     return (struct bt_fd_cache_handle *) fd_internal;
 }
 
@@ -200,22 +304,23 @@ void bt_fd_cache_put_handle(struct bt_fd_cache *fdc, struct bt_fd_cache_handle *
 
     fd_internal = (struct fd_handle_internal *) handle;
 
+    pthread_mutex_lock(&fdc->lock);
     BT_ASSERT(fd_internal->ref_count > 0);
 
-    if (fd_internal->ref_count > 1) {
-        fd_internal->ref_count--;
-    } else {
-        gboolean ret;
-        int close_ret;
+    fd_internal->ref_count--;
 
-        close_ret = close(fd_internal->fd_handle.fd);
-        if (close_ret == -1) {
-            BT_LOGE_ERRNO("Failed to close file descriptor", ": fd=%d", fd_internal->fd_handle.fd);
-        }
-        ret = g_hash_table_remove(fdc->cache, fd_internal->key);
-        BT_ASSERT(ret);
+    if (fd_internal->ref_count == 0) {
+        /*
+         * Keep the file descriptor open as the most recently used
+         * unused one, unless the cache has too many open file
+         * descriptors.
+         */
+        g_queue_push_tail_link(&fdc->unused_handles, &fd_internal->lru_link);
+        evict_unused_handles(fdc, fdc->max_open_fds);
     }
 
+    pthread_mutex_unlock(&fdc->lock);
+
 end:
     return;
 }
@@ -10,16 +10,68 @@
 #define BABELTRACE_FD_CACHE_FD_CACHE_HPP
 
 #include <glib.h>
+#include <pthread.h>
+#include <stdint.h>
 
 struct bt_fd_cache_handle
 {
     int fd;
 };
 
+struct bt_fd_cache_stats
+{
+    /* Number of files which the cache opened */
+    uint64_t opens;
+
+    /* Number of handles which the cache returned without opening a file */
+    uint64_t hits;
+
+    /* Number of unreferenced handles which the cache closed */
+    uint64_t evictions;
+};
+
+/*
+ * File descriptor cache.
+ *
+ * The cache identifies a file by its device and inode numbers: getting
+ * handles of the same file through different paths (hard links,
+ * symbolic links, bind mounts) returns the same handle, sharing a
+ * single file descriptor.
+ *
+ * When you put the last reference of a handle, the cache keeps its
+ * file descriptor open, as long as the number of open file descriptors
+ * of the cache doesn't exceed its maximum. When the cache needs to
+ * close unreferenced handles, it closes the least recently used ones
+ * first.
+ *
+ * The cache never closes a referenced handle: the number of open file
+ * descriptors may exceed the maximum when the users of the cache hold
+ * that many handles.
+ */
 struct bt_fd_cache
 {
     int log_level;
+
+    /* File key -> `struct fd_handle_internal` (owned) */
     GHashTable *cache;
+
+    /*
+     * Unreferenced handles of `cache`, from the least to the most
+     * recently used one (weak).
+     */
+    GQueue unused_handles;
+
+    /* Maximum number of open file descriptors (referenced or not) */
+    unsigned int max_open_fds;
+
+    struct bt_fd_cache_stats stats;
+
+    /*
+     * Protects all the members above and the reference counts of the
+     * handles: threads may get and put handles of the same cache
+     * concurrently.
+     */
+    pthread_mutex_t lock;
 };
 
 static inline int bt_fd_cache_handle_get_fd(struct bt_fd_cache_handle *handle)
@@ -27,7 +79,12 @@ static inline int bt_fd_cache_handle_get_fd(struct bt_fd_cache_handle *handle)
     return handle->fd;
 }
 
-int bt_fd_cache_init(struct bt_fd_cache *fdc, int log_level);
+/*
+ * Initializes the file descriptor cache `fdc` which keeps at most
+ * `max_open_fds` file descriptors open, or a maximum derived from the
+ * file descriptor limit of the process if `max_open_fds` is 0.
+ */
+int bt_fd_cache_init(struct bt_fd_cache *fdc, unsigned int max_open_fds, int log_level);
 
 void bt_fd_cache_fini(struct bt_fd_cache *fdc);
 
@@ -597,6 +597,24 @@ void finalize_enumeration_field_class_mapping(
 	BT_OBJECT_PUT_REF_AND_RESET(mapping->range_set);
 }
 
+static
+void enum_index_fini(struct bt_field_class_enumeration_index *index)
+{
+	if (index->segments) {
+		g_array_free(index->segments, TRUE);
+		index->segments = NULL;
+	}
+
+	if (index->labels) {
+		g_ptr_array_free(index->labels, TRUE);
+		index->labels = NULL;
+	}
+
+	g_free(index->dense);
+	index->dense = NULL;
+	index->is_built = false;
+}
+
 static
 void destroy_enumeration_field_class(struct bt_object *obj)
 {
@@ -623,6 +641,7 @@ void destroy_enumeration_field_class(struct bt_object *obj)
 		fc->label_buf = NULL;
 	}
 
+	enum_index_fini(&fc->index);
 	g_free(fc);
 }
 
@@ -815,6 +834,337 @@ bt_field_class_enumeration_signed_mapping_borrow_ranges_const(
 	return (const void *) mapping->range_set;
 }
 
+/*
+ * Maximum number of values which the dense table of an enumeration
+ * field class lookup index covers.
+ */
+#define ENUM_INDEX_DENSE_MAX_LEN	4096
+
+/*
+ * Encodes the value `value` of the enumeration field class `enum_fc`
+ * (raw bits for a signed one) so that unsigned comparisons of encoded
+ * values order them.
+ */
+static inline
+uint64_t enum_index_encode_value(
+		const struct bt_field_class_enumeration *enum_fc,
+		uint64_t value)
+{
+	if (enum_fc->common.common.type ==
+			BT_FIELD_CLASS_TYPE_SIGNED_ENUMERATION) {
+		value ^= UINT64_C(1) << 63;
+	}
+
+	return value;
+}
+
+static
+gint compare_uint64(gconstpointer a, gconstpointer b)
+{
+	uint64_t val_a = *(const uint64_t *) a;
+	uint64_t val_b = *(const uint64_t *) b;
+
+	return val_a < val_b ? -1 : (val_a > val_b ? 1 : 0);
+}
+
+/*
+ * Returns the index of the segment of `index` containing the encoded
+ * value `value`, or -1 if there's none.
+ */
+static inline
+gint64 enum_index_find_segment(
+		const struct bt_field_class_enumeration_index *index,
+		uint64_t value)
+{
+	guint low = 0, high = index->segments->len;
+
+	if (index->dense) {
+		if (value - index->dense_lower >= index->dense_len) {
+			return -1;
+		}
+
+		return index->dense[value - index->dense_lower];
+	}
+
+	/* Find the last segment of which the lower bound is <= `value` */
+	while (low < high) {
+		guint mid = low + (high - low) / 2;
+
+		if (bt_g_array_index(index->segments,
+				struct bt_field_class_enumeration_index_segment,
+				mid).lower <= value) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return (gint64) low - 1;
+}
+
+/*
+ * Builds the lookup index of `enum_fc`.
+ *
+ * The index splits the value domain into elementary segments at each
+ * mapping range bound, and then lists the labels of each segment, in
+ * mapping order, like a linear scan of the mappings finds them.
+ */
+static
+int enum_index_build(struct bt_field_class_enumeration *enum_fc)
+{
+	struct bt_field_class_enumeration_index *index = &enum_fc->index;
+	GArray *bounds;
+	guint *last_mapping_indexes = NULL;
+	guint i, seg_i, label_offset = 0;
+	int pass;
+	int ret = 0;
+
+	BT_ASSERT(!index->is_built);
+	bounds = g_array_new(FALSE, FALSE, sizeof(uint64_t));
+	index->segments = g_array_new(FALSE, TRUE,
+		sizeof(struct bt_field_class_enumeration_index_segment));
+	index->labels = g_ptr_array_new();
+	if (!bounds || !index->segments || !index->labels) {
+		BT_LIB_LOGE("Failed to allocate a GArray.");
+		goto error;
+	}
+
+	/* Collect the segment lower bounds */
+	for (i = 0; i < enum_fc->mappings->len; i++) {
+		const struct bt_field_class_enumeration_mapping *mapping =
+			BT_FIELD_CLASS_ENUM_MAPPING_AT_INDEX(enum_fc, i);
+		guint j;
+
+		for (j = 0; j < mapping->range_set->ranges->len; j++) {
+			const struct bt_integer_range *range =
+				BT_INTEGER_RANGE_SET_RANGE_AT_INDEX(
+					mapping->range_set, j);
+			uint64_t bound = enum_index_encode_value(enum_fc,
+				range->lower.u);
+
+			g_array_append_val(bounds, bound);
+			bound = enum_index_encode_value(enum_fc,
+				range->upper.u);
+
+			if (bound != UINT64_MAX) {
+				bound++;
+				g_array_append_val(bounds, bound);
+			}
+		}
+	}
+
+	g_array_sort(bounds, compare_uint64);
+
+	for (i = 0; i < bounds->len; i++) {
+		struct bt_field_class_enumeration_index_segment seg = { 0 };
+
+		seg.lower = bt_g_array_index(bounds, uint64_t, i);
+		if (index->segments->len > 0 &&
+				bt_g_array_index(index->segments,
+					struct bt_field_class_enumeration_index_segment,
+					index->segments->len - 1).lower == seg.lower) {
+			continue;
+		}
+
+		g_array_append_val(index->segments, seg);
+	}
+
+	/*
+	 * Count the labels of each segment (first pass), and then add
+	 * them (second pass). A mapping with overlapping ranges adds its
+	 * label once to a given segment.
+	 */
+	last_mapping_indexes = g_new(guint, index->segments->len + 1);
+	if (!last_mapping_indexes) {
+		BT_LIB_LOGE("Failed to allocate an array.");
+		goto error;
+	}
+
+	for (pass = 0; pass < 2; pass++) {
+		for (seg_i = 0; seg_i < index->segments->len; seg_i++) {
+			last_mapping_indexes[seg_i] = G_MAXUINT;
+		}
+
+		for (i = 0; i < enum_fc->mappings->len; i++) {
+			const struct bt_field_class_enumeration_mapping *mapping =
+				BT_FIELD_CLASS_ENUM_MAPPING_AT_INDEX(enum_fc, i);
+			guint j;
+
+			for (j = 0; j < mapping->range_set->ranges->len; j++) {
+				const struct bt_integer_range *range =
+					BT_INTEGER_RANGE_SET_RANGE_AT_INDEX(
+						mapping->range_set, j);
+				uint64_t upper = enum_index_encode_value(
+					enum_fc, range->upper.u);
+
+				for (seg_i = (guint) enum_index_find_segment(
+						index, enum_index_encode_value(
+							enum_fc, range->lower.u));
+						seg_i < index->segments->len;
+						seg_i++) {
+					struct bt_field_class_enumeration_index_segment *seg =
+						&bt_g_array_index(index->segments,
+							struct bt_field_class_enumeration_index_segment,
+							seg_i);
+
+					if (seg->lower > upper) {
+						break;
+					}
+
+					if (last_mapping_indexes[seg_i] == i) {
+						continue;
+					}
+
+					last_mapping_indexes[seg_i] = i;
+
+					if (pass == 0) {
+						seg->label_count++;
+					} else {
+						index->labels->pdata[
+							seg->label_offset +
+							seg->label_count] =
+							mapping->label->str;
+						seg->label_count++;
+					}
+				}
+			}
+		}
+
+		if (pass == 0) {
+			for (seg_i = 0; seg_i < index->segments->len; seg_i++) {
+				struct bt_field_class_enumeration_index_segment *seg =
+					&bt_g_array_index(index->segments,
+						struct bt_field_class_enumeration_index_segment,
+						seg_i);
+
+				seg->label_offset = label_offset;
+				label_offset += seg->label_count;
+				seg->label_count = 0;
+			}
+
+			g_ptr_array_set_size(index->labels, label_offset);
+		}
+	}
+
+	/*
+	 * Compact domain: use a dense table of segment indexes.
+	 *
+	 * The last segment is the label-less gap following the highest
+	 * range, unless the highest range reaches the maximum value: the
+	 * dense table needs to cover the values up to its lower bound
+	 * only in the former case.
+	 */
+	if (index->segments->len > 0) {
+		const struct bt_field_class_enumeration_index_segment *last_seg =
+			&bt_g_array_index(index->segments,
+				struct bt_field_class_enumeration_index_segment,
+				index->segments->len - 1);
+		uint64_t lower = bt_g_array_index(index->segments,
+			struct bt_field_class_enumeration_index_segment, 0).lower;
+
+		/*
+		 * Compare the span (not the length, which overflows when
+		 * the segments cover the whole domain) to the limit.
+		 */
+		if (last_seg->label_count == 0 &&
+				last_seg->lower - lower < ENUM_INDEX_DENSE_MAX_LEN) {
+			uint64_t len = last_seg->lower - lower + 1;
+			uint64_t offset;
+
+			index->dense = g_new(guint, len);
+			if (!index->dense) {
+				BT_LIB_LOGE("Failed to allocate an array.");
+				goto error;
+			}
+
+			seg_i = 0;
+
+			for (offset = 0; offset < len; offset++) {
+				while (seg_i + 1 < index->segments->len &&
+						bt_g_array_index(index->segments,
+							struct bt_field_class_enumeration_index_segment,
+							seg_i + 1).lower <= lower + offset) {
+					seg_i++;
+				}
+
+				index->dense[offset] = seg_i;
+			}
+
+			index->dense_lower = lower;
+			index->dense_len = len;
+		}
+	}
+
+	index->is_built = true;
+	BT_LIB_LOGD("Built enumeration field class lookup index: "
+		"%![fc-]+F, segment-count=%u, is-dense=%d",
+		enum_fc, index->segments->len, !!index->dense);
+	goto end;
+
+error:
+	enum_index_fini(index);
+	index->build_failed = true;
+	ret = -1;
+
+end:
+	if (bounds) {
+		g_array_free(bounds, TRUE);
+	}
+
+	g_free(last_mapping_indexes);
+	return ret;
+}
+
+/*
+ * Sets `*label_array` and `*count` to the labels of the encoded value
+ * `value` using the lookup index of `enum_fc`, building it if needed.
+ *
+ * Returns false if the index isn't available.
+ */
+static
+bool enum_index_get_labels(const struct bt_field_class_enumeration *c_enum_fc,
+		uint64_t value,
+		bt_field_class_enumeration_mapping_label_array *label_array,
+		uint64_t *count)
+{
+	struct bt_field_class_enumeration *enum_fc = (void *) c_enum_fc;
+	struct bt_field_class_enumeration_index *index = &enum_fc->index;
+	const struct bt_field_class_enumeration_index_segment *seg;
+	gint64 seg_i;
+
+	if (!index->is_built) {
+		/*
+		 * A field class which isn't part of a trace class yet
+		 * may still get new mappings.
+		 */
+		if (!enum_fc->common.common.part_of_trace_class ||
+				index->build_failed) {
+			return false;
+		}
+
+		if (enum_index_build(enum_fc)) {
+			/* Fall back to a linear scan */
+			return false;
+		}
+	}
+
+	seg_i = enum_index_find_segment(index,
+		enum_index_encode_value(enum_fc, value));
+	if (seg_i < 0) {
+		*label_array = (void *) index->labels->pdata;
+		*count = 0;
+		goto end;
+	}
+
+	seg = &bt_g_array_index(index->segments,
+		struct bt_field_class_enumeration_index_segment, seg_i);
+	*label_array = (void *) &index->labels->pdata[seg->label_offset];
+	*count = seg->label_count;
+
+end:
+	return true;
+}
+
 BT_EXPORT
 enum bt_field_class_enumeration_get_mapping_labels_for_value_status
 bt_field_class_enumeration_unsigned_get_mapping_labels_for_value(
@@ -832,6 +1182,12 @@ bt_field_class_enumeration_unsigned_get_mapping_labels_for_value(
 	BT_ASSERT_PRE_DEV_NON_NULL("count-output", count, "Count (output)");
 	BT_ASSERT_PRE_DEV_FC_HAS_TYPE("field-class", fc, "unsigned-enumeration",
 		BT_FIELD_CLASS_TYPE_UNSIGNED_ENUMERATION, "Field class");
+
+	if (enum_index_get_labels(enum_fc, (uint64_t) value, label_array,
+			count)) {
+		goto end;
+	}
+
 	g_ptr_array_set_size(enum_fc->label_buf, 0);
 
 	for (i = 0; i < enum_fc->mappings->len; i++) {
@@ -855,6 +1211,8 @@ bt_field_class_enumeration_unsigned_get_mapping_labels_for_value(
 
 	*label_array = (void *) enum_fc->label_buf->pdata;
 	*count = (uint64_t) enum_fc->label_buf->len;
+
+end:
 	return BT_FUNC_STATUS_OK;
 }
 
@@ -875,6 +1233,12 @@ bt_field_class_enumeration_signed_get_mapping_labels_for_value(
 	BT_ASSERT_PRE_DEV_NON_NULL("count-output", count, "Count (output)");
 	BT_ASSERT_PRE_DEV_FC_HAS_TYPE("field-class", fc, "signed-enumeration",
 		BT_FIELD_CLASS_TYPE_SIGNED_ENUMERATION, "Field class");
+
+	if (enum_index_get_labels(enum_fc, (uint64_t) value, label_array,
+			count)) {
+		goto end;
+	}
+
 	g_ptr_array_set_size(enum_fc->label_buf, 0);
 
 	for (i = 0; i < enum_fc->mappings->len; i++) {
@@ -898,6 +1262,8 @@ bt_field_class_enumeration_signed_get_mapping_labels_for_value(
 
 	*label_array = (void *) enum_fc->label_buf->pdata;
 	*count = (uint64_t) enum_fc->label_buf->len;
+
+end:
 	return BT_FUNC_STATUS_OK;
 }
 
@@ -957,6 +1323,9 @@ add_mapping_to_enumeration_field_class(struct bt_field_class *fc,
 	}
 
 	g_array_append_val(enum_fc->mappings, mapping);
+
+	/* The lookup index doesn't know this mapping */
+	enum_index_fini(&enum_fc->index);
 	BT_LIB_LOGD("Added mapping to enumeration field class: "
 		"%![fc-]+F, label=\"%s\"", fc, label);
 
@@ -116,12 +116,69 @@ struct bt_field_class_enumeration_mapping {
 struct bt_field_class_enumeration_unsigned_mapping;
 struct bt_field_class_enumeration_signed_mapping;
 
+/*
+ * Elementary interval of an enumeration field class lookup index:
+ * all the values from `lower` to the lower bound of the next segment
+ * (excluded) map to the same labels.
+ *
+ * Bounds are encoded so that unsigned comparisons order them (see
+ * enum_index_encode_value()).
+ */
+struct bt_field_class_enumeration_index_segment {
+	uint64_t lower;
+
+	/* Labels of this segment within the `labels` member of the index */
+	guint label_offset;
+	guint label_count;
+};
+
+/*
+ * Value-to-labels lookup index of an enumeration field class.
+ */
+struct bt_field_class_enumeration_index {
+	bool is_built;
+
+	/*
+	 * True if building the index failed: lookups use a linear scan
+	 * of the mappings instead of trying again.
+	 */
+	bool build_failed;
+
+	/*
+	 * Array of `struct bt_field_class_enumeration_index_segment`,
+	 * sorted by lower bound, covering everything from the lowest
+	 * mapping range lower bound.
+	 */
+	GArray *segments;
+
+	/*
+	 * Labels (`const char *`, owned by the mappings) of all the
+	 * segments, in mapping order within a segment.
+	 */
+	GPtrArray *labels;
+
+	/*
+	 * If not `NULL`: index of the segment (within `segments`) of each
+	 * value from `dense_lower` (encoded) to
+	 * `dense_lower + dense_len - 1`, for compact domains.
+	 */
+	guint *dense;
+	uint64_t dense_lower;
+	uint64_t dense_len;
+};
+
 struct bt_field_class_enumeration {
 	struct bt_field_class_integer common;
 
 	/* Array of `struct bt_field_class_enumeration_mapping *` */
 	GArray *mappings;
 
+	/*
+	 * Built on the first lookup once the field class is part of a
+	 * trace class, at which point it can't get new mappings.
+	 */
+	struct bt_field_class_enumeration_index index;
+
 	/*
 	 * This is an array of `const char *` which acts as a temporary
 	 * (potentially growing) buffer for
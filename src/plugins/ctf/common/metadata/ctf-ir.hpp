@@ -8,6 +8,7 @@
 #define BABELTRACE_PLUGINS_CTF_COMMON_METADATA_CTF_IR_HPP
 
 #include <algorithm>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -2945,6 +2946,175 @@ private:
     IntRangeSetT _mSelFieldRanges;
 };
 
+namespace internal {
+
+/*
+ * Selector value to option index lookup structure of a variant field
+ * class.
+ *
+ * `SelValT` is the selector value type.
+ */
+template <typename SelValT>
+class VariantFcOptLookup final
+{
+public:
+    /* Index of an option */
+    using OptIndex = unsigned int;
+
+    /* Maximum number of values which a dense table covers */
+    static constexpr unsigned long long maxDenseTableLen = 4096;
+
+    /* Value of a dense table entry which selects no option */
+    static constexpr OptIndex noOpt = static_cast<OptIndex>(-1);
+
+private:
+    /* Selector value interval which selects a single option */
+    struct _Interval final
+    {
+        SelValT lower;
+        SelValT upper;
+        OptIndex optIndex;
+    };
+
+public:
+    /*
+     * Builds an empty lookup structure (isBuilt() returns false).
+     */
+    explicit VariantFcOptLookup() noexcept = default;
+
+    /*
+     * Builds a lookup structure for the options `opts`, of which each
+     * element offers a selFieldRanges() method.
+     *
+     * isBuilt() returns false if the selector ranges of two options
+     * intersect (the first option wins, which only a linear search
+     * handles).
+     */
+    template <typename OptsT>
+    explicit VariantFcOptLookup(const OptsT& opts)
+    {
+        for (OptIndex optIndex = 0; optIndex < opts.size(); ++optIndex) {
+            for (auto& range : opts[optIndex].selFieldRanges()) {
+                _mIntervals.push_back(_Interval {range.lower(), range.upper(), optIndex});
+            }
+        }
+
+        std::sort(_mIntervals.begin(), _mIntervals.end(),
+                  [](const _Interval& a, const _Interval& b) {
+                      return a.lower < b.lower;
+                  });
+
+        for (std::size_t i = 1; i < _mIntervals.size(); ++i) {
+            if (_mIntervals[i].lower <= _mIntervals[i - 1].upper) {
+                /* Overlapping selector ranges */
+                _mIntervals.clear();
+                return;
+            }
+        }
+
+        _mIsBuilt = true;
+
+        if (_mIntervals.empty()) {
+            return;
+        }
+
+        /* Compact selector ranges: use a dense table */
+        const auto lower = _mIntervals.front().lower;
+        const auto span = Self::_offset(_mIntervals.back().upper, lower);
+
+        if (span < maxDenseTableLen) {
+            _mDenseTable.assign(span + 1, noOpt);
+
+            for (auto& interval : _mIntervals) {
+                const auto first = Self::_offset(interval.lower, lower);
+                const auto last = Self::_offset(interval.upper, lower);
+
+                std::fill(_mDenseTable.begin() + first, _mDenseTable.begin() + last + 1,
+                          interval.optIndex);
+            }
+
+            _mDenseTableLower = lower;
+            _mIntervals.clear();
+        }
+    }
+
+    /*
+     * Whether or not this lookup structure is usable.
+     */
+    bool isBuilt() const noexcept
+    {
+        return _mIsBuilt;
+    }
+
+    /*
+     * Returns the index of the option which the selector value `selVal`
+     * selects, or `noOpt` if none.
+     */
+    OptIndex find(const SelValT selVal) const noexcept
+    {
+        BT_ASSERT_DBG(_mIsBuilt);
+
+        if (!_mDenseTable.empty()) {
+            const auto offset = Self::_offset(selVal, _mDenseTableLower);
+
+            /* Also covers `selVal` less than `_mDenseTableLower` */
+            if (offset >= _mDenseTable.size()) {
+                return noOpt;
+            }
+
+            return _mDenseTable[offset];
+        }
+
+        /* Find the last interval of which the lower value is <= `selVal` */
+        const auto it = std::upper_bound(_mIntervals.begin(), _mIntervals.end(), selVal,
+                                         [](const SelValT val, const _Interval& interval) {
+                                             return val < interval.lower;
+                                         });
+
+        if (it == _mIntervals.begin() || selVal > std::prev(it)->upper) {
+            return noOpt;
+        }
+
+        return std::prev(it)->optIndex;
+    }
+
+private:
+    using Self = VariantFcOptLookup<SelValT>;
+
+    /*
+     * Returns `val - lower` (`val` greater than or equal to `lower`) as
+     * an unsigned value, without overflowing for signed values.
+     */
+    static unsigned long long _offset(const SelValT val, const SelValT lower) noexcept
+    {
+        return static_cast<unsigned long long>(val) - static_cast<unsigned long long>(lower);
+    }
+
+    /* Whether or not this lookup structure is usable */
+    bool _mIsBuilt = false;
+
+    /*
+     * Sorted, disjoint selector value intervals (empty when using
+     * `_mDenseTable`).
+     */
+    std::vector<_Interval> _mIntervals;
+
+    /*
+     * Option index for each selector value from `_mDenseTableLower`,
+     * if not empty.
+     */
+    std::vector<OptIndex> _mDenseTable;
+    SelValT _mDenseTableLower = 0;
+};
+
+template <typename SelValT>
+constexpr unsigned long long VariantFcOptLookup<SelValT>::maxDenseTableLen;
+
+template <typename SelValT>
+constexpr typename VariantFcOptLookup<SelValT>::OptIndex VariantFcOptLookup<SelValT>::noOpt;
+
+} /* namespace internal */
+
 /*
  * Variant field class base.
  *
@@ -3071,16 +3241,46 @@ public:
 
     /*
      * Returns the option of this field class which the selector value
-     * `selVal` selects, or `nullptr` if none.
+     * `selVal` selects, or end() if none.
+     *
+     * This is a constant-time or logarithmic lookup once you called
+     * buildOptLookup(), and a linear search otherwise.
      */
     typename Opts::const_iterator findOptBySelVal(const SelVal selVal) const noexcept
     {
+        if (_mOptLookup.isBuilt()) {
+            const auto optIndex = _mOptLookup.find(selVal);
+
+            if (optIndex == _OptLookup::noOpt) {
+                return _mOpts.end();
+            }
+
+            return _mOpts.begin() + optIndex;
+        }
+
         return std::find_if(_mOpts.begin(), _mOpts.end(), [selVal](const Opt& opt) {
             return opt.selFieldRanges().contains(selVal);
         });
     }
 
+    /*
+     * Precomputes the selector value lookup structure which
+     * findOptBySelVal() uses.
+     *
+     * ┌──────────────────────────────────────────────────────────────┐
+     * │ IMPORTANT: Only call this method once you won't modify the   │
+     * │ options anymore (for example, when the trace class is        │
+     * │ complete).                                                   │
+     * └──────────────────────────────────────────────────────────────┘
+     */
+    void buildOptLookup()
+    {
+        _mOptLookup = _OptLookup {_mOpts};
+    }
+
 private:
+    using _OptLookup = internal::VariantFcOptLookup<SelVal>;
+
     template <typename ValT, typename VarFcT>
     static ValT *_optByName(VarFcT& varFc, const std::string& name) noexcept
     {
@@ -3098,6 +3298,9 @@ private:
 
     /* Selector field location of instances of this field class */
     FieldLoc<UserMixinsT> _mSelFieldLoc;
+
+    /* Lookup structure of findOptBySelVal(), if built */
+    _OptLookup _mOptLookup;
 };
 
 /*
@@ -3971,6 +4174,111 @@ struct ObjUpIdLt final
     }
 };
 
+/*
+ * Map of numeric ID to object (weak).
+ *
+ * Data stream class and event record class IDs are nearly always
+ * small and dense: this map keeps the objects having such IDs in a
+ * vector indexed by ID, falling back to a hash table for the others.
+ *
+ * The length of the vector is at most the greater of
+ * `minDenseLen` and `maxDenseLenPerObj` times the number of objects.
+ * All the IDs less than this length are in the vector.
+ */
+template <typename ObjT>
+class ObjByIdMap final
+{
+public:
+    /* Minimum maximum length of the vector */
+    static constexpr std::size_t minDenseLen = 1024;
+
+    /* Maximum length of the vector per object */
+    static constexpr std::size_t maxDenseLenPerObj = 4;
+
+    /*
+     * Maps the ID `id` to `obj`.
+     */
+    void insert(const unsigned long long id, ObjT& obj)
+    {
+        ++_mCount;
+
+        if (id >= _mDense.size()) {
+            const auto maxDenseLen = this->_maxDenseLen();
+
+            if (id >= maxDenseLen) {
+                /* Sparse ID */
+                _mSparse[id] = &obj;
+                return;
+            }
+
+            /* Double the length of the vector, at least */
+            auto newDenseLen = std::max(_mDense.size() * 2, static_cast<std::size_t>(id) + 1);
+
+            if (newDenseLen > maxDenseLen) {
+                newDenseLen = maxDenseLen;
+            }
+
+            this->_growDense(newDenseLen);
+        }
+
+        _mDense[id] = &obj;
+    }
+
+    /*
+     * Returns the object having the ID `id`, or `nullptr` if none.
+     */
+    ObjT *find(const unsigned long long id) const noexcept
+    {
+        if (id < _mDense.size()) {
+            return _mDense[id];
+        }
+
+        if (_mSparse.empty()) {
+            return nullptr;
+        }
+
+        const auto it = _mSparse.find(id);
+
+        return it == _mSparse.end() ? nullptr : it->second;
+    }
+
+private:
+    std::size_t _maxDenseLen() const noexcept
+    {
+        const std::size_t perObjLen = maxDenseLenPerObj * _mCount;
+
+        return perObjLen > minDenseLen ? perObjLen : minDenseLen;
+    }
+
+    /*
+     * Grows the vector to `len` elements, moving the objects of the
+     * hash table of which the IDs become less than `len` to it.
+     */
+    void _growDense(const std::size_t len)
+    {
+        BT_ASSERT_DBG(len > _mDense.size());
+        _mDense.resize(len, nullptr);
+
+        for (auto it = _mSparse.begin(); it != _mSparse.end();) {
+            if (it->first < len) {
+                _mDense[it->first] = it->second;
+                it = _mSparse.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /* Objects having an ID less than `_mDense.size()`, indexed by ID */
+    std::vector<ObjT *> _mDense;
+
+    /* Other objects */
+    std::unordered_map<unsigned long long, ObjT *> _mSparse;
+
+    /* Number of inserted objects */
+    std::size_t _mCount = 0;
+};
+
 } /* namespace internal */
 
 /*
@@ -4127,18 +4435,18 @@ public:
     void addEventRecordCls(typename EventRecordCls<UserMixinsT>::UP eventRecordCls)
     {
         BT_ASSERT_DBG(eventRecordCls);
-        _mEventRecordClsIdMap[eventRecordCls->id()] = eventRecordCls.get();
+        _mEventRecordClsIdMap.insert(eventRecordCls->id(), *eventRecordCls);
         _mEventRecordClasses.emplace(std::move(eventRecordCls));
     }
 
     const EventRecordCls<UserMixinsT> *operator[](const unsigned long long id) const noexcept
     {
-        return this->_eventRecordClsById<const EventRecordCls<UserMixinsT>>(*this, id);
+        return _mEventRecordClsIdMap.find(id);
     }
 
     EventRecordCls<UserMixinsT> *operator[](const unsigned long long id) noexcept
     {
-        return this->_eventRecordClsById<EventRecordCls<UserMixinsT>>(*this, id);
+        return _mEventRecordClsIdMap.find(id);
     }
 
     typename EventRecordClsSet::size_type size() const noexcept
@@ -4167,21 +4475,7 @@ public:
     }
 
 private:
-    using _EventRecordClsByIdMap =
-        std::unordered_map<unsigned long long, EventRecordCls<UserMixinsT> *>;
-
-    template <typename ValT, typename DataStreamClsT>
-    static ValT *_eventRecordClsById(DataStreamClsT& dataStreamCls,
-                                     const unsigned long long id) noexcept
-    {
-        const auto it = dataStreamCls._mEventRecordClsIdMap.find(id);
-
-        if (it == dataStreamCls._mEventRecordClsIdMap.end()) {
-            return nullptr;
-        }
-
-        return it->second;
-    }
+    using _EventRecordClsByIdMap = internal::ObjByIdMap<EventRecordCls<UserMixinsT>>;
 
     /* ID of this data stream class */
     unsigned long long _mId;
@@ -4319,18 +4613,18 @@ public:
     void addDataStreamCls(typename DataStreamCls<UserMixinsT>::UP dataStreamCls)
     {
         BT_ASSERT_DBG(dataStreamCls);
-        _mDataStreamClsIdMap[dataStreamCls->id()] = dataStreamCls.get();
+        _mDataStreamClsIdMap.insert(dataStreamCls->id(), *dataStreamCls);
         _mDataStreamClasses.emplace(std::move(dataStreamCls));
     }
 
     const DataStreamCls<UserMixinsT> *operator[](const unsigned long long id) const noexcept
     {
-        return this->_dataStreamClsById<const DataStreamCls<UserMixinsT>>(*this, id);
+        return _mDataStreamClsIdMap.find(id);
     }
 
     DataStreamCls<UserMixinsT> *operator[](const unsigned long long id) noexcept
     {
-        return this->_dataStreamClsById<DataStreamCls<UserMixinsT>>(*this, id);
+        return _mDataStreamClsIdMap.find(id);
     }
 
     typename DataStreamClsSet::size_type size() const noexcept
@@ -4359,20 +4653,7 @@ public:
     }
 
 private:
-    using _DataStreamClsByIdMap =
-        std::unordered_map<unsigned long long, DataStreamCls<UserMixinsT> *>;
-
-    template <typename ValT, typename TraceClsT>
-    static ValT *_dataStreamClsById(TraceClsT& traceCls, const unsigned long long id) noexcept
-    {
-        const auto it = traceCls._mDataStreamClsIdMap.find(id);
-
-        if (it == traceCls._mDataStreamClsIdMap.end()) {
-            return nullptr;
-        }
-
-        return it->second;
-    }
+    using _DataStreamClsByIdMap = internal::ObjByIdMap<DataStreamCls<UserMixinsT>>;
 
     /* Data stream classes of this trace class */
     DataStreamClsSet _mDataStreamClasses;
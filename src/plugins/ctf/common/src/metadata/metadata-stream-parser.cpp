@@ -358,6 +358,13 @@ private:
     {
         this->_setSavedKeyValIndex(variantFc, variantFc.selFieldLoc());
 
+        /*
+         * The options of `variantFc` are final: precompute the lookup
+         * structure which the item sequence iterator uses to find the
+         * option of each variant field.
+         */
+        variantFc.buildOptLookup();
+
         for (std::size_t i = 0; i < variantFc.size(); ++i) {
             /*
              * Mark this option as being visited for this variant field
@@ -238,6 +238,59 @@ fs_sink_ctf_field_class_as_variant(fs_sink_ctf_field_class *fc)
     return (fs_sink_ctf_field_class_variant *) fc;
 }
 
+enum fs_sink_ctf_ser_instr_type
+{
+    /*
+     * Beginning of a run of `run_len` consecutive byte-aligned
+     * integer instructions (the instructions which follow this one).
+     */
+    FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_INT_RUN,
+
+    /* Byte-aligned integer instructions (part of a run) */
+    FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_UINT,
+    FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_SINT,
+    FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_BOOL,
+    FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_BIT_ARRAY,
+
+    /* Any other member: write it with its field class */
+    FS_SINK_CTF_SER_INSTR_TYPE_FIELD,
+};
+
+/*
+ * Serialization instruction.
+ *
+ * A serialization program is an array of instructions, compiled once
+ * from a scope structure field class, which writes the members of a
+ * corresponding structure field in order.
+ */
+struct fs_sink_ctf_ser_instr
+{
+    enum fs_sink_ctf_ser_instr_type type;
+
+    /* Index of the structure member field to write */
+    uint64_t member_index;
+
+    /* Weak; member field class */
+    struct fs_sink_ctf_field_class *fc;
+
+    /* Alignment and size (bits) of a byte-aligned integer */
+    unsigned int alignment;
+    unsigned int size;
+
+    /*
+     * `FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_INT_RUN` only:
+     *
+     * `run_len`:
+     *     Number of integer instructions of the run.
+     *
+     * `run_max_size_bits`:
+     *     Maximum size (bits) of the whole run, including alignment
+     *     padding, once the offset is aligned for its first integer.
+     */
+    uint64_t run_len;
+    uint64_t run_max_size_bits;
+};
+
 struct fs_sink_ctf_stream_class;
 
 struct fs_sink_ctf_event_class
@@ -253,6 +306,14 @@ struct fs_sink_ctf_event_class
 
     /* Owned by this */
     struct fs_sink_ctf_field_class *payload_fc;
+
+    /*
+     * Serialization programs of `spec_context_fc` and `payload_fc`
+     * (arrays of `struct fs_sink_ctf_ser_instr`, `NULL` if the
+     * corresponding field class is `NULL`).
+     */
+    GArray *spec_context_ser_prog;
+    GArray *payload_ser_prog;
 };
 
 struct fs_sink_ctf_trace;
@@ -282,6 +343,13 @@ struct fs_sink_ctf_stream_class
     /* Owned by this */
     struct fs_sink_ctf_field_class *event_common_context_fc;
 
+    /*
+     * Serialization program of `event_common_context_fc` (array of
+     * `struct fs_sink_ctf_ser_instr`, `NULL` if
+     * `event_common_context_fc` is `NULL`).
+     */
+    GArray *event_common_context_ser_prog;
+
     /* Array of `struct fs_sink_ctf_event_class *` (owned by this) */
     GPtrArray *event_classes;
 
@@ -853,6 +921,115 @@ fs_sink_ctf_field_class_variant_append_option(struct fs_sink_ctf_field_class_var
     named_fc->fc = option_fc;
 }
 
+static inline bool _fs_sink_ctf_field_class_is_byte_aligned_int(struct fs_sink_ctf_field_class *fc)
+{
+    switch (fc->type) {
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_BOOL:
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_BIT_ARRAY:
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_INT:
+    {
+        struct fs_sink_ctf_field_class_bit_array *bit_array_fc =
+            fs_sink_ctf_field_class_as_bit_array(fc);
+
+        return fc->alignment % 8 == 0 && bit_array_fc->size % 8 == 0 &&
+               bit_array_fc->size <= 64;
+    }
+    default:
+        return false;
+    }
+}
+
+/*
+ * Compiles the serialization program of the scope structure field
+ * class `fc`, returning `NULL` if `fc` is `NULL`.
+ *
+ * Consecutive byte-aligned integer members are grouped into runs so
+ * that the writer performs a single bounds check per run.
+ */
+static inline GArray *fs_sink_ctf_ser_prog_create(struct fs_sink_ctf_field_class *fc)
+{
+    struct fs_sink_ctf_field_class_struct *struct_fc;
+    GArray *prog;
+    uint64_t run_instr_index = UINT64_C(-1);
+    uint64_t i;
+
+    if (!fc) {
+        return NULL;
+    }
+
+    struct_fc = fs_sink_ctf_field_class_as_struct(fc);
+    prog = g_array_new(FALSE, TRUE, sizeof(struct fs_sink_ctf_ser_instr));
+    BT_ASSERT(prog);
+
+    for (i = 0; i < struct_fc->members->len; i++) {
+        struct fs_sink_ctf_field_class *member_fc =
+            fs_sink_ctf_field_class_struct_borrow_member_by_index(struct_fc, i)->fc;
+        struct fs_sink_ctf_ser_instr instr = {};
+
+        instr.member_index = i;
+        instr.fc = member_fc;
+
+        if (!_fs_sink_ctf_field_class_is_byte_aligned_int(member_fc)) {
+            instr.type = FS_SINK_CTF_SER_INSTR_TYPE_FIELD;
+            g_array_append_val(prog, instr);
+            run_instr_index = UINT64_C(-1);
+            continue;
+        }
+
+        instr.alignment = member_fc->alignment;
+        instr.size = fs_sink_ctf_field_class_as_bit_array(member_fc)->size;
+
+        switch (member_fc->type) {
+        case FS_SINK_CTF_FIELD_CLASS_TYPE_BOOL:
+            instr.type = FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_BOOL;
+            break;
+        case FS_SINK_CTF_FIELD_CLASS_TYPE_BIT_ARRAY:
+            instr.type = FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_BIT_ARRAY;
+            break;
+        case FS_SINK_CTF_FIELD_CLASS_TYPE_INT:
+            instr.type = fs_sink_ctf_field_class_as_int(member_fc)->is_signed ?
+                             FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_SINT :
+                             FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_UINT;
+            break;
+        default:
+            bt_common_abort();
+        }
+
+        if (run_instr_index == UINT64_C(-1)) {
+            /* Start a new run */
+            struct fs_sink_ctf_ser_instr run_instr = {};
+
+            run_instr.type = FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_INT_RUN;
+            run_instr.alignment = instr.alignment;
+            run_instr_index = prog->len;
+            g_array_append_val(prog, run_instr);
+
+            /* First integer: offset is already aligned */
+            bt_g_array_index(prog, struct fs_sink_ctf_ser_instr, run_instr_index)
+                .run_max_size_bits = instr.size;
+        } else {
+            /*
+             * Subsequent integer: the offset is byte-aligned, so
+             * there's at most `instr.alignment - 8` bits of padding.
+             */
+            bt_g_array_index(prog, struct fs_sink_ctf_ser_instr, run_instr_index)
+                .run_max_size_bits += instr.alignment - 8 + instr.size;
+        }
+
+        bt_g_array_index(prog, struct fs_sink_ctf_ser_instr, run_instr_index).run_len++;
+        g_array_append_val(prog, instr);
+    }
+
+    return prog;
+}
+
+static inline void fs_sink_ctf_ser_prog_destroy(GArray *prog)
+{
+    if (prog) {
+        g_array_free(prog, TRUE);
+    }
+}
+
 static inline struct fs_sink_ctf_event_class *
 fs_sink_ctf_event_class_create(struct fs_sink_ctf_stream_class *sc, const bt_event_class *ir_ec)
 {
@@ -874,6 +1051,10 @@ static inline void fs_sink_ctf_event_class_destroy(struct fs_sink_ctf_event_clas
         return;
     }
 
+    fs_sink_ctf_ser_prog_destroy(ec->spec_context_ser_prog);
+    ec->spec_context_ser_prog = NULL;
+    fs_sink_ctf_ser_prog_destroy(ec->payload_ser_prog);
+    ec->payload_ser_prog = NULL;
     fs_sink_ctf_field_class_destroy(ec->spec_context_fc);
     ec->spec_context_fc = NULL;
     fs_sink_ctf_field_class_destroy(ec->payload_fc);
@@ -942,6 +1123,8 @@ static inline void fs_sink_ctf_stream_class_destroy(struct fs_sink_ctf_stream_cl
 
     fs_sink_ctf_field_class_destroy(sc->packet_context_fc);
     sc->packet_context_fc = NULL;
+    fs_sink_ctf_ser_prog_destroy(sc->event_common_context_ser_prog);
+    sc->event_common_context_ser_prog = NULL;
     fs_sink_ctf_field_class_destroy(sc->event_common_context_fc);
     sc->event_common_context_fc = NULL;
     g_free(sc);
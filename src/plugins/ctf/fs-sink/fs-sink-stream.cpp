@@ -5,12 +5,14 @@
  */
 
 #include <cstdint>
+#include <cstring>
 
 #include <glib.h>
 #include <stdio.h>
 
 #include <babeltrace2/babeltrace.h>
 
+#include "common/align.h"
 #include "common/assert.h"
 #include "compat/endian.h" /* IWYU pragma: keep  */
 #include "ctfser/ctfser.h"
@@ -18,6 +20,8 @@
 #include "fs-sink-ctf-meta.hpp"
 #include "fs-sink-stream.hpp"
 #include "fs-sink-trace.hpp"
+#include "fs-sink-writer.hpp"
+#include "fs-sink.hpp"
 #include "translate-trace-ir-to-ctf-ir.hpp"
 
 void fs_sink_stream_destroy(struct fs_sink_stream *stream)
@@ -26,8 +30,19 @@ void fs_sink_stream_destroy(struct fs_sink_stream *stream)
         goto end;
     }
 
+    /* Wait for the writer thread, if any, to finalize the file */
+    (void) fs_sink_stream_flush(stream);
     bt_ctfser_fini(&stream->ctfser);
 
+    if (stream->chunk) {
+        if (fs_sink_trace_release_chunk(stream->trace, stream->chunk)) {
+            BT_CPPLOGE_SPEC(stream->logger, "Failed to release trace chunk: stream-file-name={}",
+                            stream->file_name->str);
+        }
+
+        stream->chunk = NULL;
+    }
+
     if (stream->file_name) {
         g_string_free(stream->file_name, TRUE);
         stream->file_name = NULL;
@@ -117,12 +132,64 @@ static void set_stream_file_name(struct fs_sink_stream *stream)
     stream->file_name = make_unique_stream_file_name(stream->trace, base_name);
 }
 
+/*
+ * Opens the file of `stream` within the directory of its current trace
+ * chunk, or within its trace directory if rotation is disabled.
+ */
+static int open_stream_file(struct fs_sink_stream *stream)
+{
+    GString *path = g_string_new(stream->chunk ? stream->chunk->path->str :
+                                                 stream->trace->path->str);
+    int ret;
+
+    BT_ASSERT(path);
+    g_string_append_printf(path, "/%s", stream->file_name->str);
+    ret = bt_ctfser_init(&stream->ctfser, path->str, static_cast<int>(stream->logger.level()));
+    g_string_free(path, TRUE);
+    return ret;
+}
+
+/*
+ * Makes `stream` write to the current chunk of its trace, closing its
+ * file within its previous chunk.
+ */
+static int switch_to_cur_chunk(struct fs_sink_stream *stream)
+{
+    struct fs_sink_trace_chunk *prev_chunk = stream->chunk;
+    int ret;
+
+    BT_ASSERT(!stream->packet_state.is_open);
+    ret = bt_ctfser_fini(&stream->ctfser);
+    if (ret) {
+        goto end;
+    }
+
+    stream->chunk = fs_sink_trace_acquire_cur_chunk(stream->trace);
+    if (!stream->chunk) {
+        ret = -1;
+        goto end;
+    }
+
+    ret = fs_sink_trace_release_chunk(stream->trace, prev_chunk);
+    if (ret) {
+        goto end;
+    }
+
+    BT_CPPLOGI_SPEC(stream->logger,
+                    "Switched stream to new trace chunk: "
+                    "stream-file-name={}, chunk-index={}",
+                    stream->file_name->str, stream->chunk->index);
+    ret = open_stream_file(stream);
+
+end:
+    return ret;
+}
+
 struct fs_sink_stream *fs_sink_stream_create(struct fs_sink_trace *trace,
                                              const bt_stream *ir_stream)
 {
     fs_sink_stream *stream = new fs_sink_stream {trace->logger};
     int ret;
-    GString *path = g_string_new(trace->path->str);
 
     stream->trace = trace;
     stream->ir_stream = ir_stream;
@@ -137,13 +204,30 @@ struct fs_sink_stream *fs_sink_stream_create(struct fs_sink_trace *trace,
         goto error;
     }
 
+    stream->ir_stream_class_id = bt_stream_class_get_id(stream->sc->ir_sc);
+    stream->ir_stream_id = bt_stream_get_id(ir_stream);
     set_stream_file_name(stream);
-    g_string_append_printf(path, "/%s", stream->file_name->str);
-    ret = bt_ctfser_init(&stream->ctfser, path->str, static_cast<int>(stream->logger.level()));
+
+    if (trace->cur_chunk) {
+        stream->chunk = fs_sink_trace_acquire_cur_chunk(trace);
+        if (!stream->chunk) {
+            goto error;
+        }
+    }
+
+    ret = open_stream_file(stream);
     if (ret) {
         goto error;
     }
 
+    if (trace->fs_sink->writer_pool) {
+        /*
+         * From now on, only this writer thread accesses the
+         * stream file.
+         */
+        stream->writer = fs_sink_writer_pool_assign_writer(trace->fs_sink->writer_pool);
+    }
+
     g_hash_table_insert(trace->streams, (gpointer) ir_stream, stream);
     goto end;
 
@@ -152,91 +236,277 @@ error:
     stream = NULL;
 
 end:
-    if (path) {
-        g_string_free(path, TRUE);
+    return stream;
+}
+
+/*
+ * Field record reader.
+ *
+ * A field record is a sequence of 64-bit words which contains the
+ * values of a field and of its descendants in pre-order (see
+ * append_field_rec()). The graph thread creates field records so that
+ * a writer thread can serialize fields without accessing trace IR
+ * objects.
+ */
+struct fs_sink_stream_rec_reader
+{
+    const uint64_t *cur;
+};
+
+/*
+ * Field value accessors.
+ *
+ * The write_*() functions below are templates which get the values to
+ * write through those overloads so that they can serialize either a
+ * trace IR field (`const bt_field *`) or a field record
+ * (`fs_sink_stream_rec_reader *`).
+ *
+ * The write_*() functions must get the values in pre-order and exactly
+ * once for a field record.
+ */
+static inline bool field_bool_value(const bt_field *field)
+{
+    return bt_field_bool_get_value(field);
+}
+
+static inline uint64_t field_bit_array_value(const bt_field *field)
+{
+    return bt_field_bit_array_get_value_as_integer(field);
+}
+
+static inline uint64_t field_uint_value(const bt_field *field)
+{
+    return bt_field_integer_unsigned_get_value(field);
+}
+
+static inline int64_t field_sint_value(const bt_field *field)
+{
+    return bt_field_integer_signed_get_value(field);
+}
+
+static inline double field_float_value(const bt_field *field, const unsigned int size)
+{
+    if (size == 32) {
+        return (double) bt_field_real_single_precision_get_value(field);
+    } else {
+        return bt_field_real_double_precision_get_value(field);
     }
+}
 
-    return stream;
+/*
+ * Sets `*size` to the size (bytes) of the string, including its null
+ * character.
+ */
+static inline const char *field_string_value(const bt_field *field, uint64_t *size)
+{
+    *size = bt_field_string_get_length(field) + 1;
+    return bt_field_string_get_value(field);
+}
+
+static inline const void *field_blob_data(const bt_field *field, uint64_t *len)
+{
+    *len = bt_field_blob_get_length(field);
+    return bt_field_blob_get_data_const(field);
+}
+
+static inline uint64_t field_array_length(const bt_field *field)
+{
+    return bt_field_array_get_length(field);
 }
 
+static inline const bt_field *field_array_elem(const bt_field *field, const uint64_t index)
+{
+    return bt_field_array_borrow_element_field_by_index_const(field, index);
+}
+
+static inline const bt_field *field_struct_member(const bt_field *field, const uint64_t index)
+{
+    return bt_field_structure_borrow_member_field_by_index_const(field, index);
+}
+
+static inline const bt_field *field_option_content(const bt_field *field)
+{
+    return bt_field_option_borrow_field_const(field);
+}
+
+static inline uint64_t field_variant_opt_index(const bt_field *field)
+{
+    return bt_field_variant_get_selected_option_index(field);
+}
+
+static inline const bt_field *field_variant_opt(const bt_field *field)
+{
+    return bt_field_variant_borrow_selected_option_field_const(field);
+}
+
+static inline uint64_t rec_read(fs_sink_stream_rec_reader *reader)
+{
+    return *reader->cur++;
+}
+
+static inline const void *rec_read_bytes(fs_sink_stream_rec_reader *reader, uint64_t *len)
+{
+    const void *data;
+
+    *len = rec_read(reader);
+    data = reader->cur;
+    reader->cur += (*len + 7) / 8;
+    return data;
+}
+
+static inline bool field_bool_value(fs_sink_stream_rec_reader *reader)
+{
+    return rec_read(reader) != 0;
+}
+
+static inline uint64_t field_bit_array_value(fs_sink_stream_rec_reader *reader)
+{
+    return rec_read(reader);
+}
+
+static inline uint64_t field_uint_value(fs_sink_stream_rec_reader *reader)
+{
+    return rec_read(reader);
+}
+
+static inline int64_t field_sint_value(fs_sink_stream_rec_reader *reader)
+{
+    return (int64_t) rec_read(reader);
+}
+
+static inline double field_float_value(fs_sink_stream_rec_reader *reader, unsigned int)
+{
+    const uint64_t bits = rec_read(reader);
+    double val;
+
+    memcpy(&val, &bits, sizeof(val));
+    return val;
+}
+
+static inline const char *field_string_value(fs_sink_stream_rec_reader *reader, uint64_t *size)
+{
+    return (const char *) rec_read_bytes(reader, size);
+}
+
+static inline const void *field_blob_data(fs_sink_stream_rec_reader *reader, uint64_t *len)
+{
+    return rec_read_bytes(reader, len);
+}
+
+static inline uint64_t field_array_length(fs_sink_stream_rec_reader *reader)
+{
+    return rec_read(reader);
+}
+
+static inline fs_sink_stream_rec_reader *field_array_elem(fs_sink_stream_rec_reader *reader,
+                                                          uint64_t)
+{
+    return reader;
+}
+
+static inline fs_sink_stream_rec_reader *field_struct_member(fs_sink_stream_rec_reader *reader,
+                                                             uint64_t)
+{
+    return reader;
+}
+
+static inline fs_sink_stream_rec_reader *field_option_content(fs_sink_stream_rec_reader *reader)
+{
+    return rec_read(reader) ? reader : nullptr;
+}
+
+static inline uint64_t field_variant_opt_index(fs_sink_stream_rec_reader *reader)
+{
+    return rec_read(reader);
+}
+
+static inline fs_sink_stream_rec_reader *field_variant_opt(fs_sink_stream_rec_reader *reader)
+{
+    return reader;
+}
+
+template <typename FieldT>
 static int write_field(struct fs_sink_stream *stream, struct fs_sink_ctf_field_class *fc,
-                       const bt_field *field);
+                       FieldT field);
 
+template <typename FieldT>
 static inline int write_bool_field(struct fs_sink_stream *stream,
-                                   struct fs_sink_ctf_field_class_bool *fc, const bt_field *field)
+                                   struct fs_sink_ctf_field_class_bool *fc, FieldT field)
 {
     /*
      * CTF 1.8 has no boolean field class type, so this component
      * translates this boolean field to an 8-bit unsigned integer
      * field which has the value 0 (false) or 1 (true).
      */
-    return bt_ctfser_write_unsigned_int(&stream->ctfser, bt_field_bool_get_value(field) ? 1 : 0,
+    return bt_ctfser_write_unsigned_int(&stream->ctfser, field_bool_value(field) ? 1 : 0,
                                         fc->base.base.alignment, fc->base.size, BYTE_ORDER);
 }
 
+template <typename FieldT>
 static inline int write_bit_array_field(struct fs_sink_stream *stream,
                                         struct fs_sink_ctf_field_class_bit_array *fc,
-                                        const bt_field *field)
+                                        FieldT field)
 {
     /*
      * CTF 1.8 has no bit array field class type, so this component
      * translates this bit array field to an unsigned integer field.
      */
-    return bt_ctfser_write_unsigned_int(&stream->ctfser,
-                                        bt_field_bit_array_get_value_as_integer(field),
+    return bt_ctfser_write_unsigned_int(&stream->ctfser, field_bit_array_value(field),
                                         fc->base.alignment, fc->size, BYTE_ORDER);
 }
 
+template <typename FieldT>
 static inline int write_int_field(struct fs_sink_stream *stream,
-                                  struct fs_sink_ctf_field_class_int *fc, const bt_field *field)
+                                  struct fs_sink_ctf_field_class_int *fc, FieldT field)
 {
     int ret;
 
     if (fc->is_signed) {
-        ret = bt_ctfser_write_signed_int(&stream->ctfser, bt_field_integer_signed_get_value(field),
+        ret = bt_ctfser_write_signed_int(&stream->ctfser, field_sint_value(field),
                                          fc->base.base.alignment, fc->base.size, BYTE_ORDER);
     } else {
-        ret = bt_ctfser_write_unsigned_int(&stream->ctfser,
-                                           bt_field_integer_unsigned_get_value(field),
+        ret = bt_ctfser_write_unsigned_int(&stream->ctfser, field_uint_value(field),
                                            fc->base.base.alignment, fc->base.size, BYTE_ORDER);
     }
 
     return ret;
 }
 
+template <typename FieldT>
 static inline int write_float_field(struct fs_sink_stream *stream,
-                                    struct fs_sink_ctf_field_class_float *fc, const bt_field *field)
+                                    struct fs_sink_ctf_field_class_float *fc, FieldT field)
 {
     int ret;
-    double val;
+    double val = field_float_value(field, fc->base.size);
 
     if (fc->base.size == 32) {
-        val = (double) bt_field_real_single_precision_get_value(field);
         ret = bt_ctfser_write_float32(&stream->ctfser, val, fc->base.base.alignment, BYTE_ORDER);
     } else {
-        val = bt_field_real_double_precision_get_value(field);
         ret = bt_ctfser_write_float64(&stream->ctfser, val, fc->base.base.alignment, BYTE_ORDER);
     }
 
     return ret;
 }
 
-static inline int write_string_field(struct fs_sink_stream *stream, const bt_field *field)
+template <typename FieldT>
+static inline int write_string_field(struct fs_sink_stream *stream, FieldT field)
 {
-    return bt_ctfser_write_string(&stream->ctfser, bt_field_string_get_value(field));
+    uint64_t size;
+    const char *str = field_string_value(field, &size);
+
+    return bt_ctfser_write_data(&stream->ctfser, (const uint8_t *) str, size);
 }
 
+template <typename FieldT>
 static inline int write_array_base_field_elements(struct fs_sink_stream *stream,
                                                   struct fs_sink_ctf_field_class_array_base *fc,
-                                                  const bt_field *field)
+                                                  FieldT field, uint64_t len)
 {
     uint64_t i;
-    uint64_t len = bt_field_array_get_length(field);
     int ret = 0;
 
     for (i = 0; i < len; i++) {
-        const bt_field *elem_field = bt_field_array_borrow_element_field_by_index_const(field, i);
-        ret = write_field(stream, fc->elem_fc, elem_field);
+        ret = write_field(stream, fc->elem_fc, field_array_elem(field, i));
         if (G_UNLIKELY(ret)) {
             goto end;
         }
@@ -246,55 +516,60 @@ end:
     return ret;
 }
 
-static inline int write_blob_data(struct fs_sink_stream *stream, const bt_field *field)
+template <typename FieldT>
+static inline int write_blob_data(struct fs_sink_stream *stream, FieldT field)
 {
-    return bt_ctfser_write_data(&stream->ctfser, bt_field_blob_get_data_const(field),
-                                bt_field_blob_get_length(field));
+    uint64_t len;
+    const void *data = field_blob_data(field, &len);
+
+    return bt_ctfser_write_data(&stream->ctfser, (const uint8_t *) data, len);
 }
 
+template <typename FieldT>
 static inline int write_sequence_field(struct fs_sink_stream *stream,
-                                       struct fs_sink_ctf_field_class_sequence *fc,
-                                       const bt_field *field)
+                                       struct fs_sink_ctf_field_class_sequence *fc, FieldT field)
 {
+    uint64_t len = field_array_length(field);
     int ret;
 
     if (fc->length_is_before) {
-        ret = bt_ctfser_write_unsigned_int(&stream->ctfser, bt_field_array_get_length(field), 8, 32,
-                                           BYTE_ORDER);
+        ret = bt_ctfser_write_unsigned_int(&stream->ctfser, len, 8, 32, BYTE_ORDER);
         if (G_UNLIKELY(ret)) {
             goto end;
         }
     }
 
-    ret = write_array_base_field_elements(stream, &fc->base, field);
+    ret = write_array_base_field_elements(stream, &fc->base, field, len);
 
 end:
     return ret;
 }
 
+template <typename FieldT>
 static inline int write_dyn_blob_field(struct fs_sink_stream *stream,
-                                       struct fs_sink_ctf_field_class_sequence *fc,
-                                       const bt_field *field)
+                                       struct fs_sink_ctf_field_class_sequence *fc, FieldT field)
 {
+    uint64_t len;
+    const void *data = field_blob_data(field, &len);
     int ret;
 
     if (fc->length_is_before) {
-        ret = bt_ctfser_write_unsigned_int(&stream->ctfser, bt_field_blob_get_length(field), 8, 32,
-                                           BYTE_ORDER);
+        ret = bt_ctfser_write_unsigned_int(&stream->ctfser, len, 8, 32, BYTE_ORDER);
         if (G_UNLIKELY(ret)) {
             goto end;
         }
     }
 
-    ret = write_blob_data(stream, field);
+    ret = bt_ctfser_write_data(&stream->ctfser, (const uint8_t *) data, len);
 
 end:
     return ret;
 }
 
+template <typename FieldT>
 static inline int write_struct_field(struct fs_sink_stream *stream,
-                                     struct fs_sink_ctf_field_class_struct *fc,
-                                     const bt_field *field, bool align_struct)
+                                     struct fs_sink_ctf_field_class_struct *fc, FieldT field,
+                                     bool align_struct)
 {
     int ret = 0;
     uint64_t i;
@@ -307,12 +582,10 @@ static inline int write_struct_field(struct fs_sink_stream *stream,
     }
 
     for (i = 0; i < fc->members->len; i++) {
-        const bt_field *memb_field =
-            bt_field_structure_borrow_member_field_by_index_const(field, i);
         struct fs_sink_ctf_field_class *member_fc =
             fs_sink_ctf_field_class_struct_borrow_member_by_index(fc, i)->fc;
 
-        ret = write_field(stream, member_fc, memb_field);
+        ret = write_field(stream, member_fc, field_struct_member(field, i));
         if (G_UNLIKELY(ret)) {
             goto end;
         }
@@ -322,12 +595,12 @@ end:
     return ret;
 }
 
+template <typename FieldT>
 static inline int write_option_field(struct fs_sink_stream *stream,
-                                     struct fs_sink_ctf_field_class_option *fc,
-                                     const bt_field *field)
+                                     struct fs_sink_ctf_field_class_option *fc, FieldT field)
 {
     int ret = 0;
-    const bt_field *content_field = bt_field_option_borrow_field_const(field);
+    FieldT content_field = field_option_content(field);
 
     if (fc->tag_is_before) {
         ret =
@@ -356,11 +629,11 @@ end:
     return ret;
 }
 
+template <typename FieldT>
 static inline int write_variant_field(struct fs_sink_stream *stream,
-                                      struct fs_sink_ctf_field_class_variant *fc,
-                                      const bt_field *field)
+                                      struct fs_sink_ctf_field_class_variant *fc, FieldT field)
 {
-    uint64_t opt_index = bt_field_variant_get_selected_option_index(field);
+    uint64_t opt_index = field_variant_opt_index(field);
     int ret;
 
     if (fc->tag_is_before) {
@@ -372,14 +645,15 @@ static inline int write_variant_field(struct fs_sink_stream *stream,
 
     ret = write_field(stream,
                       fs_sink_ctf_field_class_variant_borrow_option_by_index(fc, opt_index)->fc,
-                      bt_field_variant_borrow_selected_option_field_const(field));
+                      field_variant_opt(field));
 
 end:
     return ret;
 }
 
+template <typename FieldT>
 static int write_field(struct fs_sink_stream *stream, struct fs_sink_ctf_field_class *fc,
-                       const bt_field *field)
+                       FieldT field)
 {
     int ret;
 
@@ -404,7 +678,7 @@ static int write_field(struct fs_sink_stream *stream, struct fs_sink_ctf_field_c
         break;
     case FS_SINK_CTF_FIELD_CLASS_TYPE_ARRAY:
         ret = write_array_base_field_elements(stream, fs_sink_ctf_field_class_as_array_base(fc),
-                                              field);
+                                              field, field_array_length(field));
         break;
     case FS_SINK_CTF_FIELD_CLASS_TYPE_STATIC_BLOB:
         ret = write_blob_data(stream, field);
@@ -428,23 +702,107 @@ static int write_field(struct fs_sink_stream *stream, struct fs_sink_ctf_field_c
     return ret;
 }
 
-static inline int write_event_header(struct fs_sink_stream *stream, const bt_clock_snapshot *cs,
-                                     struct fs_sink_ctf_event_class *ec)
+template <typename FieldT>
+static inline void write_byte_aligned_int_no_check(struct fs_sink_stream *stream,
+                                                   const struct fs_sink_ctf_ser_instr *instr,
+                                                   FieldT field)
+{
+    _bt_ctfser_align_offset_in_current_packet_no_check(&stream->ctfser, instr->alignment);
+
+    switch (instr->type) {
+    case FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_UINT:
+        _bt_ctfser_write_byte_aligned_unsigned_int_no_align(
+            &stream->ctfser, field_uint_value(field), instr->size, BYTE_ORDER);
+        break;
+    case FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_SINT:
+        _bt_ctfser_write_byte_aligned_signed_int_no_align(
+            &stream->ctfser, field_sint_value(field), instr->size, BYTE_ORDER);
+        break;
+    case FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_BOOL:
+        _bt_ctfser_write_byte_aligned_unsigned_int_no_align(
+            &stream->ctfser, field_bool_value(field) ? 1 : 0, instr->size, BYTE_ORDER);
+        break;
+    case FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_BIT_ARRAY:
+        _bt_ctfser_write_byte_aligned_unsigned_int_no_align(
+            &stream->ctfser, field_bit_array_value(field), instr->size, BYTE_ORDER);
+        break;
+    default:
+        bt_common_abort();
+    }
+}
+
+/*
+ * Writes the structure field `field` following the serialization
+ * program `prog` (see fs_sink_ctf_ser_prog_create()).
+ *
+ * For a run of byte-aligned integers, this function reserves the
+ * maximum size of the whole run once and then writes each integer
+ * without any other bounds check.
+ */
+template <typename FieldT>
+static int write_struct_field_with_prog(struct fs_sink_stream *stream,
+                                        struct fs_sink_ctf_field_class_struct *fc,
+                                        const GArray *prog, FieldT field)
+{
+    int ret;
+    uint64_t i = 0;
+
+    ret = bt_ctfser_align_offset_in_current_packet(&stream->ctfser, fc->base.alignment);
+    if (G_UNLIKELY(ret)) {
+        goto end;
+    }
+
+    while (i < prog->len) {
+        const fs_sink_ctf_ser_instr *instr =
+            &bt_g_array_index(prog, struct fs_sink_ctf_ser_instr, i);
+
+        if (instr->type == FS_SINK_CTF_SER_INSTR_TYPE_FIELD) {
+            ret = write_field(stream, instr->fc, field_struct_member(field, instr->member_index));
+            if (G_UNLIKELY(ret)) {
+                goto end;
+            }
+
+            i++;
+            continue;
+        }
+
+        BT_ASSERT_DBG(instr->type == FS_SINK_CTF_SER_INSTR_TYPE_BYTE_ALIGNED_INT_RUN);
+        ret = bt_ctfser_align_offset_in_current_packet(&stream->ctfser, instr->alignment);
+        if (G_UNLIKELY(ret)) {
+            goto end;
+        }
+
+        ret = bt_ctfser_reserve_in_current_packet(&stream->ctfser, instr->run_max_size_bits);
+        if (G_UNLIKELY(ret)) {
+            goto end;
+        }
+
+        for (const fs_sink_ctf_ser_instr *int_instr = instr + 1;
+             int_instr <= instr + instr->run_len; int_instr++) {
+            write_byte_aligned_int_no_check(stream, int_instr,
+                                            field_struct_member(field, int_instr->member_index));
+        }
+
+        i += instr->run_len + 1;
+    }
+
+end:
+    return ret;
+}
+
+static inline int write_event_header(struct fs_sink_stream *stream, uint64_t ec_id, uint64_t cs)
 {
     int ret;
 
     /* Event class ID */
-    ret = bt_ctfser_write_byte_aligned_unsigned_int(
-        &stream->ctfser, bt_event_class_get_id(ec->ir_ec), 8, 64, BYTE_ORDER);
+    ret = bt_ctfser_write_byte_aligned_unsigned_int(&stream->ctfser, ec_id, 8, 64, BYTE_ORDER);
     if (G_UNLIKELY(ret)) {
         goto end;
     }
 
     /* Time */
     if (stream->sc->default_clock_class) {
-        BT_ASSERT_DBG(cs);
-        ret = bt_ctfser_write_byte_aligned_unsigned_int(
-            &stream->ctfser, bt_clock_snapshot_get_value(cs), 8, 64, BYTE_ORDER);
+        ret = bt_ctfser_write_byte_aligned_unsigned_int(&stream->ctfser, cs, 8, 64, BYTE_ORDER);
         if (G_UNLIKELY(ret)) {
             goto end;
         }
@@ -454,25 +812,32 @@ end:
     return ret;
 }
 
-int fs_sink_stream_write_event(struct fs_sink_stream *stream, const bt_clock_snapshot *cs,
-                               const bt_event *event, struct fs_sink_ctf_event_class *ec)
+/*
+ * Writes an event record having the event class ID `ec_id`, the
+ * default clock snapshot value `cs` (ignored if the stream class has
+ * no default clock class), and the event common context, specific
+ * context, and payload fields `common_ctx_field`, `spec_ctx_field`,
+ * and `payload_field`.
+ */
+template <typename FieldT>
+static int write_event(struct fs_sink_stream *stream, struct fs_sink_ctf_event_class *ec,
+                       uint64_t ec_id, uint64_t cs, FieldT common_ctx_field,
+                       FieldT spec_ctx_field, FieldT payload_field)
 {
     int ret;
-    const bt_field *field;
 
     /* Header */
-    ret = write_event_header(stream, cs, ec);
+    ret = write_event_header(stream, ec_id, cs);
     if (G_UNLIKELY(ret)) {
         goto end;
     }
 
     /* Common context */
     if (stream->sc->event_common_context_fc) {
-        field = bt_event_borrow_common_context_field_const(event);
-        BT_ASSERT_DBG(field);
-        ret = write_struct_field(
-            stream, fs_sink_ctf_field_class_as_struct(stream->sc->event_common_context_fc), field,
-            true);
+        BT_ASSERT_DBG(common_ctx_field);
+        ret = write_struct_field_with_prog(
+            stream, fs_sink_ctf_field_class_as_struct(stream->sc->event_common_context_fc),
+            stream->sc->event_common_context_ser_prog, common_ctx_field);
         if (G_UNLIKELY(ret)) {
             goto end;
         }
@@ -480,21 +845,21 @@ int fs_sink_stream_write_event(struct fs_sink_stream *stream, const bt_clock_sna
 
     /* Specific context */
     if (ec->spec_context_fc) {
-        field = bt_event_borrow_specific_context_field_const(event);
-        BT_ASSERT_DBG(field);
-        ret = write_struct_field(stream, fs_sink_ctf_field_class_as_struct(ec->spec_context_fc),
-                                 field, true);
+        BT_ASSERT_DBG(spec_ctx_field);
+        ret = write_struct_field_with_prog(stream,
+                                           fs_sink_ctf_field_class_as_struct(ec->spec_context_fc),
+                                           ec->spec_context_ser_prog, spec_ctx_field);
         if (G_UNLIKELY(ret)) {
             goto end;
         }
     }
 
-    /* Specific context */
+    /* Payload */
     if (ec->payload_fc) {
-        field = bt_event_borrow_payload_field_const(event);
-        BT_ASSERT_DBG(field);
-        ret = write_struct_field(stream, fs_sink_ctf_field_class_as_struct(ec->payload_fc), field,
-                                 true);
+        BT_ASSERT_DBG(payload_field);
+        ret = write_struct_field_with_prog(stream,
+                                           fs_sink_ctf_field_class_as_struct(ec->payload_fc),
+                                           ec->payload_ser_prog, payload_field);
         if (G_UNLIKELY(ret)) {
             goto end;
         }
@@ -504,20 +869,21 @@ end:
     return ret;
 }
 
-static int write_packet_context(struct fs_sink_stream *stream)
+template <typename FieldT>
+static int write_packet_context(struct fs_sink_stream *stream, FieldT packet_context_field)
 {
     int ret;
 
     /* Packet total size */
     ret = bt_ctfser_write_byte_aligned_unsigned_int(
-        &stream->ctfser, stream->packet_state.total_size, 8, 64, BYTE_ORDER);
+        &stream->ctfser, stream->ser_packet_state.total_size, 8, 64, BYTE_ORDER);
     if (ret) {
         goto end;
     }
 
     /* Packet content size */
     ret = bt_ctfser_write_byte_aligned_unsigned_int(
-        &stream->ctfser, stream->packet_state.content_size, 8, 64, BYTE_ORDER);
+        &stream->ctfser, stream->ser_packet_state.content_size, 8, 64, BYTE_ORDER);
     if (ret) {
         goto end;
     }
@@ -525,7 +891,7 @@ static int write_packet_context(struct fs_sink_stream *stream)
     if (stream->sc->packets_have_ts_begin) {
         /* Beginning time */
         ret = bt_ctfser_write_byte_aligned_unsigned_int(
-            &stream->ctfser, stream->packet_state.beginning_cs, 8, 64, BYTE_ORDER);
+            &stream->ctfser, stream->ser_packet_state.beginning_cs, 8, 64, BYTE_ORDER);
         if (ret) {
             goto end;
         }
@@ -534,7 +900,7 @@ static int write_packet_context(struct fs_sink_stream *stream)
     if (stream->sc->packets_have_ts_end) {
         /* End time */
         ret = bt_ctfser_write_byte_aligned_unsigned_int(
-            &stream->ctfser, stream->packet_state.end_cs, 8, 64, BYTE_ORDER);
+            &stream->ctfser, stream->ser_packet_state.end_cs, 8, 64, BYTE_ORDER);
         if (ret) {
             goto end;
         }
@@ -543,25 +909,22 @@ static int write_packet_context(struct fs_sink_stream *stream)
     if (stream->sc->has_discarded_events) {
         /* Discarded event counter */
         ret = bt_ctfser_write_byte_aligned_unsigned_int(
-            &stream->ctfser, stream->packet_state.discarded_events_counter, 8, 64, BYTE_ORDER);
+            &stream->ctfser, stream->ser_packet_state.discarded_events_counter, 8, 64,
+            BYTE_ORDER);
         if (ret) {
             goto end;
         }
     }
 
     /* Sequence number */
-    ret = bt_ctfser_write_byte_aligned_unsigned_int(&stream->ctfser, stream->packet_state.seq_num,
-                                                    8, 64, BYTE_ORDER);
+    ret = bt_ctfser_write_byte_aligned_unsigned_int(
+        &stream->ctfser, stream->ser_packet_state.seq_num, 8, 64, BYTE_ORDER);
     if (ret) {
         goto end;
     }
 
     /* Other members */
     if (stream->sc->packet_context_fc) {
-        const bt_field *packet_context_field;
-
-        BT_ASSERT(stream->packet_state.packet);
-        packet_context_field = bt_packet_borrow_context_field_const(stream->packet_state.packet);
         BT_ASSERT(packet_context_field);
         ret = write_struct_field(stream,
                                  fs_sink_ctf_field_class_as_struct(stream->sc->packet_context_fc),
@@ -575,20 +938,29 @@ end:
     return ret;
 }
 
-int fs_sink_stream_open_packet(struct fs_sink_stream *stream, const bt_clock_snapshot *cs,
-                               const bt_packet *packet)
+/*
+ * Returns the logger to use to log while serializing `stream`.
+ *
+ * The writer thread of `stream`, if any, serializes it: it must only
+ * log through its own logger, the graph thread using `stream->logger`
+ * concurrently.
+ */
+static inline const bt2c::Logger& ser_logger(const struct fs_sink_stream *stream)
+{
+    return stream->writer ? stream->writer->logger : stream->logger;
+}
+
+/*
+ * Opens a packet, writing its header and its context field
+ * `packet_context_field` (ignored if the stream class has no packet
+ * context field class).
+ */
+template <typename FieldT>
+static int write_packet_beginning(struct fs_sink_stream *stream, FieldT packet_context_field)
 {
     int ret;
     uint64_t i;
 
-    BT_ASSERT(!stream->packet_state.is_open);
-    bt_packet_put_ref(stream->packet_state.packet);
-    stream->packet_state.packet = packet;
-    bt_packet_get_ref(stream->packet_state.packet);
-    if (cs) {
-        stream->packet_state.beginning_cs = bt_clock_snapshot_get_value(cs);
-    }
-
     /* Open packet */
     ret = bt_ctfser_open_packet(&stream->ctfser);
     if (ret) {
@@ -600,7 +972,8 @@ int fs_sink_stream_open_packet(struct fs_sink_stream *stream, const bt_clock_sna
     ret = bt_ctfser_write_byte_aligned_unsigned_int(&stream->ctfser, UINT64_C(0xc1fc1fc1), 8, 32,
                                                     BYTE_ORDER);
     if (ret) {
-        BT_CPPLOGE_SPEC(stream->logger, "Error writing packet header magic: stream-file-name={}",
+        BT_CPPLOGE_SPEC(ser_logger(stream),
+                        "Error writing packet header magic: stream-file-name={}",
                         stream->file_name->str);
         goto end;
     }
@@ -610,40 +983,431 @@ int fs_sink_stream_open_packet(struct fs_sink_stream *stream, const bt_clock_sna
         ret = bt_ctfser_write_byte_aligned_unsigned_int(
             &stream->ctfser, (uint64_t) stream->sc->trace->uuid[i], 8, 8, BYTE_ORDER);
         if (ret) {
-            BT_CPPLOGE_SPEC(stream->logger, "Error writing packet header UUID: stream-file-name={}",
+            BT_CPPLOGE_SPEC(ser_logger(stream),
+                            "Error writing packet header UUID: stream-file-name={}",
                             stream->file_name->str);
             goto end;
         }
     }
 
     /* Packet header: stream class ID */
-    ret = bt_ctfser_write_byte_aligned_unsigned_int(
-        &stream->ctfser, bt_stream_class_get_id(stream->sc->ir_sc), 8, 64, BYTE_ORDER);
+    ret = bt_ctfser_write_byte_aligned_unsigned_int(&stream->ctfser, stream->ir_stream_class_id,
+                                                    8, 64, BYTE_ORDER);
     if (ret) {
-        BT_CPPLOGE_SPEC(stream->logger,
+        BT_CPPLOGE_SPEC(ser_logger(stream),
                         "Error writing packet header stream class id: "
                         "stream-file-name={}, stream-class-id={}",
-                        stream->file_name->str, bt_stream_class_get_id(stream->sc->ir_sc));
+                        stream->file_name->str, stream->ir_stream_class_id);
         goto end;
     }
 
     /* Packet header: stream ID */
-    ret = bt_ctfser_write_byte_aligned_unsigned_int(
-        &stream->ctfser, bt_stream_get_id(stream->ir_stream), 8, 64, BYTE_ORDER);
+    ret = bt_ctfser_write_byte_aligned_unsigned_int(&stream->ctfser, stream->ir_stream_id, 8, 64,
+                                                    BYTE_ORDER);
     if (ret) {
-        BT_CPPLOGE_SPEC(stream->logger,
+        BT_CPPLOGE_SPEC(ser_logger(stream),
                         "Error writing packet header stream id: "
                         "stream-file-name={}, stream-id={}",
-                        stream->file_name->str, bt_stream_get_id(stream->ir_stream));
+                        stream->file_name->str, stream->ir_stream_id);
         goto end;
     }
 
     /* Save packet context's offset to rewrite it later */
-    stream->packet_state.context_offset_bits =
+    stream->ser_packet_state.context_offset_bits =
         bt_ctfser_get_offset_in_current_packet_bits(&stream->ctfser);
 
     /* Write packet context just to advance to content (first event) */
-    ret = write_packet_context(stream);
+    ret = write_packet_context(stream, packet_context_field);
+
+end:
+    return ret;
+}
+
+/*
+ * Rewrites the context field `packet_context_field` of the current
+ * packet, now that its size is known, and closes it.
+ */
+template <typename FieldT>
+static int write_packet_end(struct fs_sink_stream *stream, FieldT packet_context_field)
+{
+    int ret;
+
+    stream->ser_packet_state.content_size =
+        bt_ctfser_get_offset_in_current_packet_bits(&stream->ctfser);
+    stream->ser_packet_state.total_size =
+        (stream->ser_packet_state.content_size + 7) & ~UINT64_C(7);
+
+    /* Rewrite packet context */
+    bt_ctfser_set_offset_in_current_packet_bits(&stream->ctfser,
+                                                stream->ser_packet_state.context_offset_bits);
+    ret = write_packet_context(stream, packet_context_field);
+    if (ret) {
+        goto end;
+    }
+
+    /* Close packet */
+    bt_ctfser_close_current_packet(&stream->ctfser, stream->ser_packet_state.total_size / 8);
+
+end:
+    return ret;
+}
+
+static inline void rec_append_bytes(std::vector<uint64_t>& rec, const void *data, uint64_t len)
+{
+    const std::size_t index = rec.size();
+
+    rec.push_back(len);
+    rec.resize(index + 1 + (len + 7) / 8);
+
+    if (len > 0) {
+        memcpy(&rec[index + 1], data, len);
+    }
+}
+
+/*
+ * Advances `offset_bits`, an offset within a packet, like writing a
+ * field of `size_bits` bits aligned on `alignment_bits` bits does.
+ */
+static inline void advance_offset(uint64_t& offset_bits, const unsigned int alignment_bits,
+                                  const uint64_t size_bits)
+{
+    offset_bits = BT_ALIGN(offset_bits, (uint64_t) alignment_bits) + size_bits;
+}
+
+static void append_field_rec(std::vector<uint64_t>& rec, uint64_t& offset_bits,
+                             struct fs_sink_ctf_field_class *fc, const bt_field *field);
+
+/*
+ * Appends the field records of the members of the structure field
+ * `field`, of which the class is `fc`, to `rec`.
+ */
+static void append_struct_field_members_rec(std::vector<uint64_t>& rec, uint64_t& offset_bits,
+                                            struct fs_sink_ctf_field_class_struct *fc,
+                                            const bt_field *field)
+{
+    for (uint64_t i = 0; i < fc->members->len; i++) {
+        append_field_rec(rec, offset_bits,
+                         fs_sink_ctf_field_class_struct_borrow_member_by_index(fc, i)->fc,
+                         field_struct_member(field, i));
+    }
+}
+
+/*
+ * Appends the field record of `field`, of which the class is `fc`, to
+ * `rec`.
+ *
+ * The layout of a field record follows the order in which the
+ * write_*() functions above get field values.
+ *
+ * This function also advances `offset_bits` like writing `field` at
+ * this offset within a packet does, so that the graph thread knows the
+ * exact size of the current packet which a writer thread serializes.
+ */
+static void append_field_rec(std::vector<uint64_t>& rec, uint64_t& offset_bits,
+                             struct fs_sink_ctf_field_class *fc, const bt_field *field)
+{
+    switch (fc->type) {
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_BOOL:
+        rec.push_back(field_bool_value(field) ? 1 : 0);
+        advance_offset(offset_bits, fc->alignment,
+                       fs_sink_ctf_field_class_as_bit_array(fc)->size);
+        break;
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_BIT_ARRAY:
+        rec.push_back(field_bit_array_value(field));
+        advance_offset(offset_bits, fc->alignment,
+                       fs_sink_ctf_field_class_as_bit_array(fc)->size);
+        break;
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_INT:
+        if (fs_sink_ctf_field_class_as_int(fc)->is_signed) {
+            rec.push_back((uint64_t) field_sint_value(field));
+        } else {
+            rec.push_back(field_uint_value(field));
+        }
+
+        advance_offset(offset_bits, fc->alignment,
+                       fs_sink_ctf_field_class_as_bit_array(fc)->size);
+        break;
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_FLOAT:
+    {
+        const unsigned int size = fs_sink_ctf_field_class_as_float(fc)->base.size;
+        const double val = field_float_value(field, size);
+        uint64_t bits;
+
+        memcpy(&bits, &val, sizeof(bits));
+        rec.push_back(bits);
+        advance_offset(offset_bits, fc->alignment, size);
+        break;
+    }
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_STRING:
+    {
+        uint64_t size;
+        const char *str = field_string_value(field, &size);
+
+        rec_append_bytes(rec, str, size);
+        advance_offset(offset_bits, 8, size * 8);
+        break;
+    }
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_STRUCT:
+        advance_offset(offset_bits, fc->alignment, 0);
+        append_struct_field_members_rec(rec, offset_bits, fs_sink_ctf_field_class_as_struct(fc),
+                                        field);
+        break;
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_ARRAY:
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_SEQUENCE:
+    {
+        struct fs_sink_ctf_field_class_array_base *array_base_fc =
+            fs_sink_ctf_field_class_as_array_base(fc);
+        const uint64_t len = field_array_length(field);
+
+        rec.push_back(len);
+
+        if (fc->type == FS_SINK_CTF_FIELD_CLASS_TYPE_SEQUENCE &&
+            fs_sink_ctf_field_class_as_sequence(fc)->length_is_before) {
+            advance_offset(offset_bits, 8, 32);
+        }
+
+        for (uint64_t i = 0; i < len; i++) {
+            append_field_rec(rec, offset_bits, array_base_fc->elem_fc,
+                             field_array_elem(field, i));
+        }
+
+        break;
+    }
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_STATIC_BLOB:
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_DYN_BLOB:
+    {
+        uint64_t len;
+        const void *data = field_blob_data(field, &len);
+
+        rec_append_bytes(rec, data, len);
+
+        if (fc->type == FS_SINK_CTF_FIELD_CLASS_TYPE_DYN_BLOB &&
+            fs_sink_ctf_field_class_as_sequence(fc)->length_is_before) {
+            advance_offset(offset_bits, 8, 32);
+        }
+
+        advance_offset(offset_bits, 8, len * 8);
+        break;
+    }
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_OPTION:
+    {
+        struct fs_sink_ctf_field_class_option *opt_fc = fs_sink_ctf_field_class_as_option(fc);
+        const bt_field *content_field = field_option_content(field);
+
+        rec.push_back(content_field ? 1 : 0);
+
+        if (opt_fc->tag_is_before) {
+            advance_offset(offset_bits, 8, 8);
+        }
+
+        if (content_field) {
+            append_field_rec(rec, offset_bits, opt_fc->content_fc, content_field);
+        }
+
+        break;
+    }
+    case FS_SINK_CTF_FIELD_CLASS_TYPE_VARIANT:
+    {
+        struct fs_sink_ctf_field_class_variant *var_fc = fs_sink_ctf_field_class_as_variant(fc);
+        const uint64_t opt_index = field_variant_opt_index(field);
+
+        rec.push_back(opt_index);
+
+        if (var_fc->tag_is_before) {
+            advance_offset(offset_bits, 8, 16);
+        }
+
+        append_field_rec(rec, offset_bits,
+                         fs_sink_ctf_field_class_variant_borrow_option_by_index(var_fc, opt_index)
+                             ->fc,
+                         field_variant_opt(field));
+        break;
+    }
+    default:
+        bt_common_abort();
+    }
+}
+
+static inline const bt_field *borrow_packet_context_field(struct fs_sink_stream *stream)
+{
+    const bt_field *field = NULL;
+
+    if (stream->sc->packet_context_fc) {
+        BT_ASSERT(stream->packet_state.packet);
+        field = bt_packet_borrow_context_field_const(stream->packet_state.packet);
+        BT_ASSERT(field);
+    }
+
+    return field;
+}
+
+/*
+ * Copies the values of the packet context members which this component
+ * manages from the current packet's state of `stream` to its
+ * serialization state.
+ */
+static inline void set_ser_packet_state(struct fs_sink_stream *stream)
+{
+    stream->ser_packet_state.beginning_cs = stream->packet_state.beginning_cs;
+    stream->ser_packet_state.end_cs = stream->packet_state.end_cs;
+    stream->ser_packet_state.discarded_events_counter =
+        stream->packet_state.discarded_events_counter;
+    stream->ser_packet_state.seq_num = stream->packet_state.seq_num;
+}
+
+/*
+ * Like set_ser_packet_state(), but copies the values to the writer
+ * command `cmd`.
+ */
+static inline void set_writer_cmd_packet_state(struct fs_sink_stream *stream,
+                                               struct fs_sink_writer_cmd *cmd)
+{
+    cmd->beginning_cs = stream->packet_state.beginning_cs;
+    cmd->end_cs = stream->packet_state.end_cs;
+    cmd->discarded_events_counter = stream->packet_state.discarded_events_counter;
+    cmd->seq_num = stream->packet_state.seq_num;
+}
+
+/*
+ * Returns the size (bits) of the packet header and of the packet
+ * context members which this component manages (see
+ * write_packet_beginning() and write_packet_context()) of a packet
+ * of `stream`.
+ *
+ * All those members are byte-aligned 64-bit integers, except the
+ * magic number and the UUID.
+ */
+static uint64_t packet_managed_fields_size_bits(struct fs_sink_stream *stream)
+{
+    /* Header: magic number, UUID, stream class ID, and stream ID */
+    uint64_t size_bits = 32 + BT_UUID_LEN * 8 + 64 + 64;
+
+    /* Context: total size, content size, and sequence number */
+    size_bits += 3 * 64;
+
+    if (stream->sc->packets_have_ts_begin) {
+        size_bits += 64;
+    }
+
+    if (stream->sc->packets_have_ts_end) {
+        size_bits += 64;
+    }
+
+    if (stream->sc->has_discarded_events) {
+        size_bits += 64;
+    }
+
+    return size_bits;
+}
+
+/*
+ * Sends the event `event` to the writer thread of `stream`.
+ */
+static int submit_event(struct fs_sink_stream *stream, const bt_clock_snapshot *cs,
+                        const bt_event *event, struct fs_sink_ctf_event_class *ec)
+{
+    struct fs_sink_writer_cmd *cmd = fs_sink_writer_borrow_next_cmd(stream->writer);
+
+    cmd->type = FS_SINK_WRITER_CMD_TYPE_WRITE_EVENT;
+    cmd->stream = stream;
+    cmd->ec = ec;
+    cmd->ec_id = bt_event_class_get_id(ec->ir_ec);
+    cmd->cs = cs ? bt_clock_snapshot_get_value(cs) : 0;
+    cmd->rec.clear();
+
+    /* Event header: event class ID and time (see write_event_header()) */
+    advance_offset(stream->packet_state.writer_offset_bits, 8, 64);
+
+    if (stream->sc->default_clock_class) {
+        advance_offset(stream->packet_state.writer_offset_bits, 8, 64);
+    }
+
+    if (stream->sc->event_common_context_fc) {
+        append_field_rec(cmd->rec, stream->packet_state.writer_offset_bits,
+                         stream->sc->event_common_context_fc,
+                         bt_event_borrow_common_context_field_const(event));
+    }
+
+    if (ec->spec_context_fc) {
+        append_field_rec(cmd->rec, stream->packet_state.writer_offset_bits, ec->spec_context_fc,
+                         bt_event_borrow_specific_context_field_const(event));
+    }
+
+    if (ec->payload_fc) {
+        append_field_rec(cmd->rec, stream->packet_state.writer_offset_bits, ec->payload_fc,
+                         bt_event_borrow_payload_field_const(event));
+    }
+
+    return fs_sink_writer_submit_cmd(stream->writer);
+}
+
+int fs_sink_stream_write_event(struct fs_sink_stream *stream, const bt_clock_snapshot *cs,
+                               const bt_event *event, struct fs_sink_ctf_event_class *ec)
+{
+    if (stream->writer) {
+        return submit_event(stream, cs, event, ec);
+    }
+
+    BT_ASSERT_DBG(!stream->sc->default_clock_class || cs);
+    return write_event(stream, ec, bt_event_class_get_id(ec->ir_ec),
+                       cs ? bt_clock_snapshot_get_value(cs) : 0,
+                       stream->sc->event_common_context_fc ?
+                           bt_event_borrow_common_context_field_const(event) :
+                           NULL,
+                       ec->spec_context_fc ? bt_event_borrow_specific_context_field_const(event) :
+                                             NULL,
+                       ec->payload_fc ? bt_event_borrow_payload_field_const(event) : NULL);
+}
+
+int fs_sink_stream_open_packet(struct fs_sink_stream *stream, const bt_clock_snapshot *cs,
+                               const bt_packet *packet)
+{
+    int ret;
+
+    BT_ASSERT(!stream->packet_state.is_open);
+
+    if (G_UNLIKELY(stream->chunk != stream->trace->cur_chunk)) {
+        /* Trace chunk rotated since the last packet */
+        ret = switch_to_cur_chunk(stream);
+        if (ret) {
+            BT_CPPLOGE_SPEC(stream->logger,
+                            "Cannot switch stream to new trace chunk: stream-file-name={}",
+                            stream->file_name->str);
+            goto end;
+        }
+    }
+
+    bt_packet_put_ref(stream->packet_state.packet);
+    stream->packet_state.packet = packet;
+    bt_packet_get_ref(stream->packet_state.packet);
+    if (cs) {
+        stream->packet_state.beginning_cs = bt_clock_snapshot_get_value(cs);
+    }
+
+    if (stream->writer) {
+        struct fs_sink_writer_cmd *cmd = fs_sink_writer_borrow_next_cmd(stream->writer);
+        const bt_field *packet_context_field = borrow_packet_context_field(stream);
+
+        cmd->type = FS_SINK_WRITER_CMD_TYPE_OPEN_PACKET;
+        cmd->stream = stream;
+        set_writer_cmd_packet_state(stream, cmd);
+        cmd->rec.clear();
+        stream->packet_state.writer_offset_bits = packet_managed_fields_size_bits(stream);
+
+        /* Like write_packet_context(): don't align the structure */
+        if (packet_context_field) {
+            append_struct_field_members_rec(
+                cmd->rec, stream->packet_state.writer_offset_bits,
+                fs_sink_ctf_field_class_as_struct(stream->sc->packet_context_fc),
+                packet_context_field);
+        }
+
+        ret = fs_sink_writer_submit_cmd(stream->writer);
+    } else {
+        set_ser_packet_state(stream);
+        ret = write_packet_beginning(stream, borrow_packet_context_field(stream));
+    }
+
     if (ret) {
         goto end;
     }
@@ -654,6 +1418,36 @@ end:
     return ret;
 }
 
+/*
+ * Accounts the packet which `stream` just closed to its trace chunk,
+ * possibly rotating the chunks of its trace.
+ */
+static int add_closed_packet_to_chunk(struct fs_sink_stream *stream)
+{
+    const bt_clock_class *cc = stream->sc->default_clock_class;
+    int64_t begin_ns = 0;
+    int64_t end_ns = 0;
+    bool has_times = false;
+
+    if (cc && stream->packet_state.end_cs != UINT64_C(-1) &&
+        bt_clock_class_cycles_to_ns_from_origin(cc, stream->packet_state.end_cs, &end_ns) ==
+            BT_CLOCK_CLASS_CYCLES_TO_NS_FROM_ORIGIN_STATUS_OK) {
+        has_times = true;
+        begin_ns = end_ns;
+
+        if (stream->packet_state.beginning_cs != UINT64_C(-1) &&
+            bt_clock_class_cycles_to_ns_from_origin(cc, stream->packet_state.beginning_cs,
+                                                    &begin_ns) !=
+                BT_CLOCK_CLASS_CYCLES_TO_NS_FROM_ORIGIN_STATUS_OK) {
+            begin_ns = end_ns;
+        }
+    }
+
+    return fs_sink_trace_chunk_add_packet(stream->trace, stream->chunk,
+                                          stream->ser_packet_state.total_size / 8, has_times,
+                                          begin_ns, end_ns);
+}
+
 int fs_sink_stream_close_packet(struct fs_sink_stream *stream, const bt_clock_snapshot *cs)
 {
     int ret;
@@ -664,20 +1458,35 @@ int fs_sink_stream_close_packet(struct fs_sink_stream *stream, const bt_clock_sn
         stream->packet_state.end_cs = bt_clock_snapshot_get_value(cs);
     }
 
-    stream->packet_state.content_size =
-        bt_ctfser_get_offset_in_current_packet_bits(&stream->ctfser);
-    stream->packet_state.total_size = (stream->packet_state.content_size + 7) & ~UINT64_C(7);
+    if (stream->writer) {
+        struct fs_sink_writer_cmd *cmd = fs_sink_writer_borrow_next_cmd(stream->writer);
 
-    /* Rewrite packet context */
-    bt_ctfser_set_offset_in_current_packet_bits(&stream->ctfser,
-                                                stream->packet_state.context_offset_bits);
-    ret = write_packet_context(stream);
-    if (ret) {
-        goto end;
-    }
+        cmd->type = FS_SINK_WRITER_CMD_TYPE_CLOSE_PACKET;
+        cmd->stream = stream;
+        set_writer_cmd_packet_state(stream, cmd);
+        cmd->content_size_bits = stream->packet_state.writer_offset_bits;
+        ret = fs_sink_writer_submit_cmd(stream->writer);
+        if (ret) {
+            goto end;
+        }
+    } else {
+        set_ser_packet_state(stream);
+        ret = write_packet_end(stream, borrow_packet_context_field(stream));
+        if (ret) {
+            goto end;
+        }
 
-    /* Close packet */
-    bt_ctfser_close_current_packet(&stream->ctfser, stream->packet_state.total_size / 8);
+        if (stream->chunk) {
+            ret = add_closed_packet_to_chunk(stream);
+            if (ret) {
+                goto end;
+            }
+        }
+
+        stream->ser_packet_state.content_size = 0;
+        stream->ser_packet_state.total_size = 0;
+        stream->ser_packet_state.context_offset_bits = 0;
+    }
 
     /* Partially copy current packet state to previous packet state */
     stream->prev_packet_state.end_cs = stream->packet_state.end_cs;
@@ -688,13 +1497,76 @@ int fs_sink_stream_close_packet(struct fs_sink_stream *stream, const bt_clock_sn
     /* Reset current packet state */
     stream->packet_state.beginning_cs = UINT64_C(-1);
     stream->packet_state.end_cs = UINT64_C(-1);
-    stream->packet_state.content_size = 0;
-    stream->packet_state.total_size = 0;
     stream->packet_state.seq_num += 1;
-    stream->packet_state.context_offset_bits = 0;
+    stream->packet_state.writer_offset_bits = 0;
     stream->packet_state.is_open = false;
     BT_PACKET_PUT_REF_AND_RESET(stream->packet_state.packet);
 
 end:
     return ret;
 }
+
+uint64_t fs_sink_stream_get_cur_packet_size_bytes(struct fs_sink_stream *stream)
+{
+    if (stream->writer) {
+        return stream->packet_state.writer_offset_bits / 8;
+    }
+
+    return bt_ctfser_get_offset_in_current_packet_bits(&stream->ctfser) / 8;
+}
+
+int fs_sink_stream_flush(struct fs_sink_stream *stream)
+{
+    int ret = 0;
+
+    if (stream->writer && !stream->writer_finalized) {
+        ret = fs_sink_writer_finalize_stream(stream->writer, stream);
+        if (ret) {
+            BT_CPPLOGE_SPEC(stream->logger, "Writer thread failed to write stream file: path={}/{}",
+                            stream->trace->path->str, stream->file_name->str);
+        }
+    }
+
+    return ret;
+}
+
+int fs_sink_stream_exec_writer_cmd(struct fs_sink_stream *stream, struct fs_sink_writer_cmd *cmd)
+{
+    fs_sink_stream_rec_reader reader;
+    int ret;
+
+    switch (cmd->type) {
+    case FS_SINK_WRITER_CMD_TYPE_OPEN_PACKET:
+        stream->ser_packet_state.beginning_cs = cmd->beginning_cs;
+        stream->ser_packet_state.end_cs = cmd->end_cs;
+        stream->ser_packet_state.discarded_events_counter = cmd->discarded_events_counter;
+        stream->ser_packet_state.seq_num = cmd->seq_num;
+
+        /* Keep the packet context field record to rewrite it */
+        stream->writer_packet_context_rec.swap(cmd->rec);
+        reader.cur = stream->writer_packet_context_rec.data();
+        ret = write_packet_beginning(stream, &reader);
+        break;
+    case FS_SINK_WRITER_CMD_TYPE_WRITE_EVENT:
+        reader.cur = cmd->rec.data();
+        ret = write_event(stream, cmd->ec, cmd->ec_id, cmd->cs, &reader, &reader, &reader);
+        BT_ASSERT_DBG(reader.cur == cmd->rec.data() + cmd->rec.size());
+        break;
+    case FS_SINK_WRITER_CMD_TYPE_CLOSE_PACKET:
+        stream->ser_packet_state.beginning_cs = cmd->beginning_cs;
+        stream->ser_packet_state.end_cs = cmd->end_cs;
+        stream->ser_packet_state.discarded_events_counter = cmd->discarded_events_counter;
+        stream->ser_packet_state.seq_num = cmd->seq_num;
+        reader.cur = stream->writer_packet_context_rec.data();
+        ret = write_packet_end(stream, &reader);
+        BT_ASSERT_DBG(ret || stream->ser_packet_state.content_size == cmd->content_size_bits);
+        break;
+    case FS_SINK_WRITER_CMD_TYPE_FINALIZE_STREAM:
+        ret = bt_ctfser_fini(&stream->ctfser);
+        break;
+    default:
+        bt_common_abort();
+    }
+
+    return ret;
+}
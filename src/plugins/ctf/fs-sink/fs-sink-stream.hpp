@@ -7,6 +7,8 @@
 #ifndef BABELTRACE_PLUGINS_CTF_FS_SINK_FS_SINK_STREAM_HPP
 #define BABELTRACE_PLUGINS_CTF_FS_SINK_FS_SINK_STREAM_HPP
 
+#include <vector>
+
 #include <glib.h>
 #include <stdint.h>
 
@@ -16,7 +18,10 @@
 #include "ctfser/ctfser.h"
 
 struct fs_sink_trace;
+struct fs_sink_trace_chunk;
 struct fs_sink_ctf_stream_class;
+struct fs_sink_writer;
+struct fs_sink_writer_cmd;
 
 struct fs_sink_stream
 {
@@ -32,11 +37,44 @@ struct fs_sink_stream
     /* Stream's file name */
     GString *file_name = nullptr;
 
+    /*
+     * Trace chunk to which this stream currently writes (`nullptr`
+     * if rotation is disabled).
+     */
+    fs_sink_trace_chunk *chunk = nullptr;
+
     /* Weak */
     const bt_stream *ir_stream = nullptr;
 
     fs_sink_ctf_stream_class *sc = nullptr;
 
+    /* IDs of the trace IR stream and of its class (packet header) */
+    uint64_t ir_stream_class_id = 0;
+    uint64_t ir_stream_id = 0;
+
+    /*
+     * Writer thread of this stream (`nullptr` if the component
+     * serializes from the graph thread).
+     *
+     * When this is set, only this writer thread accesses `ctfser`
+     * and `ser_packet_state` after the creation of the stream.
+     */
+    fs_sink_writer *writer = nullptr;
+
+    /*
+     * Set by the writer thread of this stream when a write
+     * operation fails, and when it finalized `ctfser` (protected by
+     * the mutex of `writer`).
+     */
+    bool writer_failed = false;
+    bool writer_finalized = false;
+
+    /*
+     * Field record of the current packet's context field (see
+     * fs_sink_stream_exec_writer_cmd()).
+     */
+    std::vector<uint64_t> writer_packet_context_rec;
+
     /* Current packet's state */
     struct
     {
@@ -59,18 +97,6 @@ struct fs_sink_stream
          */
         uint64_t end_cs = 0;
 
-        /*
-         * Current packet's content size (bits) for the current
-         * packet.
-         */
-        uint64_t content_size = 0;
-
-        /*
-         * Current packet's total size (bits) for the current
-         * packet.
-         */
-        uint64_t total_size = 0;
-
         /*
          * Discarded events (free running) counter for the
          * current packet.
@@ -81,10 +107,12 @@ struct fs_sink_stream
         uint64_t seq_num = 0;
 
         /*
-         * Offset of the packet context structure within the
-         * current packet (bits).
+         * Offset (bits) within the current packet at which the
+         * writer thread will be once it executes the commands which
+         * the component sent to it for this packet (only used when
+         * `writer` is set).
          */
-        uint64_t context_offset_bits = 0;
+        uint64_t writer_offset_bits = 0;
 
         /*
          * Owned by this; `NULL` if the current packet is closed
@@ -93,6 +121,28 @@ struct fs_sink_stream
         const bt_packet *packet = nullptr;
     } packet_state;
 
+    /*
+     * Serialization state of the current packet, that is, the
+     * values which the serializer writes to the packet context.
+     */
+    struct
+    {
+        uint64_t beginning_cs = 0;
+        uint64_t end_cs = 0;
+        uint64_t discarded_events_counter = 0;
+        uint64_t seq_num = 0;
+
+        /* Content and total sizes (bits) of the current packet */
+        uint64_t content_size = 0;
+        uint64_t total_size = 0;
+
+        /*
+         * Offset of the packet context structure within the
+         * current packet (bits).
+         */
+        uint64_t context_offset_bits = 0;
+    } ser_packet_state;
+
     /* Previous packet's state */
     struct
     {
@@ -179,4 +229,26 @@ int fs_sink_stream_open_packet(struct fs_sink_stream *stream, const bt_clock_sna
 
 int fs_sink_stream_close_packet(struct fs_sink_stream *stream, const bt_clock_snapshot *cs);
 
+/*
+ * Returns the current size (bytes) of the current packet of `stream`.
+ *
+ * If `stream` has a writer thread, then this is the size which the
+ * current packet will have once the writer thread executes the
+ * commands which the component sent to it.
+ */
+uint64_t fs_sink_stream_get_cur_packet_size_bytes(struct fs_sink_stream *stream);
+
+/*
+ * Makes the writer thread of `stream`, if any, write all the pending
+ * commands of `stream` and finalize its file, waiting for it.
+ */
+int fs_sink_stream_flush(struct fs_sink_stream *stream);
+
+/*
+ * Executes the command `cmd` for `stream`.
+ *
+ * The writer thread of `stream` calls this.
+ */
+int fs_sink_stream_exec_writer_cmd(struct fs_sink_stream *stream, struct fs_sink_writer_cmd *cmd);
+
 #endif /* BABELTRACE_PLUGINS_CTF_FS_SINK_FS_SINK_STREAM_HPP */
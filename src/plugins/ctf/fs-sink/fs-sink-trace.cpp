@@ -457,12 +457,199 @@ end:
     return unique_full_path;
 }
 
-void fs_sink_trace_destroy(struct fs_sink_trace *trace)
+/*
+ * Writes the metadata file of `trace` to `path`.
+ */
+static int write_metadata_file(struct fs_sink_trace *trace, const char *path)
 {
-    GString *metadata = NULL;
+    GString *metadata = g_string_new(NULL);
     FILE *fh = NULL;
     size_t len;
+    int ret = 0;
+
+    BT_ASSERT(metadata);
+
+    if (trace->fs_sink->ctf_version == 1) {
+        translate_trace_ctf_ir_to_tsdl(trace->trace, metadata);
+    } else {
+        BT_ASSERT(trace->fs_sink->ctf_version == 2);
+        translate_trace_ctf_ir_to_json(trace->trace, metadata);
+    }
+
+    fh = fopen(path, "wb");
+    if (!fh) {
+        BT_CPPLOGE_ERRNO_SPEC(trace->logger, "Cannot open metadata file for writing",
+                              ": path=\"{}\"", path);
+        ret = -1;
+        goto end;
+    }
+
+    len = fwrite(metadata->str, sizeof(*metadata->str), metadata->len, fh);
+    if (len != metadata->len) {
+        BT_CPPLOGE_ERRNO_SPEC(trace->logger, "Cannot write metadata file", ": path=\"{}\"", path);
+        ret = -1;
+        goto end;
+    }
+
+end:
+    if (fh) {
+        if (fclose(fh) != 0) {
+            BT_CPPLOGW_ERRNO_SPEC(trace->logger, "Cannot close metadata file", ": path=\"{}\"",
+                                  path);
+        }
+    }
+
+    g_string_free(metadata, TRUE);
+    return ret;
+}
+
+static struct fs_sink_trace_chunk *create_chunk(struct fs_sink_trace *trace)
+{
+    fs_sink_trace_chunk *chunk = new fs_sink_trace_chunk;
+
+    chunk->index = trace->next_chunk_index;
+    trace->next_chunk_index++;
+    chunk->path = g_string_new(NULL);
+    BT_ASSERT(chunk->path);
+    g_string_printf(chunk->path,
+                    "%s" G_DIR_SEPARATOR_S "archives" G_DIR_SEPARATOR_S "chunk-%" PRIu64,
+                    trace->path->str, chunk->index);
+    return chunk;
+}
+
+static void destroy_chunk(struct fs_sink_trace_chunk *chunk)
+{
+    if (!chunk) {
+        return;
+    }
+
+    if (chunk->path) {
+        g_string_free(chunk->path, TRUE);
+        chunk->path = NULL;
+    }
+
+    delete chunk;
+}
+
+/*
+ * Writes the metadata file of `chunk`, if any stream was ever written
+ * to it, and destroys it.
+ */
+static int finalize_chunk(struct fs_sink_trace *trace, struct fs_sink_trace_chunk *chunk)
+{
+    int ret = 0;
+
+    BT_ASSERT(chunk->stream_count == 0);
+
+    if (chunk->dir_created) {
+        GString *metadata_path = g_string_new(chunk->path->str);
+
+        BT_ASSERT(metadata_path);
+        g_string_append(metadata_path, G_DIR_SEPARATOR_S "metadata");
+        ret = write_metadata_file(trace, metadata_path->str);
+        g_string_free(metadata_path, TRUE);
 
+        if (ret == 0) {
+            BT_CPPLOGI_SPEC(trace->logger,
+                            "Finalized trace chunk: path=\"{}\", index={}, size-bytes={}",
+                            chunk->path->str, chunk->index, chunk->size_bytes);
+        }
+    }
+
+    destroy_chunk(chunk);
+    return ret;
+}
+
+static int rotate_chunks(struct fs_sink_trace *trace)
+{
+    fs_sink_trace_chunk *prev_chunk = trace->cur_chunk;
+    int ret = 0;
+
+    BT_ASSERT(prev_chunk);
+    trace->cur_chunk = create_chunk(trace);
+    BT_CPPLOGI_SPEC(trace->logger,
+                    "Rotating trace chunk: prev-chunk-index={}, prev-chunk-size-bytes={}, "
+                    "new-chunk-path=\"{}\"",
+                    prev_chunk->index, prev_chunk->size_bytes, trace->cur_chunk->path->str);
+
+    /*
+     * If streams are still writing to the previous chunk, it's
+     * finalized when the last one switches to a newer chunk (next
+     * packet beginning) or is destroyed.
+     */
+    if (prev_chunk->stream_count == 0) {
+        ret = finalize_chunk(trace, prev_chunk);
+    }
+
+    return ret;
+}
+
+struct fs_sink_trace_chunk *fs_sink_trace_acquire_cur_chunk(struct fs_sink_trace *trace)
+{
+    fs_sink_trace_chunk *chunk = trace->cur_chunk;
+
+    BT_ASSERT(chunk);
+
+    if (!chunk->dir_created) {
+        if (g_mkdir_with_parents(chunk->path->str, 0755)) {
+            BT_CPPLOGE_ERRNO_SPEC(trace->logger, "Cannot create directories for trace chunk",
+                                  ": path=\"{}\"", chunk->path->str);
+            return NULL;
+        }
+
+        chunk->dir_created = true;
+    }
+
+    chunk->stream_count++;
+    return chunk;
+}
+
+int fs_sink_trace_release_chunk(struct fs_sink_trace *trace, struct fs_sink_trace_chunk *chunk)
+{
+    BT_ASSERT(chunk);
+    BT_ASSERT(chunk->stream_count > 0);
+    chunk->stream_count--;
+
+    if (chunk->stream_count == 0 && chunk != trace->cur_chunk) {
+        return finalize_chunk(trace, chunk);
+    }
+
+    return 0;
+}
+
+int fs_sink_trace_chunk_add_packet(struct fs_sink_trace *trace, struct fs_sink_trace_chunk *chunk,
+                                   uint64_t size_bytes, bool has_times, int64_t begin_ns,
+                                   int64_t end_ns)
+{
+    const fs_sink_comp *fs_sink = trace->fs_sink;
+    bool rotate = false;
+
+    chunk->size_bytes += size_bytes;
+
+    if (has_times && !chunk->has_begin_ns) {
+        chunk->begin_ns = begin_ns;
+        chunk->has_begin_ns = true;
+    }
+
+    if (chunk != trace->cur_chunk) {
+        /* Already rotated */
+        return 0;
+    }
+
+    if (fs_sink->rotate_size_bytes > 0 && chunk->size_bytes >= fs_sink->rotate_size_bytes) {
+        rotate = true;
+    }
+
+    if (fs_sink->rotate_duration_ns > 0 && has_times && end_ns >= chunk->begin_ns &&
+        (uint64_t) end_ns - (uint64_t) chunk->begin_ns >= fs_sink->rotate_duration_ns) {
+        rotate = true;
+    }
+
+    return rotate ? rotate_chunks(trace) : 0;
+}
+
+void fs_sink_trace_destroy(struct fs_sink_trace *trace)
+{
     if (!trace) {
         goto end;
     }
@@ -478,69 +665,53 @@ void fs_sink_trace_destroy(struct fs_sink_trace *trace)
         trace->ir_trace_destruction_listener_id = UINT64_C(-1);
     }
 
+    /*
+     * This also finalizes the previous chunks to which streams were
+     * still writing, if any.
+     */
     if (trace->streams) {
         g_hash_table_destroy(trace->streams);
         trace->streams = NULL;
     }
 
-    metadata = g_string_new(NULL);
-    BT_ASSERT(metadata);
+    if (trace->cur_chunk) {
+        fs_sink_trace_chunk *chunk = trace->cur_chunk;
 
-    if (trace->fs_sink->ctf_version == 1) {
-        translate_trace_ctf_ir_to_tsdl(trace->trace, metadata);
-    } else {
-        BT_ASSERT(trace->fs_sink->ctf_version == 2);
-        translate_trace_ctf_ir_to_json(trace->trace, metadata);
-    }
-
-    BT_ASSERT(trace->metadata_path);
-    fh = fopen(trace->metadata_path->str, "wb");
-    if (!fh) {
-        BT_CPPLOGF_ERRNO_SPEC(trace->logger,
-                              "In trace destruction listener: "
-                              "cannot open metadata file for writing",
-                              ": path=\"{}\"", trace->metadata_path->str);
-        bt_common_abort();
-    }
-
-    len = fwrite(metadata->str, sizeof(*metadata->str), metadata->len, fh);
-    if (len != metadata->len) {
-        BT_CPPLOGF_ERRNO_SPEC(trace->logger,
-                              "In trace destruction listener: "
-                              "cannot write metadata file",
-                              ": path=\"{}\"", trace->metadata_path->str);
-        bt_common_abort();
-    }
+        trace->cur_chunk = NULL;
 
-    if (!trace->fs_sink->quiet) {
-        printf("Created CTF trace `%s`.\n", trace->path->str);
+        if (finalize_chunk(trace, chunk)) {
+            BT_CPPLOGF_SPEC(trace->logger, "In trace destruction listener: "
+                                           "cannot finalize current trace chunk");
+            bt_common_abort();
+        }
+    } else if (trace->metadata_path) {
+        if (write_metadata_file(trace, trace->metadata_path->str)) {
+            BT_CPPLOGF_SPEC(trace->logger,
+                            "In trace destruction listener: "
+                            "cannot write metadata file: path=\"{}\"",
+                            trace->metadata_path->str);
+            bt_common_abort();
+        }
     }
 
     if (trace->path) {
+        if (!trace->fs_sink->quiet) {
+            printf("Created CTF trace `%s`.\n", trace->path->str);
+        }
+
         g_string_free(trace->path, TRUE);
         trace->path = NULL;
     }
 
-    if (fh) {
-        int ret = fclose(fh);
-
-        if (ret != 0) {
-            BT_CPPLOGW_ERRNO_SPEC(trace->logger,
-                                  "In trace destruction listener: "
-                                  "cannot close metadata file",
-                                  ": path=\"{}\"", trace->metadata_path->str);
-        }
+    if (trace->metadata_path) {
+        g_string_free(trace->metadata_path, TRUE);
+        trace->metadata_path = NULL;
     }
 
-    g_string_free(trace->metadata_path, TRUE);
-    trace->metadata_path = NULL;
-
     fs_sink_ctf_trace_destroy(trace->trace);
     trace->trace = NULL;
     delete trace;
 
-    g_string_free(metadata, TRUE);
-
 end:
     return;
 }
@@ -581,9 +752,15 @@ struct fs_sink_trace *fs_sink_trace_create(struct fs_sink_comp *fs_sink, const b
         goto error;
     }
 
-    trace->metadata_path = g_string_new(trace->path->str);
-    BT_ASSERT(trace->metadata_path);
-    g_string_append(trace->metadata_path, "/metadata");
+    if (fs_sink->rotate_size_bytes > 0 || fs_sink->rotate_duration_ns > 0) {
+        /* Stream and metadata files go to trace chunk directories */
+        trace->cur_chunk = create_chunk(trace);
+    } else {
+        trace->metadata_path = g_string_new(trace->path->str);
+        BT_ASSERT(trace->metadata_path);
+        g_string_append(trace->metadata_path, "/metadata");
+    }
+
     trace->streams = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
                                            (GDestroyNotify) fs_sink_stream_destroy);
     BT_ASSERT(trace->streams);
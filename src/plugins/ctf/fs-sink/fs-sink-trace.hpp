@@ -8,6 +8,7 @@
 #define BABELTRACE_PLUGINS_CTF_FS_SINK_FS_SINK_TRACE_HPP
 
 #include <glib.h>
+#include <stdint.h>
 
 #include <babeltrace2/babeltrace.h>
 
@@ -16,6 +17,44 @@
 struct fs_sink_comp;
 struct fs_sink_ctf_trace;
 
+/*
+ * Trace chunk.
+ *
+ * When rotation is enabled (see `fs_sink_comp::rotate_size_bytes` and
+ * `fs_sink_comp::rotate_duration_ns`), a trace is written as a
+ * sequence of chunks, each one being a complete CTF trace (metadata
+ * and data stream files) in its own `archives/chunk-INDEX` directory
+ * within the trace directory, like the archived trace chunks of an
+ * LTTng tracing session rotation.
+ *
+ * Streams switch to the current chunk of their trace at packet
+ * boundaries only.
+ */
+struct fs_sink_trace_chunk
+{
+    /* Index of this chunk within its trace */
+    uint64_t index = 0;
+
+    /* Chunk's directory */
+    GString *path = nullptr;
+
+    /* True if the chunk's directory exists */
+    bool dir_created = false;
+
+    /* Number of streams currently writing to this chunk */
+    uint64_t stream_count = 0;
+
+    /* Total size (bytes) of the packets written to this chunk */
+    uint64_t size_bytes = 0;
+
+    /*
+     * Time (nanoseconds from origin) of the first packet written to
+     * this chunk, if `has_begin_ns` is true.
+     */
+    bool has_begin_ns = false;
+    int64_t begin_ns = 0;
+};
+
 struct fs_sink_trace
 {
     explicit fs_sink_trace(const bt2c::Logger& parentLogger) :
@@ -48,9 +87,15 @@ struct fs_sink_trace
     /* Trace's directory */
     GString *path = nullptr;
 
-    /* `metadata` file path */
+    /* `metadata` file path (rotation disabled) */
     GString *metadata_path = nullptr;
 
+    /* Current chunk (owned by this; `nullptr` if rotation is disabled) */
+    fs_sink_trace_chunk *cur_chunk = nullptr;
+
+    /* Index of the next chunk to create */
+    uint64_t next_chunk_index = 0;
+
     /*
      * Hash table of `const bt_stream *` (weak) to
      * `struct fs_sink_stream *` (owned by hash table).
@@ -62,4 +107,31 @@ struct fs_sink_trace *fs_sink_trace_create(struct fs_sink_comp *fs_sink, const b
 
 void fs_sink_trace_destroy(struct fs_sink_trace *trace);
 
+/*
+ * Makes a stream of `trace` start writing to the current chunk of
+ * `trace`, creating the chunk's directory if needed, and returns it.
+ *
+ * Returns `nullptr` on error.
+ */
+struct fs_sink_trace_chunk *fs_sink_trace_acquire_cur_chunk(struct fs_sink_trace *trace);
+
+/*
+ * Makes a stream of `trace` stop writing to `chunk`.
+ *
+ * This function finalizes `chunk` (writes its metadata file) if no
+ * stream writes to it anymore and it's not the current chunk of
+ * `trace` anymore.
+ */
+int fs_sink_trace_release_chunk(struct fs_sink_trace *trace, struct fs_sink_trace_chunk *chunk);
+
+/*
+ * Records that a packet of `size_bytes` bytes spanning from
+ * `begin_ns` to `end_ns` (nanoseconds from origin, if `has_times` is
+ * true) was written to `chunk`, and rotates the chunks of `trace` if
+ * `chunk` is the current one and it reached a rotation threshold.
+ */
+int fs_sink_trace_chunk_add_packet(struct fs_sink_trace *trace, struct fs_sink_trace_chunk *chunk,
+                                   uint64_t size_bytes, bool has_times, int64_t begin_ns,
+                                   int64_t end_ns);
+
 #endif /* BABELTRACE_PLUGINS_CTF_FS_SINK_FS_SINK_TRACE_HPP */
@@ -0,0 +1,191 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ */
+
+#include "common/assert.h"
+
+#include "fs-sink-stream.hpp"
+#include "fs-sink-writer.hpp"
+
+/*
+ * Maximum number of pending commands of a writer thread: beyond this,
+ * the graph thread waits for the writer thread to catch up.
+ */
+static constexpr std::size_t max_pending_cmds = 4096;
+
+static void writer_thread_func(fs_sink_writer *writer)
+{
+    std::unique_lock<std::mutex> lock {writer->mutex};
+
+    while (true) {
+        fs_sink_writer_cmd *cmd;
+        fs_sink_stream *stream;
+        bool skip;
+        int ret = 0;
+
+        writer->cmd_avail_cond.wait(lock, [writer] {
+            return writer->quit || !writer->cmds.empty();
+        });
+
+        if (writer->cmds.empty()) {
+            /* Quitting */
+            break;
+        }
+
+        cmd = writer->cmds.front();
+        writer->cmds.pop_front();
+        stream = cmd->stream;
+
+        /*
+         * Once a command of a stream fails, only finalize its
+         * file: the graph thread reports the error.
+         */
+        skip = stream->writer_failed && cmd->type != FS_SINK_WRITER_CMD_TYPE_FINALIZE_STREAM;
+        lock.unlock();
+
+        if (!skip) {
+            ret = fs_sink_stream_exec_writer_cmd(stream, cmd);
+        }
+
+        lock.lock();
+
+        if (ret) {
+            BT_CPPLOGE_SPEC(writer->logger, "Failed to execute writer command: type={}",
+                            static_cast<int>(cmd->type));
+            stream->writer_failed = true;
+        }
+
+        if (cmd->type == FS_SINK_WRITER_CMD_TYPE_FINALIZE_STREAM) {
+            /* The graph thread may destroy `stream` from now on */
+            stream->writer_finalized = true;
+        }
+
+        cmd->stream = nullptr;
+        cmd->ec = nullptr;
+        writer->free_cmds.push_back(cmd);
+        writer->progress_cond.notify_all();
+    }
+}
+
+fs_sink_writer_pool *fs_sink_writer_pool_create(const unsigned int thread_count,
+                                                const bt2c::Logger& parentLogger)
+{
+    fs_sink_writer_pool *pool = new fs_sink_writer_pool;
+
+    BT_ASSERT(thread_count > 0);
+
+    for (unsigned int i = 0; i < thread_count; i++) {
+        pool->writers.emplace_back(new fs_sink_writer {parentLogger});
+
+        fs_sink_writer *writer = pool->writers.back().get();
+
+        writer->thread = std::thread {writer_thread_func, writer};
+    }
+
+    BT_CPPLOGI_SPEC(parentLogger, "Created writer threads: count={}", thread_count);
+    return pool;
+}
+
+void fs_sink_writer_pool_destroy(fs_sink_writer_pool *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    for (auto& writer : pool->writers) {
+        {
+            std::lock_guard<std::mutex> lock {writer->mutex};
+
+            writer->quit = true;
+        }
+
+        writer->cmd_avail_cond.notify_one();
+        writer->thread.join();
+        BT_ASSERT(writer->cmds.empty());
+
+        for (fs_sink_writer_cmd *cmd : writer->free_cmds) {
+            delete cmd;
+        }
+
+        delete writer->next_cmd;
+    }
+
+    delete pool;
+}
+
+fs_sink_writer *fs_sink_writer_pool_assign_writer(fs_sink_writer_pool *pool)
+{
+    fs_sink_writer *writer = pool->writers[pool->next_writer_index].get();
+
+    pool->next_writer_index = (pool->next_writer_index + 1) % pool->writers.size();
+    return writer;
+}
+
+fs_sink_writer_cmd *fs_sink_writer_borrow_next_cmd(fs_sink_writer *writer)
+{
+    if (!writer->next_cmd) {
+        writer->next_cmd = new fs_sink_writer_cmd;
+    }
+
+    return writer->next_cmd;
+}
+
+static int submit_cmd(fs_sink_writer *writer, std::unique_lock<std::mutex>& lock)
+{
+    fs_sink_writer_cmd *cmd = writer->next_cmd;
+    bool was_empty;
+
+    BT_ASSERT_DBG(cmd);
+    BT_ASSERT_DBG(cmd->stream);
+
+    writer->progress_cond.wait(lock, [writer] {
+        return writer->cmds.size() < max_pending_cmds;
+    });
+
+    if (cmd->stream->writer_failed && cmd->type != FS_SINK_WRITER_CMD_TYPE_FINALIZE_STREAM) {
+        return -1;
+    }
+
+    was_empty = writer->cmds.empty();
+    writer->cmds.push_back(cmd);
+
+    /* Reuse an executed command, if any, as the next one */
+    if (writer->free_cmds.empty()) {
+        writer->next_cmd = nullptr;
+    } else {
+        writer->next_cmd = writer->free_cmds.back();
+        writer->free_cmds.pop_back();
+    }
+
+    if (was_empty) {
+        writer->cmd_avail_cond.notify_one();
+    }
+
+    return 0;
+}
+
+int fs_sink_writer_submit_cmd(fs_sink_writer *writer)
+{
+    std::unique_lock<std::mutex> lock {writer->mutex};
+
+    return submit_cmd(writer, lock);
+}
+
+int fs_sink_writer_finalize_stream(fs_sink_writer *writer, fs_sink_stream *stream)
+{
+    fs_sink_writer_cmd *cmd = fs_sink_writer_borrow_next_cmd(writer);
+    std::unique_lock<std::mutex> lock {writer->mutex};
+    int ret;
+
+    cmd->type = FS_SINK_WRITER_CMD_TYPE_FINALIZE_STREAM;
+    cmd->stream = stream;
+    ret = submit_cmd(writer, lock);
+    BT_ASSERT(ret == 0);
+    writer->progress_cond.wait(lock, [stream] {
+        return stream->writer_finalized;
+    });
+
+    return stream->writer_failed ? -1 : 0;
+}
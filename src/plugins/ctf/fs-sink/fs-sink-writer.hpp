@@ -0,0 +1,171 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ */
+
+#ifndef BABELTRACE_PLUGINS_CTF_FS_SINK_FS_SINK_WRITER_HPP
+#define BABELTRACE_PLUGINS_CTF_FS_SINK_FS_SINK_WRITER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+#include "cpp-common/bt2c/logging.hpp"
+
+struct fs_sink_stream;
+struct fs_sink_ctf_event_class;
+
+enum fs_sink_writer_cmd_type
+{
+    FS_SINK_WRITER_CMD_TYPE_OPEN_PACKET,
+    FS_SINK_WRITER_CMD_TYPE_WRITE_EVENT,
+    FS_SINK_WRITER_CMD_TYPE_CLOSE_PACKET,
+    FS_SINK_WRITER_CMD_TYPE_FINALIZE_STREAM,
+};
+
+/*
+ * Command which the graph thread sends to the writer thread of a
+ * stream.
+ *
+ * A command contains no trace IR object: only values which the graph
+ * thread extracted from them.
+ */
+struct fs_sink_writer_cmd
+{
+    fs_sink_writer_cmd_type type = FS_SINK_WRITER_CMD_TYPE_WRITE_EVENT;
+
+    /* Weak */
+    fs_sink_stream *stream = nullptr;
+
+    /*
+     * `FS_SINK_WRITER_CMD_TYPE_OPEN_PACKET` and
+     * `FS_SINK_WRITER_CMD_TYPE_CLOSE_PACKET`: values of the packet
+     * context members which the component manages.
+     */
+    uint64_t beginning_cs = 0;
+    uint64_t end_cs = 0;
+    uint64_t discarded_events_counter = 0;
+    uint64_t seq_num = 0;
+
+    /*
+     * `FS_SINK_WRITER_CMD_TYPE_CLOSE_PACKET`: content size (bits) of
+     * the packet, as the component computed it.
+     */
+    uint64_t content_size_bits = 0;
+
+    /* `FS_SINK_WRITER_CMD_TYPE_WRITE_EVENT`: event class (weak) */
+    fs_sink_ctf_event_class *ec = nullptr;
+
+    /* `FS_SINK_WRITER_CMD_TYPE_WRITE_EVENT`: event header values */
+    uint64_t ec_id = 0;
+    uint64_t cs = 0;
+
+    /*
+     * `FS_SINK_WRITER_CMD_TYPE_OPEN_PACKET`: packet context field
+     * record.
+     *
+     * `FS_SINK_WRITER_CMD_TYPE_WRITE_EVENT`: event common context,
+     * specific context, and payload field records.
+     */
+    std::vector<uint64_t> rec;
+};
+
+/*
+ * Writer thread.
+ *
+ * A writer thread owns the stream files of the streams which the
+ * component assigned to it: it executes the commands of those streams
+ * in order.
+ */
+struct fs_sink_writer
+{
+    explicit fs_sink_writer(const bt2c::Logger& parentLogger) :
+        logger {parentLogger, "PLUGIN/SINK.CTF.FS/WRITER"}
+    {
+    }
+
+    bt2c::Logger logger;
+    std::thread thread;
+
+    /* Protects all the members below and the writer state of streams */
+    std::mutex mutex;
+
+    /* Signaled when `cmds` becomes non-empty or `quit` becomes true */
+    std::condition_variable cmd_avail_cond;
+
+    /* Signaled when the writer thread executes a command */
+    std::condition_variable progress_cond;
+
+    /* Pending commands (owned by this) */
+    std::deque<fs_sink_writer_cmd *> cmds;
+
+    /* Executed commands, ready to be reused (owned by this) */
+    std::vector<fs_sink_writer_cmd *> free_cmds;
+
+    /*
+     * Command which the graph thread fills before submitting it
+     * (owned by this; only the graph thread accesses it).
+     */
+    fs_sink_writer_cmd *next_cmd = nullptr;
+
+    /* True to make the writer thread quit once `cmds` is empty */
+    bool quit = false;
+};
+
+struct fs_sink_writer_pool
+{
+    std::vector<std::unique_ptr<fs_sink_writer>> writers;
+
+    /* Index of the writer to assign to the next stream */
+    std::size_t next_writer_index = 0;
+};
+
+/*
+ * Creates a pool of `thread_count` writer threads.
+ */
+fs_sink_writer_pool *fs_sink_writer_pool_create(unsigned int thread_count,
+                                                const bt2c::Logger& parentLogger);
+
+/*
+ * Destroys `pool`, joining its writer threads.
+ *
+ * All the streams of which the writer threads of `pool` own the files
+ * must be flushed (see fs_sink_stream_flush()).
+ */
+void fs_sink_writer_pool_destroy(fs_sink_writer_pool *pool);
+
+/*
+ * Returns the writer thread of `pool` to assign to a new stream.
+ */
+fs_sink_writer *fs_sink_writer_pool_assign_writer(fs_sink_writer_pool *pool);
+
+/*
+ * Borrows the command of `writer` which the graph thread must fill
+ * and then submit with fs_sink_writer_submit_cmd().
+ */
+fs_sink_writer_cmd *fs_sink_writer_borrow_next_cmd(fs_sink_writer *writer);
+
+/*
+ * Submits the command which fs_sink_writer_borrow_next_cmd() returned
+ * to `writer`, blocking while `writer` has too many pending commands.
+ *
+ * Returns -1, without submitting it, if a previous command of the
+ * same stream failed.
+ */
+int fs_sink_writer_submit_cmd(fs_sink_writer *writer);
+
+/*
+ * Submits a command to finalize the file of `stream` to `writer` and
+ * waits for `writer` to execute it.
+ *
+ * Returns -1 if any command of `stream` failed.
+ */
+int fs_sink_writer_finalize_stream(fs_sink_writer *writer, fs_sink_stream *stream);
+
+#endif /* BABELTRACE_PLUGINS_CTF_FS_SINK_FS_SINK_WRITER_HPP */
@@ -20,6 +20,7 @@
 #include "fs-sink-ctf-meta.hpp"
 #include "fs-sink-stream.hpp"
 #include "fs-sink-trace.hpp"
+#include "fs-sink-writer.hpp"
 #include "fs-sink.hpp"
 #include "translate-trace-ir-to-ctf-ir.hpp"
 
@@ -60,6 +61,12 @@ static bt_param_validation_map_value_entry_descr fs_sink_params_descr[] = {
      bt_param_validation_value_descr::makeBool()},
     {ctfVersionParamName, BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
      bt_param_validation_value_descr::makeString()},
+    {"rotate-size", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
+     bt_param_validation_value_descr::makeUnsignedInteger()},
+    {"rotate-duration", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
+     bt_param_validation_value_descr::makeUnsignedInteger()},
+    {"writer-threads", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
+     bt_param_validation_value_descr::makeUnsignedInteger()},
     BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_END};
 
 static int ctfVersionFromParams(const bt_value *params, const bt2c::Logger& logger)
@@ -139,6 +146,44 @@ configure_component(bt_self_component_sink *self_comp_sink, struct fs_sink_comp
         fs_sink->ctf_version = static_cast<unsigned int>(ctfVersion);
     }
 
+    value = bt_value_map_borrow_entry_value_const(params, "rotate-size");
+    if (value) {
+        fs_sink->rotate_size_bytes = bt_value_integer_unsigned_get(value);
+    }
+
+    value = bt_value_map_borrow_entry_value_const(params, "rotate-duration");
+    if (value) {
+        fs_sink->rotate_duration_ns = bt_value_integer_unsigned_get(value);
+    }
+
+    value = bt_value_map_borrow_entry_value_const(params, "writer-threads");
+    if (value) {
+        const uint64_t count = bt_value_integer_unsigned_get(value);
+
+        if (count > 256) {
+            BT_CPPLOGE_APPEND_CAUSE_SPEC(
+                fs_sink->logger,
+                "Invalid `writer-threads` parameter: expecting at most 256: value={}", count);
+            status = BT_COMPONENT_CLASS_INITIALIZE_METHOD_STATUS_ERROR;
+            goto end;
+        }
+
+        fs_sink->writer_thread_count = static_cast<unsigned int>(count);
+    }
+
+    if (fs_sink->writer_thread_count > 0 &&
+        (fs_sink->rotate_size_bytes > 0 || fs_sink->rotate_duration_ns > 0)) {
+        /*
+         * Trace chunk rotation writes metadata files and switches
+         * stream files from the graph thread.
+         */
+        BT_CPPLOGE_APPEND_CAUSE_SPEC(fs_sink->logger,
+                                     "The `writer-threads` parameter cannot be used with the "
+                                     "`rotate-size` or `rotate-duration` parameters.");
+        status = BT_COMPONENT_CLASS_INITIALIZE_METHOD_STATUS_ERROR;
+        goto end;
+    }
+
     {
         const auto mipVersion = bt2::wrap(self_comp_sink).graphMipVersion();
 
@@ -175,6 +220,10 @@ static void destroy_fs_sink_comp(struct fs_sink_comp *fs_sink)
         fs_sink->traces = NULL;
     }
 
+    /* After destroying the traces: this joins the writer threads */
+    fs_sink_writer_pool_destroy(fs_sink->writer_pool);
+    fs_sink->writer_pool = NULL;
+
     BT_MESSAGE_ITERATOR_PUT_REF_AND_RESET(fs_sink->upstream_iter);
     delete fs_sink;
 
@@ -214,6 +263,11 @@ bt_component_class_initialize_method_status ctf_fs_sink_init(bt_self_component_s
             goto end;
         }
 
+        if (fs_sink->writer_thread_count > 0) {
+            fs_sink->writer_pool =
+                fs_sink_writer_pool_create(fs_sink->writer_thread_count, fs_sink->logger);
+        }
+
         fs_sink->traces = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
                                                 (GDestroyNotify) fs_sink_trace_destroy);
         if (!fs_sink->traces) {
@@ -327,8 +381,7 @@ handle_event_msg(struct fs_sink_comp *fs_sink, const bt_message *msg)
      */
         if (G_UNLIKELY(!stream->sc->has_packets)) {
             if (stream->packet_state.is_open &&
-                bt_ctfser_get_offset_in_current_packet_bits(&stream->ctfser) / 8 >=
-                    4 * 1024 * 1024) {
+                fs_sink_stream_get_cur_packet_size_bytes(stream) >= 4 * 1024 * 1024) {
                 /*
              * Stream's current packet is larger than 4 MiB:
              * close it. A new packet will be opened just
@@ -725,10 +778,10 @@ handle_stream_beginning_msg(struct fs_sink_comp *fs_sink, const bt_message *msg)
     BT_CPPLOGI_SPEC(fs_sink->logger,
                     "Created new, empty stream file: "
                     "stream-id={}, stream-name=\"{}\", "
-                    "trace-name=\"{}\", path=\"{}/{}\"",
+                    "trace-name=\"{}\", path=\"{}\"",
                     bt_stream_get_id(ir_stream), bt2c::maybeNull(bt_stream_get_name(ir_stream)),
                     bt2c::maybeNull(bt_trace_get_name(bt_stream_borrow_trace_const(ir_stream))),
-                    stream->trace->path->str, stream->file_name->str);
+                    bt_ctfser_get_file_path(&stream->ctfser));
 
 end:
     return status;
@@ -768,6 +821,12 @@ handle_stream_end_msg(struct fs_sink_comp *fs_sink, const bt_message *msg)
                     bt2c::maybeNull(bt_trace_get_name(bt_stream_borrow_trace_const(ir_stream))),
                     stream->trace->path->str, stream->file_name->str);
 
+    if (fs_sink_stream_flush(stream)) {
+        BT_CPPLOGE_APPEND_CAUSE_SPEC(fs_sink->logger, "Failed to write stream file.");
+        status = BT_COMPONENT_CLASS_SINK_CONSUME_METHOD_STATUS_ERROR;
+        goto end;
+    }
+
     /*
      * This destroys the stream object and frees all its resources,
      * closing the stream file.
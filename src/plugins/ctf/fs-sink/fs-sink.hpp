@@ -13,6 +13,8 @@
 
 #include "cpp-common/bt2c/logging.hpp"
 
+struct fs_sink_writer_pool;
+
 struct fs_sink_comp
 {
     explicit fs_sink_comp(const bt2::SelfSinkComponent selfSinkComp) :
@@ -55,6 +57,26 @@ struct fs_sink_comp
      */
     unsigned int ctf_version = 2;
 
+    /*
+     * Trace chunk rotation thresholds: when the current chunk of a
+     * trace reaches `rotate_size_bytes` bytes of packets, or when it
+     * spans `rotate_duration_ns` nanoseconds, the component closes
+     * it and starts a new one.
+     *
+     * 0 means no threshold. Rotation is disabled when both are 0.
+     */
+    uint64_t rotate_size_bytes = 0;
+    uint64_t rotate_duration_ns = 0;
+
+    /*
+     * Number of writer threads which serialize the streams (0 to
+     * serialize from the graph thread).
+     */
+    unsigned int writer_thread_count = 0;
+
+    /* Writer threads (owned by this; `nullptr` if none) */
+    fs_sink_writer_pool *writer_pool = nullptr;
+
     /*
      * Hash table of `const bt_trace *` (weak) to
      * `struct fs_sink_trace *` (owned by hash table).
@@ -1618,6 +1618,9 @@ static int translate_event_class(struct fs_sink_comp *fs_sink, struct fs_sink_ct
         goto end;
     }
 
+    ec->spec_context_ser_prog = fs_sink_ctf_ser_prog_create(ec->spec_context_fc);
+    ec->payload_ser_prog = fs_sink_ctf_ser_prog_create(ec->payload_fc);
+
 end:
     ctx_fini(&ctx);
     *out_ec = ec;
@@ -1746,6 +1749,8 @@ static int translate_stream_class(struct fs_sink_comp *fs_sink, struct fs_sink_c
         goto error;
     }
 
+    (*out_sc)->event_common_context_ser_prog =
+        fs_sink_ctf_ser_prog_create((*out_sc)->event_common_context_fc);
     goto end;
 
 error:
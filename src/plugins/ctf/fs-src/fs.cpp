@@ -7,7 +7,12 @@
  * Babeltrace CTF file system Reader Component
  */
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <sstream>
+#include <system_error>
+#include <thread>
 
 #include <glib.h>
 
@@ -15,6 +20,7 @@
 
 #include "common/assert.h"
 #include "common/common.h"
+#include "cpp-common/bt2/error.hpp"
 #include "cpp-common/bt2/message.hpp"
 #include "cpp-common/bt2/private-query-executor.hpp"
 #include "cpp-common/bt2/wrap.hpp"
@@ -31,6 +37,7 @@
 #include "data-stream-file.hpp"
 #include "file.hpp"
 #include "fs.hpp"
+#include "index-cache.hpp"
 #include "metadata.hpp"
 #include "query.hpp"
 
@@ -366,10 +373,22 @@ static int add_ds_file_to_ds_file_group(struct ctf_fs_trace *ctf_fs_trace, const
         }
     }
 
-    auto index = ctf_fs_ds_file_build_index(*ds_file_info, traceCls);
+    /*
+     * A previous `babeltrace.trace-infos` query on the same trace may
+     * have indexed this file already.
+     */
+    const auto metadataPath =
+        fmt::format("{}" G_DIR_SEPARATOR_S CTF_FS_METADATA_FILENAME, ctf_fs_trace->path);
+    auto index = ctf_fs_ds_index_cache_find(*ds_file_info, metadataPath);
+
     if (!index) {
-        BT_CPPLOGE_APPEND_CAUSE_SPEC(logger, "Failed to index CTF stream file \'{}\'", path);
-        return -1;
+        index = ctf_fs_ds_file_build_index(*ds_file_info, traceCls);
+        if (!index) {
+            BT_CPPLOGE_APPEND_CAUSE_SPEC(logger, "Failed to index CTF stream file \'{}\'", path);
+            return -1;
+        }
+
+        ctf_fs_ds_index_cache_add(*ds_file_info, metadataPath, *index);
     }
 
     if (!stream_instance_id || begin_ns == -1) {
@@ -515,11 +534,6 @@ ctf_fs_trace_create(const char *path, const char *name, const ctf::src::ClkClsCf
         set_trace_name(*ctf_fs_trace->trace, name);
     }
 
-    int ret = create_ds_file_groups(ctf_fs_trace.get(), logger);
-    if (ret) {
-        return nullptr;
-    }
-
     return ctf_fs_trace;
 }
 
@@ -560,15 +574,108 @@ static int ctf_fs_component_create_ctf_fs_trace_one_path(
         return -1;
     }
 
-    ctf_fs_trace::UP ctf_fs_trace = ctf_fs_trace_create(
-        norm_path->str, trace_name, ctf_fs->clkClsCfg, selfComp, ctf_fs->logger);
-    if (!ctf_fs_trace) {
-        BT_CPPLOGE_APPEND_CAUSE_SPEC(ctf_fs->logger, "Cannot create trace for `{}`.",
-                                     norm_path->str);
-        return -1;
+    traces.emplace_back(ctf_fs_trace_create(norm_path->str, trace_name, ctf_fs->clkClsCfg, selfComp,
+                                            ctf_fs->logger));
+    return 0;
+}
+
+/* Maximum number of threads which create data stream file groups */
+static constexpr unsigned int maxDsFileGroupsWorkerCount = 16;
+
+/*
+ * Creates the data stream file groups of each trace of `traces`,
+ * concurrently on a bounded pool of threads.
+ *
+ * Creating the data stream file groups of a trace only reads its data
+ * stream files and its CTF IR trace class, which no other trace
+ * shares: the jobs don't need to be synchronized.
+ *
+ * Reports the failure of the first trace of `traces` which fails, as
+ * if the data stream file groups of the traces were created in order
+ * on the current thread.
+ */
+
+static int create_traces_ds_file_groups(struct ctf_fs_component *ctf_fs,
+                                        const std::vector<ctf_fs_trace::UP>& traces)
+{
+    struct Job
+    {
+        int ret = 0;
+        std::exception_ptr exc;
+        bt2::UniqueConstError error {nullptr};
+    };
+
+    std::vector<Job> jobs(traces.size());
+    std::atomic<std::size_t> nextJobIndex {0};
+
+    const auto workerFunc = [ctf_fs, &traces, &jobs, &nextJobIndex] {
+        /* bt2c::Logger isn't thread-safe: use a copy */
+        const bt2c::Logger logger {ctf_fs->logger};
+
+        while (true) {
+            const auto jobIndex = nextJobIndex++;
+
+            if (jobIndex >= jobs.size()) {
+                return;
+            }
+
+            auto& job = jobs[jobIndex];
+
+            try {
+                job.ret = create_ds_file_groups(traces[jobIndex].get(), logger);
+            } catch (...) {
+                job.exc = std::current_exception();
+            }
+
+            if (job.ret || job.exc) {
+                /* Error causes are thread-local: save them */
+                job.error = bt2::takeCurrentThreadError();
+            }
+        }
+    };
+
+    /* The current thread is also a worker */
+    const auto workerCount =
+        std::min({static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U)),
+                  static_cast<std::size_t>(maxDsFileGroupsWorkerCount), traces.size()});
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 1; i < workerCount; ++i) {
+        try {
+            threads.emplace_back(workerFunc);
+        } catch (const std::system_error& exc) {
+            /* Make do with the threads created so far */
+            BT_CPPLOGW_SPEC(ctf_fs->logger,
+                            "Cannot create data stream file group worker thread: {}", exc.what());
+            break;
+        }
     }
 
-    traces.emplace_back(std::move(ctf_fs_trace));
+    workerFunc();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        auto& job = jobs[i];
+
+        if (!job.ret && !job.exc) {
+            continue;
+        }
+
+        if (job.error) {
+            bt2::moveErrorToCurrentThread(std::move(job.error));
+        }
+
+        if (job.exc) {
+            std::rethrow_exception(job.exc);
+        }
+
+        BT_CPPLOGE_APPEND_CAUSE_SPEC(ctf_fs->logger, "Cannot create trace for `{}`.",
+                                     traces[i]->path);
+        return job.ret;
+    }
 
     return 0;
 }
@@ -746,15 +853,6 @@ protected:
     bool _mDone = false;
 };
 
-struct ClockSnapshotAfterFirstEventItemVisitor : public ClockSnapshotAfterEventItemVisitor
-{
-    void visit(const EventRecordInfoItem& item) override
-    {
-        _mResult = item.defClkVal();
-        _mDone = true;
-    }
-};
-
 /*
  * Find the timestamp of the last event of the packet, if any, otherwise
  * find the timestamp of the beginning of the packet.
@@ -819,16 +917,6 @@ static int decode_clock_snapshot_after_event(struct ctf_fs_trace *ctf_fs_trace,
     return 0;
 }
 
-static int decode_packet_first_event_timestamp(struct ctf_fs_trace *ctf_fs_trace,
-                                               const ctf_fs_ds_index_entry& index_entry,
-                                               const bt2c::Logger& logger, uint64_t *cs)
-{
-    ClockSnapshotAfterFirstEventItemVisitor visitor {};
-
-    return decode_clock_snapshot_after_event(ctf_fs_trace, index_entry, visitor, "first", logger,
-                                             cs);
-}
-
 static int decode_packet_last_event_timestamp(struct ctf_fs_trace *ctf_fs_trace,
                                               const ctf_fs_ds_index_entry& index_entry,
                                               const bt2c::Logger& logger, uint64_t *cs)
@@ -904,58 +992,6 @@ static int fix_index_lttng_event_after_packet_bug(struct ctf_fs_trace *trace,
     return 0;
 }
 
-/*
- * Fix up packet index entries for barectf's "event-before-packet" bug.
- * Some buggy barectf tracer versions may emit events with a timestamp that is
- * less than the timestamp_begin of the their packets.
- *
- * To fix up this erroneous data we do the following:
- *  1. Starting at the second index entry, set the timestamp_begin of the
- *     current entry to the timestamp of the first event of the packet.
- *  2. Set the previous entry's timestamp_end to the timestamp_begin of the
- *     current packet.
- *
- * Known buggy tracer versions:
- *  - before barectf 2.3.1
- */
-static int fix_index_barectf_event_before_packet_bug(struct ctf_fs_trace *trace,
-                                                     const bt2c::Logger& logger)
-{
-    for (const auto& ds_file_group : trace->ds_file_groups) {
-        auto& index = ds_file_group->index;
-
-        BT_ASSERT(!index.entries.empty());
-
-        /*
-         * 1. Iterate over the index, starting from the second entry
-         * (index = 1).
-         */
-        for (size_t entry_i = 1; entry_i < index.entries.size(); ++entry_i) {
-            auto& prev_entry = index.entries[entry_i - 1];
-            auto& curr_entry = index.entries[entry_i];
-            /*
-             * 2. Set the current entry `begin` timestamp to the
-             * timestamp of the first event of the current packet.
-             */
-            int ret = decode_packet_first_event_timestamp(trace, curr_entry, logger,
-                                                          &curr_entry.timestamp_begin);
-            if (ret) {
-                BT_CPPLOGE_APPEND_CAUSE_SPEC(logger,
-                                             "Failed to decode first event's clock snapshot");
-                return ret;
-            }
-
-            /*
-             * 3. Set the previous entry `end` timestamp to the
-             * timestamp of the first event of the current packet.
-             */
-            prev_entry.timestamp_end = curr_entry.timestamp_begin;
-        }
-    }
-
-    return 0;
-}
-
 /*
  * When using the lttng-crash feature it's likely that the last packets of each
  * stream have their timestamp_end set to zero. This is caused by the fact that
@@ -1164,8 +1200,15 @@ static bool is_tracer_affected_by_lttng_crash_quirk(struct tracer_info *curr_tra
 }
 
 /*
- * Looks for trace produced by known buggy tracers and fix up the index
- * produced earlier.
+ * Looks for trace produced by known buggy tracers, enables the
+ * corresponding message iterator quirks, and fix up the index produced
+ * earlier where needed.
+ *
+ * The timestamps of the index entries are only used to compute the
+ * stream ranges of the `babeltrace.trace-infos` query (beginning time
+ * of the first packet and end time of the last packet of each stream
+ * file group): only fix-ups which may change those bounds decode
+ * packets, and only the last packet of a stream file group.
  */
 static int fix_packet_index_tracer_bugs(ctf_fs_component *ctf_fs)
 {
@@ -1200,14 +1243,23 @@ static int fix_packet_index_tracer_bugs(ctf_fs_component *ctf_fs)
     }
 
     if (is_tracer_affected_by_barectf_event_before_packet_bug(&current_tracer_info)) {
+        /*
+         * Some buggy barectf tracer versions (before barectf 2.3.1)
+         * may emit events with a timestamp that is less than the
+         * timestamp_begin of their packets.
+         *
+         * This only affects the beginning time of a packet which
+         * isn't the first one of its stream file, and the end time of
+         * the packet which precedes it: the beginning time of the
+         * first packet and the end time of the last packet, which
+         * are the only ones we use (`babeltrace.trace-infos` query),
+         * are always correct. Therefore, we don't fix up the index
+         * entries, which would require decoding the first event of
+         * each packet: the message iterator handles the quirk while
+         * decoding the packets.
+         */
         BT_CPPLOGI_SPEC(ctf_fs->logger,
-                        "Trace may be affected by barectf tracer packet timestamp bug. Fixing up.");
-        ret = fix_index_barectf_event_before_packet_bug(ctf_fs->trace.get(), ctf_fs->logger);
-        if (ret) {
-            BT_CPPLOGE_APPEND_CAUSE_SPEC(ctf_fs->logger,
-                                         "Failed to fix barectf event-before-packet bug.");
-            return ret;
-        }
+                        "Trace may be affected by barectf tracer packet timestamp bug.");
         ctf_fs->quirks.eventRecordDefClkValLtPktBeginDefClkVal = true;
     }
 
@@ -1255,14 +1307,61 @@ int ctf_fs_component_create_ctf_fs_trace(
 
     std::sort(paths.begin(), paths.end());
 
-    /* Create a separate ctf_fs_trace object for each path. */
+    /*
+     * Create a separate ctf_fs_trace object for each path.
+     *
+     * Parsing the metadata stream of a trace may create
+     * libbabeltrace2 objects, therefore it happens on the current
+     * thread, stopping at the first failing path. Creating the data
+     * stream file groups (indexing the data stream files) is what
+     * takes most of the time: it happens concurrently for the traces
+     * created so far.
+     */
     std::vector<ctf_fs_trace::UP> traces;
+    int metadataRet = 0;
+    std::exception_ptr metadataExc;
+
     for (const auto& path : paths) {
-        int ret = ctf_fs_component_create_ctf_fs_trace_one_path(ctf_fs, path.c_str(), traceName,
-                                                                traces, selfComp);
+        try {
+            metadataRet = ctf_fs_component_create_ctf_fs_trace_one_path(
+                ctf_fs, path.c_str(), traceName, traces, selfComp);
+        } catch (...) {
+            metadataExc = std::current_exception();
+        }
+
+        if (metadataRet || metadataExc) {
+            break;
+        }
+    }
+
+    {
+        /*
+         * Report a failure to create the data stream file groups of a
+         * trace before a failure to parse the metadata stream of a
+         * subsequent path, like when creating the traces in order.
+         */
+        bt2::UniqueConstError metadataError {nullptr};
+
+        if (metadataRet || metadataExc) {
+            metadataError = bt2::takeCurrentThreadError();
+        }
+
+        int ret = create_traces_ds_file_groups(ctf_fs, traces);
         if (ret) {
             return ret;
         }
+
+        if (metadataError) {
+            bt2::moveErrorToCurrentThread(std::move(metadataError));
+        }
+
+        if (metadataExc) {
+            std::rethrow_exception(metadataExc);
+        }
+
+        if (metadataRet) {
+            return metadataRet;
+        }
     }
 
     if (traces.size() > 1) {
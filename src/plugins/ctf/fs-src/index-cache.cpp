@@ -0,0 +1,216 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ */
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <sys/stat.h>
+
+#include "cpp-common/vendor/fmt/format.h"
+
+#include "index-cache.hpp"
+
+namespace {
+
+/* Maximum total size of the cached data stream file indexes (bytes) */
+constexpr std::size_t maxCachedIndexesSize = 16 * 1024 * 1024;
+
+/*
+ * Cached index.
+ *
+ * The `path` members of the index entries are the path of the data
+ * stream file when it was cached: ctf_fs_ds_index_cache_find() replaces
+ * them.
+ */
+struct CachedIndex final
+{
+    std::string key;
+    ctf_fs_ds_index index;
+};
+
+/* Least recently used first */
+using CachedIndexList = std::list<CachedIndex>;
+
+struct IndexCache final
+{
+    std::mutex mutex;
+    CachedIndexList list;
+    std::unordered_map<std::string, CachedIndexList::iterator> map;
+
+    /* Total size of the indexes of `list` (see cachedIndexSize()) */
+    std::size_t size = 0;
+};
+
+/*
+ * Returns the approximate memory footprint of `cachedIndex`, including
+ * its list node and its map entry.
+ */
+std::size_t cachedIndexSize(const CachedIndex& cachedIndex) noexcept
+{
+    return sizeof(CachedIndex) + 2 * cachedIndex.key.capacity() +
+           cachedIndex.index.entries.capacity() * sizeof(ctf_fs_ds_index_entry) +
+           sizeof(std::string) + sizeof(CachedIndexList::iterator) + 4 * sizeof(void *);
+}
+
+/*
+ * Removes the cached index at `it` from `cache`.
+ */
+void removeCachedIndex(IndexCache& cache, const CachedIndexList::iterator it)
+{
+    cache.size -= cachedIndexSize(*it);
+    cache.map.erase(it->key);
+    cache.list.erase(it);
+}
+
+IndexCache& indexCache()
+{
+    /* Never destroyed: avoids destruction order issues at exit */
+    static IndexCache * const cache = new IndexCache;
+
+    return *cache;
+}
+
+/*
+ * Returns the nanosecond part of the modification time of `st`.
+ */
+long mtimeNs(const struct stat& st) noexcept
+{
+#if defined(__APPLE__)
+    return st.st_mtimespec.tv_nsec;
+#elif defined(__MINGW32__)
+    /* No sub-second modification time */
+    (void) st;
+    return 0;
+#else
+    return st.st_mtim.tv_nsec;
+#endif
+}
+
+/*
+ * Appends the identity of the file `path` to `key`.
+ *
+ * Returns false if the file can't be stat'ed.
+ */
+bool appendFileIdentity(std::string& key, const std::string& path)
+{
+    struct stat st;
+
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+
+    /*
+     * Include the nanoseconds of the modification time: a file
+     * rewritten with the same size during the same second is still a
+     * different file.
+     */
+    key += fmt::format("{}:{}:{}:{}.{}/", static_cast<unsigned long long>(st.st_dev),
+                       static_cast<unsigned long long>(st.st_ino),
+                       static_cast<long long>(st.st_size), static_cast<long long>(st.st_mtime),
+                       mtimeNs(st));
+    return true;
+}
+
+/*
+ * Returns the cache key of the data stream file `fileInfo` described
+ * by the metadata file `metadataPath`, or `bt2s::nullopt` if either
+ * file can't be stat'ed.
+ */
+bt2s::optional<std::string> cacheKey(const ctf_fs_ds_file_info& fileInfo,
+                                     const std::string& metadataPath)
+{
+    std::string key;
+
+    if (!appendFileIdentity(key, fileInfo.path()) || !appendFileIdentity(key, metadataPath)) {
+        return bt2s::nullopt;
+    }
+
+    key += fileInfo.path();
+    return key;
+}
+
+} /* namespace */
+
+bt2s::optional<ctf_fs_ds_index> ctf_fs_ds_index_cache_find(const ctf_fs_ds_file_info& fileInfo,
+                                                           const std::string& metadataPath)
+{
+    const auto key = cacheKey(fileInfo, metadataPath);
+
+    if (!key) {
+        return bt2s::nullopt;
+    }
+
+    auto& cache = indexCache();
+    bt2s::optional<ctf_fs_ds_index> index;
+
+    {
+        std::lock_guard<std::mutex> lock {cache.mutex};
+        const auto it = cache.map.find(*key);
+
+        if (it == cache.map.end()) {
+            BT_CPPLOGD_SPEC(fileInfo.logger(), "No cached index for data stream file: path=\"{}\"",
+                            fileInfo.path());
+            return bt2s::nullopt;
+        }
+
+        /* Now the most recently used one */
+        cache.list.splice(cache.list.end(), cache.list, it->second);
+        index = it->second->index;
+    }
+
+    for (auto& entry : index->entries) {
+        entry.path = fileInfo.path().c_str();
+    }
+
+    BT_CPPLOGI_SPEC(fileInfo.logger(),
+                    "Using cached index of data stream file: path=\"{}\", entry-count={}",
+                    fileInfo.path(), index->entries.size());
+    return index;
+}
+
+void ctf_fs_ds_index_cache_add(const ctf_fs_ds_file_info& fileInfo,
+                               const std::string& metadataPath, const ctf_fs_ds_index& index)
+{
+    auto key = cacheKey(fileInfo, metadataPath);
+
+    if (!key) {
+        return;
+    }
+
+    CachedIndex cachedIndex {std::move(*key), index};
+    const auto size = cachedIndexSize(cachedIndex);
+
+    if (size > maxCachedIndexesSize) {
+        BT_CPPLOGD_SPEC(fileInfo.logger(),
+                        "Index of data stream file is too large to cache: path=\"{}\", size={}",
+                        fileInfo.path(), size);
+        return;
+    }
+
+    auto& cache = indexCache();
+    std::lock_guard<std::mutex> lock {cache.mutex};
+    const auto it = cache.map.find(cachedIndex.key);
+
+    if (it != cache.map.end()) {
+        /* Replace it */
+        removeCachedIndex(cache, it->second);
+    }
+
+    /* Evict the least recently used indexes to make room */
+    while (cache.size + size > maxCachedIndexesSize) {
+        removeCachedIndex(cache, cache.list.begin());
+    }
+
+    cache.list.push_back(std::move(cachedIndex));
+    cache.map.emplace(cache.list.back().key, std::prev(cache.list.end()));
+    cache.size += cachedIndexSize(cache.list.back());
+    BT_CPPLOGI_SPEC(fileInfo.logger(),
+                    "Cached index of data stream file: path=\"{}\", entry-count={}, "
+                    "cache-size={}",
+                    fileInfo.path(), index.entries.size(), cache.size);
+}
@@ -0,0 +1,56 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ */
+
+#ifndef BABELTRACE_PLUGINS_CTF_FS_SRC_INDEX_CACHE_HPP
+#define BABELTRACE_PLUGINS_CTF_FS_SRC_INDEX_CACHE_HPP
+
+#include <string>
+
+#include "cpp-common/bt2s/optional.hpp"
+
+#include "data-stream-file.hpp"
+
+/*
+ * Process-wide cache of data stream file indexes.
+ *
+ * The CLI runs a `babeltrace.trace-infos` query on a trace before
+ * instantiating a `source.ctf.fs` component on it (for example, with
+ * `--stream-intersection`). Both build the index of each data stream
+ * file: with this cache, the second one reuses the index of the first.
+ *
+ * The key of a cached index is the path of its data stream file as
+ * well as the identity (device, inode, size, and modification time
+ * with nanoseconds) of this file and of the metadata file which
+ * describes it, so that a cached index is never used for a modified
+ * trace.
+ *
+ * The total size of the cached indexes is bounded (16 MiB): the cache
+ * evicts the least recently used indexes to make room for a new one.
+ * This bounds the memory which the cache keeps for the lifetime of a
+ * long-running process (Python bindings, for example).
+ *
+ * Those functions are thread-safe.
+ */
+
+/*
+ * Returns a copy of the cached index of the data stream file
+ * `fileInfo`, described by the metadata file `metadataPath`, or
+ * `bt2s::nullopt` if there's none.
+ *
+ * The entries of the returned index refer to the path of `fileInfo`.
+ */
+bt2s::optional<ctf_fs_ds_index> ctf_fs_ds_index_cache_find(const ctf_fs_ds_file_info& fileInfo,
+                                                           const std::string& metadataPath);
+
+/*
+ * Adds a copy of `index`, the index of the data stream file
+ * `fileInfo` described by the metadata file `metadataPath`, to the
+ * cache.
+ */
+void ctf_fs_ds_index_cache_add(const ctf_fs_ds_file_info& fileInfo,
+                               const std::string& metadataPath, const ctf_fs_ds_index& index);
+
+#endif /* BABELTRACE_PLUGINS_CTF_FS_SRC_INDEX_CACHE_HPP */
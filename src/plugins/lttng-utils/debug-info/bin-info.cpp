@@ -106,6 +106,7 @@ void bin_info_destroy(struct bin_info *bin)
         return;
     }
 
+    bt_dwarf_addr_index_destroy(bin->dwarf_addr_index);
     dwarf_end(bin->dwarf_info);
 
     g_free(bin->debug_info_dir);
@@ -114,6 +115,14 @@ void bin_info_destroy(struct bin_info *bin)
     g_free(bin->build_id);
     g_free(bin->dbg_link_filename);
 
+    if (bin->elf_syms) {
+        g_array_free(bin->elf_syms, TRUE);
+    }
+
+    if (bin->elf_sym_names) {
+        g_string_free(bin->elf_sym_names, TRUE);
+    }
+
     elf_end(bin->elf_file);
 
     bt_fd_cache_put_handle(bin->fd_cache, bin->elf_handle);
@@ -686,6 +695,30 @@ end:
     return ret;
 }
 
+/**
+ * Get the DWARF address index of a given executable, building it if
+ * it doesn't exist yet.
+ *
+ * The DWARF info of the executable must be set.
+ *
+ * @param bin	bin_info instance
+ * @returns	The address index on success, `nullptr` on failure
+ */
+static struct bt_dwarf_addr_index *bin_info_get_dwarf_addr_index(struct bin_info *bin)
+{
+    BT_ASSERT(bin->dwarf_info);
+
+    if (!bin->dwarf_addr_index) {
+        bin->dwarf_addr_index = bt_dwarf_addr_index_create(bin->dwarf_info);
+        if (!bin->dwarf_addr_index) {
+            BT_COMP_LOGI("Failed to build DWARF address index: path=\"%s\"",
+                         bin->dwarf_path ? bin->dwarf_path : bin->elf_path);
+        }
+    }
+
+    return bin->dwarf_addr_index;
+}
+
 void source_location_destroy(struct source_location *src_loc)
 {
     if (!src_loc) {
@@ -737,257 +770,236 @@ error:
     return -1;
 }
 
-/**
- * Try to find the symbol closest to an address within a given ELF
- * section.
- *
- * Only function symbols are taken into account. The symbol's address
- * must precede `addr`. A symbol with a closer address might exist
- * after `addr` but is irrelevant because it cannot encompass `addr`.
- *
- * On success, if found, the out parameters `sym` and `shdr` are
- * set. On failure or if none are found, they remain unchanged.
- *
- * @param scn		ELF section in which to look for the address
- * @param addr		Virtual memory address for which to find the
- *			nearest function symbol
- * @param sym		Out parameter, the nearest function symbol
- * @param shdr		Out parameter, the section header for scn
- * @returns		0 on success, -1 on failure
+/*
+ * Function symbol of an ELF file.
  */
-static int bin_info_get_nearest_symbol_from_section(Elf_Scn *scn, uint64_t addr, GElf_Sym **sym,
-                                                    GElf_Shdr **shdr)
+struct bin_info_elf_sym
 {
-    int i;
-    size_t symbol_count;
-    Elf_Data *data = nullptr;
-    GElf_Shdr *_shdr = nullptr;
-    GElf_Sym *nearest_sym = nullptr;
+    uint64_t addr;
 
-    if (!scn || !sym || !shdr) {
-        goto error;
-    }
+    /* Offset of the name of this symbol within `bin_info::elf_sym_names` */
+    gsize name_offset;
+};
 
-    _shdr = g_new0(GElf_Shdr, 1);
-    if (!_shdr) {
-        goto error;
-    }
+static gint bin_info_elf_sym_compare(gconstpointer a, gconstpointer b)
+{
+    const struct bin_info_elf_sym *sym_a = (const struct bin_info_elf_sym *) a;
+    const struct bin_info_elf_sym *sym_b = (const struct bin_info_elf_sym *) b;
 
-    _shdr = gelf_getshdr(scn, _shdr);
-    if (!_shdr) {
-        goto error;
+    if (sym_a->addr != sym_b->addr) {
+        return sym_a->addr < sym_b->addr ? -1 : 1;
     }
 
-    if (_shdr->sh_type != SHT_SYMTAB) {
-        /*
-         * We are only interested in symbol table (symtab)
-         * sections, skip this one.
-         */
-        goto end;
+    /* Name offsets follow the order in which the symbols were added */
+    if (sym_a->name_offset != sym_b->name_offset) {
+        return sym_a->name_offset < sym_b->name_offset ? -1 : 1;
     }
 
-    data = elf_getdata(scn, nullptr);
-    if (!data) {
-        goto error;
-    }
+    return 0;
+}
 
-    symbol_count = _shdr->sh_size / _shdr->sh_entsize;
+/**
+ * Add the function symbols of all the sections of a given type of an
+ * executable's ELF file to its symbol array.
+ *
+ * @param bin		bin_info instance
+ * @param sh_type	Type of the sections (`SHT_SYMTAB` or `SHT_DYNSYM`)
+ * @returns		0 on success, -1 on failure
+ */
+static int bin_info_add_elf_syms(struct bin_info *bin, GElf_Word sh_type)
+{
+    Elf_Scn *scn = nullptr;
 
-    for (i = 0; i < symbol_count; ++i) {
-        GElf_Sym *cur_sym = nullptr;
+    while ((scn = elf_nextscn(bin->elf_file, scn))) {
+        GElf_Shdr shdr;
+        Elf_Data *data;
+        size_t symbol_count, i;
 
-        cur_sym = g_new0(GElf_Sym, 1);
-        if (!cur_sym) {
+        if (!gelf_getshdr(scn, &shdr)) {
             goto error;
         }
-        cur_sym = gelf_getsym(data, i, cur_sym);
-        if (!cur_sym) {
-            goto error;
-        }
-        if (GELF_ST_TYPE(cur_sym->st_info) != STT_FUNC) {
-            /* We're only interested in the functions. */
-            g_free(cur_sym);
+
+        if (shdr.sh_type != sh_type || shdr.sh_entsize == 0) {
             continue;
         }
 
-        if (cur_sym->st_value <= addr &&
-            (!nearest_sym || cur_sym->st_value > nearest_sym->st_value)) {
-            g_free(nearest_sym);
-            nearest_sym = cur_sym;
-        } else {
-            g_free(cur_sym);
+        data = elf_getdata(scn, nullptr);
+        if (!data) {
+            goto error;
         }
-    }
 
-end:
-    if (nearest_sym) {
-        *sym = nearest_sym;
-        *shdr = _shdr;
-    } else {
-        g_free(_shdr);
+        symbol_count = shdr.sh_size / shdr.sh_entsize;
+
+        for (i = 0; i < symbol_count; i++) {
+            struct bin_info_elf_sym elf_sym;
+            GElf_Sym sym;
+            const char *sym_name;
+
+            if (!gelf_getsym(data, i, &sym)) {
+                goto error;
+            }
+
+            if (GELF_ST_TYPE(sym.st_info) != STT_FUNC) {
+                /* We're only interested in the functions. */
+                continue;
+            }
+
+            if (sym.st_shndx == SHN_UNDEF || sym.st_value == 0) {
+                /*
+                 * Imported function (`.dynsym`): its address is 0 or
+                 * the one of its PLT entry, not the one of its code.
+                 */
+                continue;
+            }
+
+            sym_name = elf_strptr(bin->elf_file, shdr.sh_link, sym.st_name);
+            if (!sym_name) {
+                goto error;
+            }
+
+            elf_sym.addr = sym.st_value;
+            elf_sym.name_offset = bin->elf_sym_names->len;
+            g_string_append_len(bin->elf_sym_names, sym_name, strlen(sym_name) + 1);
+            g_array_append_val(bin->elf_syms, elf_sym);
+        }
     }
 
     return 0;
 
 error:
-    g_free(nearest_sym);
-    g_free(_shdr);
     return -1;
 }
 
 /**
- * Get the name of the function containing a given address within an
- * executable using ELF symbols.
+ * Build the address-sorted function symbol array of an executable's
+ * ELF file, if it's not built yet.
  *
- * The function name is in fact the name of the nearest ELF symbol,
- * followed by the offset in bytes between the address and the symbol
- * (in hex), separated by a '+' character.
+ * The symbols of the `.symtab` sections have precedence over the ones
+ * of the `.dynsym` sections at the same address. When there's no
+ * function symbol at all, the executable is flagged as stripped.
  *
- * If found, the out parameter `func_name` is set on success. On failure,
- * it remains unchanged.
- *
- * @param bin		bin_info instance for the executable containing
- *			the address
- * @param addr		Virtual memory address for which to find the
- *			function name
- * @param func_name	Out parameter, the function name
- * @returns		0 on success, -1 on failure
+ * @param bin	bin_info instance
+ * @returns	0 on success, -1 on failure
  */
-static int bin_info_lookup_elf_function_name(struct bin_info *bin, uint64_t addr, char **func_name)
+static int bin_info_set_elf_syms(struct bin_info *bin)
 {
-    /*
-     * TODO (possible optimisation): if an ELF has no symtab
-     * section, it has been stripped. Therefore, it would be wise
-     * to store a flag indicating the stripped status after the
-     * first iteration to prevent subsequent ones.
-     */
-    int ret = 0;
-    Elf_Scn *scn = nullptr;
-    GElf_Sym *sym = nullptr;
-    GElf_Shdr *shdr = nullptr;
-    char *sym_name = nullptr;
+    guint i, dst_index;
+
+    if (bin->has_elf_syms) {
+        return 0;
+    }
 
     /* Set ELF file if it hasn't been accessed yet. */
     if (!bin->elf_file) {
-        ret = bin_info_set_elf_file(bin);
-        if (ret) {
+        if (bin_info_set_elf_file(bin)) {
             /* Failed to set ELF file. */
             goto error;
         }
     }
 
-    scn = elf_nextscn(bin->elf_file, scn);
-    if (!scn) {
+    bin->elf_syms = g_array_new(FALSE, FALSE, sizeof(struct bin_info_elf_sym));
+    if (!bin->elf_syms) {
         goto error;
     }
 
-    while (scn && !sym) {
-        ret = bin_info_get_nearest_symbol_from_section(scn, addr, &sym, &shdr);
-        if (ret) {
-            goto error;
-        }
+    bin->elf_sym_names = g_string_new(nullptr);
+    if (!bin->elf_sym_names) {
+        goto error;
+    }
 
-        scn = elf_nextscn(bin->elf_file, scn);
+    if (bin_info_add_elf_syms(bin, SHT_SYMTAB) || bin_info_add_elf_syms(bin, SHT_DYNSYM)) {
+        goto error;
     }
 
-    if (sym) {
-        sym_name = elf_strptr(bin->elf_file, shdr->sh_link, sym->st_name);
-        if (!sym_name) {
-            goto error;
-        }
+    /* Sort by address and only keep the first symbol at each address */
+    g_array_sort(bin->elf_syms, bin_info_elf_sym_compare);
 
-        ret = bin_info_append_offset_str(sym_name, sym->st_value, addr, func_name);
-        if (ret) {
-            goto error;
+    for (i = 0, dst_index = 0; i < bin->elf_syms->len; i++) {
+        const struct bin_info_elf_sym elf_sym =
+            g_array_index(bin->elf_syms, struct bin_info_elf_sym, i);
+
+        if (dst_index > 0 &&
+            g_array_index(bin->elf_syms, struct bin_info_elf_sym, dst_index - 1).addr ==
+                elf_sym.addr) {
+            continue;
         }
+
+        g_array_index(bin->elf_syms, struct bin_info_elf_sym, dst_index) = elf_sym;
+        dst_index++;
     }
 
-    g_free(shdr);
-    g_free(sym);
+    g_array_set_size(bin->elf_syms, dst_index);
+    bin->is_stripped = bin->elf_syms->len == 0;
+    bin->has_elf_syms = true;
     return 0;
 
 error:
-    g_free(shdr);
-    g_free(sym);
-    return ret;
+    if (bin->elf_syms) {
+        g_array_free(bin->elf_syms, TRUE);
+        bin->elf_syms = nullptr;
+    }
+
+    if (bin->elf_sym_names) {
+        g_string_free(bin->elf_sym_names, TRUE);
+        bin->elf_sym_names = nullptr;
+    }
+
+    return -1;
 }
 
 /**
- * Get the name of the function containing a given address within a
- * given compile unit (CU).
+ * Get the name of the function containing a given address within an
+ * executable using ELF symbols.
  *
- * If found, the out parameter `func_name` is set on success. On
- * failure, it remains unchanged.
+ * The function name is in fact the name of the nearest ELF function
+ * symbol of which the address precedes `addr`, followed by the offset
+ * in bytes between the address and the symbol (in hex), separated by
+ * a '+' character.
  *
- * @param cu		bt_dwarf_cu instance which may contain the address
+ * If found, the out parameter `func_name` is set on success. On failure,
+ * it remains unchanged.
+ *
+ * @param bin		bin_info instance for the executable containing
+ *			the address
  * @param addr		Virtual memory address for which to find the
  *			function name
  * @param func_name	Out parameter, the function name
  * @returns		0 on success, -1 on failure
  */
-static int bin_info_lookup_cu_function_name(struct bt_dwarf_cu *cu, uint64_t addr, char **func_name)
+static int bin_info_lookup_elf_function_name(struct bin_info *bin, uint64_t addr, char **func_name)
 {
-    int ret = 0;
-    bool found = false;
-    struct bt_dwarf_die *die = nullptr;
+    const struct bin_info_elf_sym *elf_sym;
+    guint low = 0, high;
 
-    if (!cu || !func_name) {
-        goto error;
+    if (bin_info_set_elf_syms(bin)) {
+        return -1;
     }
 
-    die = bt_dwarf_die_create(cu);
-    if (!die) {
-        goto error;
+    if (bin->is_stripped) {
+        return 0;
     }
 
-    while (bt_dwarf_die_next(die) == 0) {
-        int tag;
+    /* Find the first symbol of which the address is greater than addr */
+    high = bin->elf_syms->len;
 
-        ret = bt_dwarf_die_get_tag(die, &tag);
-        if (ret) {
-            goto error;
-        }
-
-        if (tag == DW_TAG_subprogram) {
-            ret = bt_dwarf_die_contains_addr(die, addr, &found);
-            if (ret) {
-                goto error;
-            }
+    while (low < high) {
+        const guint mid = low + (high - low) / 2;
 
-            if (found) {
-                break;
-            }
+        if (g_array_index(bin->elf_syms, struct bin_info_elf_sym, mid).addr <= addr) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
     }
 
-    if (found) {
-        uint64_t low_addr = 0;
-        char *die_name = nullptr;
-
-        ret = bt_dwarf_die_get_name(die, &die_name);
-        if (ret) {
-            goto error;
-        }
-
-        ret = dwarf_lowpc(die->dwarf_die, &low_addr);
-        if (ret) {
-            free(die_name);
-            goto error;
-        }
-
-        ret = bin_info_append_offset_str(die_name, low_addr, addr, func_name);
-        free(die_name);
-        if (ret) {
-            goto error;
-        }
+    if (low == 0) {
+        /* All the symbols follow addr */
+        return 0;
     }
 
-    bt_dwarf_die_destroy(die);
-    return 0;
-
-error:
-    bt_dwarf_die_destroy(die);
-    return -1;
+    elf_sym = &g_array_index(bin->elf_syms, struct bin_info_elf_sym, low - 1);
+    return bin_info_append_offset_str(&bin->elf_sym_names->str[elf_sym->name_offset],
+                                      elf_sym->addr, addr, func_name);
 }
 
 /**
@@ -1008,39 +1020,55 @@ static int bin_info_lookup_dwarf_function_name(struct bin_info *bin, uint64_t ad
                                                char **func_name)
 {
     int ret = 0;
-    char *_func_name = nullptr;
+    uint64_t low_addr = 0;
+    char *die_name = nullptr;
+    struct bt_dwarf_addr_index *addr_index;
     struct bt_dwarf_cu *cu = nullptr;
+    struct bt_dwarf_die *die = nullptr;
 
     if (!bin || !func_name) {
         goto error;
     }
 
+    addr_index = bin_info_get_dwarf_addr_index(bin);
+    if (!addr_index) {
+        goto error;
+    }
+
     cu = bt_dwarf_cu_create(bin->dwarf_info);
     if (!cu) {
         goto error;
     }
 
-    while (bt_dwarf_cu_next(cu) == 0) {
-        ret = bin_info_lookup_cu_function_name(cu, addr, &_func_name);
-        if (ret) {
-            goto error;
-        }
+    ret = bt_dwarf_addr_index_find_func_die(addr_index, addr, -1, cu, &die);
+    if (ret) {
+        /* Error or not found */
+        goto error;
+    }
 
-        if (_func_name) {
-            break;
-        }
+    ret = bt_dwarf_die_get_name(die, &die_name);
+    if (ret) {
+        goto error;
     }
 
-    if (_func_name) {
-        *func_name = _func_name;
-    } else {
+    ret = dwarf_lowpc(die->dwarf_die, &low_addr);
+    if (ret) {
         goto error;
     }
 
+    ret = bin_info_append_offset_str(die_name, low_addr, addr, func_name);
+    if (ret) {
+        goto error;
+    }
+
+    free(die_name);
+    bt_dwarf_die_destroy(die);
     bt_dwarf_cu_destroy(cu);
     return 0;
 
 error:
+    free(die_name);
+    bt_dwarf_die_destroy(die);
     bt_dwarf_cu_destroy(cu);
     return -1;
 }
@@ -1229,13 +1257,16 @@ error:
  * the assumption that it is contained within an inline routine in a
  * function.
  *
+ * @param addr_index	DWARF address index of the executable
+ * @param cu_index	Index of the CU within `addr_index`
  * @param cu		bt_dwarf_cu instance in which to look for the address
  * @param addr		The address for which to look for
  * @param src_loc	Out parameter, the source location (filename and
  *			line number) for the address
  * @returns		0 on success, -1 on failure
  */
-static int bin_info_lookup_cu_src_loc_inl(struct bt_dwarf_cu *cu, uint64_t addr,
+static int bin_info_lookup_cu_src_loc_inl(struct bt_dwarf_addr_index *addr_index, guint cu_index,
+                                          struct bt_dwarf_cu *cu, uint64_t addr,
                                           struct source_location **src_loc)
 {
     int ret = 0;
@@ -1247,43 +1278,21 @@ static int bin_info_lookup_cu_src_loc_inl(struct bt_dwarf_cu *cu, uint64_t addr,
         goto error;
     }
 
-    die = bt_dwarf_die_create(cu);
-    if (!die) {
+    /* Find the first function of this CU containing addr */
+    ret = bt_dwarf_addr_index_find_func_die(addr_index, addr, cu_index, cu, &die);
+    if (ret < 0) {
         goto error;
-    }
-
-    while (bt_dwarf_die_next(die) == 0) {
-        int tag;
-
-        ret = bt_dwarf_die_get_tag(die, &tag);
+    } else if (ret == 0) {
+        /*
+         * Try to find an inlined subroutine child of this DIE
+         * containing addr.
+         */
+        ret = bin_info_child_die_has_address(die, addr, &found);
         if (ret) {
             goto error;
         }
-
-        if (tag == DW_TAG_subprogram) {
-            bool contains = false;
-
-            ret = bt_dwarf_die_contains_addr(die, addr, &contains);
-            if (ret) {
-                goto error;
-            }
-
-            if (contains) {
-                /*
-                 * Try to find an inlined subroutine
-                 * child of this DIE containing addr.
-                 */
-                ret = bin_info_child_die_has_address(die, addr, &found);
-                if (ret) {
-                    goto error;
-                }
-
-                goto end;
-            }
-        }
     }
 
-end:
     if (found) {
         char *filename = nullptr;
         uint64_t line_no;
@@ -1405,6 +1414,8 @@ end:
  * On success, the out parameter `src_loc` is set if found. On
  * failure, it remains unchanged.
  *
+ * @param addr_index	DWARF address index of the executable
+ * @param cu_index	Index of the CU within `addr_index`
  * @param cu		bt_dwarf_cu instance for the compile unit which
  *			may contain the address
  * @param addr		Virtual memory address for which to find the
@@ -1412,7 +1423,8 @@ end:
  * @param src_loc	Out parameter, the source location
  * @returns		0 on success, -1 on failure
  */
-static int bin_info_lookup_cu_src_loc(struct bt_dwarf_cu *cu, uint64_t addr,
+static int bin_info_lookup_cu_src_loc(struct bt_dwarf_addr_index *addr_index, guint cu_index,
+                                      struct bt_dwarf_cu *cu, uint64_t addr,
                                       struct source_location **src_loc)
 {
     int ret = 0;
@@ -1422,7 +1434,7 @@ static int bin_info_lookup_cu_src_loc(struct bt_dwarf_cu *cu, uint64_t addr,
         goto error;
     }
 
-    ret = bin_info_lookup_cu_src_loc_inl(cu, addr, &_src_loc);
+    ret = bin_info_lookup_cu_src_loc_inl(addr_index, cu_index, cu, addr, &_src_loc);
     if (ret) {
         goto error;
     }
@@ -1455,8 +1467,11 @@ error:
 int bin_info_lookup_source_location(struct bin_info *bin, uint64_t addr,
                                     struct source_location **src_loc)
 {
+    struct bt_dwarf_addr_index *addr_index;
     struct bt_dwarf_cu *cu = nullptr;
     struct source_location *_src_loc = nullptr;
+    GArray *cu_indexes = nullptr;
+    guint i;
 
     if (!bin || !src_loc) {
         goto error;
@@ -1495,15 +1510,30 @@ int bin_info_lookup_source_location(struct bin_info *bin, uint64_t addr,
         addr -= bin->low_addr;
     }
 
+    addr_index = bin_info_get_dwarf_addr_index(bin);
+    if (!addr_index) {
+        goto error;
+    }
+
     cu = bt_dwarf_cu_create(bin->dwarf_info);
     if (!cu) {
         goto error;
     }
 
-    while (bt_dwarf_cu_next(cu) == 0) {
+    /* Only look into the CUs which may contain addr, in CU order */
+    cu_indexes = g_array_new(FALSE, FALSE, sizeof(guint));
+    if (!cu_indexes) {
+        goto error;
+    }
+
+    bt_dwarf_addr_index_get_cus(addr_index, addr, cu_indexes);
+
+    for (i = 0; i < cu_indexes->len; i++) {
+        const guint cu_index = g_array_index(cu_indexes, guint, i);
         int ret;
 
-        ret = bin_info_lookup_cu_src_loc(cu, addr, &_src_loc);
+        bt_dwarf_addr_index_set_cu(addr_index, cu_index, cu);
+        ret = bin_info_lookup_cu_src_loc(addr_index, cu_index, cu, addr, &_src_loc);
         if (ret) {
             goto error;
         }
@@ -1513,6 +1543,7 @@ int bin_info_lookup_source_location(struct bin_info *bin, uint64_t addr,
         }
     }
 
+    g_array_free(cu_indexes, TRUE);
     bt_dwarf_cu_destroy(cu);
     if (_src_loc) {
         *src_loc = _src_loc;
@@ -1521,6 +1552,10 @@ int bin_info_lookup_source_location(struct bin_info *bin, uint64_t addr,
     return 0;
 
 error:
+    if (cu_indexes) {
+        g_array_free(cu_indexes, TRUE);
+    }
+
     source_location_destroy(_src_loc);
     bt_dwarf_cu_destroy(cu);
     return -1;
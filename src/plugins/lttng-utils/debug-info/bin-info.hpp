@@ -43,6 +43,19 @@ struct bin_info
     /* libelf and libdw objects representing the files. */
     Elf *elf_file;
     Dwarf *dwarf_info;
+    /*
+     * Address index of `dwarf_info`, built on the first DWARF
+     * lookup (owned by this).
+     */
+    struct bt_dwarf_addr_index *dwarf_addr_index;
+    /*
+     * Function symbols of `elf_file` (`struct bin_info_elf_sym`),
+     * from its `.symtab` and `.dynsym` sections, sorted by address,
+     * built on the first ELF lookup.
+     */
+    GArray *elf_syms;
+    /* Null-terminated names of the symbols of `elf_syms`. */
+    GString *elf_sym_names;
     /* Optional build ID info. */
     uint8_t *build_id;
     size_t build_id_len;
@@ -64,6 +77,13 @@ struct bin_info
      * DWARF info.
      */
     bool is_elf_only : 1;
+    /* Denotes whether `elf_syms` is built. */
+    bool has_elf_syms : 1;
+    /*
+     * Denotes whether the ELF file has no function symbol, that is,
+     * it has been stripped.
+     */
+    bool is_stripped : 1;
     /* Weak ref. Owned by the iterator. */
     struct bt_fd_cache *fd_cache;
 };
@@ -81,7 +81,8 @@ static const uint32_t crctab[256] = {
 
 int crc32(int fd, uint32_t *crc)
 {
-	int nr;
+	ssize_t nr;
+	off_t offset = 0;
 	uint32_t _crc = ~0;
 	char buf[BUFSIZ], *p;
 
@@ -89,7 +90,14 @@ int crc32(int fd, uint32_t *crc)
 		goto error;
 	}
 
-	while ((nr = read(fd, buf, sizeof(buf))) > 0) {
+	/*
+	 * Use pread() so that the result doesn't depend on, and doesn't
+	 * change, the current offset of `fd`, which the file descriptor
+	 * cache may share.
+	 */
+	while ((nr = pread(fd, buf, sizeof(buf), offset)) > 0) {
+		offset += nr;
+
 		for (p = buf; nr--; ++p) {
 			CRC(_crc, *p);
 		}
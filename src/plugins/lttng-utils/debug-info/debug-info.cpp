@@ -20,12 +20,16 @@
 
 #include "common/assert.h"
 #include "common/common.h"
+#include "compat/glib.h"
 #include "fd-cache/fd-cache.hpp"
 
 #include "plugins/common/param-validation/param-validation.h"
 
 #include "bin-info.hpp"
 #include "debug-info.hpp"
+#include "ip-cache.hpp"
+#include "sym-cache.hpp"
+#include "sym-workers.hpp"
 #include "trace-ir-data-copy.hpp"
 #include "trace-ir-mapping.hpp"
 #include "utils.hpp"
@@ -33,6 +37,21 @@
 #define DEFAULT_DEBUG_INFO_FIELD_NAME "debug_info"
 #define LTTNG_UST_STATEDUMP_PREFIX    "lttng_ust"
 
+/*
+ * Maximum number of (VPID, IP) to debug info source entries which a
+ * debug info instance caches.
+ */
+#define IP_CACHE_CAPACITY 16384
+
+/*
+ * Number of input messages which a debug info message iterator having
+ * symbolization worker threads reads ahead of the messages it returns.
+ */
+#define PREFETCH_WINDOW_SIZE 1024
+
+/* Maximum value of the `symbolization-threads` parameter */
+#define MAX_SYMBOLIZATION_THREADS 256
+
 struct debug_info_component
 {
     bt_logging_level log_level;
@@ -42,6 +61,10 @@ struct debug_info_component
     gchar *arg_debug_info_field_name;
     gchar *arg_target_prefix;
     bt_bool arg_full_path;
+    unsigned int arg_symbolization_threads;
+
+    /* Persistent symbolization cache, or `nullptr` if disabled */
+    struct sym_cache *sym_cache;
 };
 
 struct debug_info_msg_iter
@@ -57,6 +80,48 @@ struct debug_info_msg_iter
     GHashTable *debug_info_map;
 
     struct bt_fd_cache fd_cache;
+
+    /*
+     * Symbolization worker threads, or `nullptr` if the component
+     * has none.
+     *
+     * The members below are only used with worker threads.
+     */
+    struct sym_workers *sym_workers;
+
+    /*
+     * Input messages which this iterator got from upstream, but didn't
+     * handle yet, in order (owned by this).
+     */
+    GPtrArray *window_msgs;
+
+    /*
+     * Number of messages at the beginning of `window_msgs` which this
+     * iterator already considered for prefetching.
+     */
+    guint window_prefetched_count;
+
+    /* Submitted prefetch jobs (`struct debug_info_prefetch_job *`) */
+    GPtrArray *prefetch_jobs;
+
+    /*
+     * Bin info or symbolization cache file to prefetch job of
+     * `prefetch_jobs` which isn't submitted yet.
+     */
+    GHashTable *prefetch_job_map;
+
+    /* Set of submitted `struct debug_info_prefetch_key` (owned) */
+    GHashTable *prefetch_keys;
+
+    /*
+     * True if the upstream message iterator ended or failed:
+     * `upstream_status` is the status it returned, and
+     * `upstream_error` its error, if any, which this iterator returns
+     * once it handled `window_msgs`.
+     */
+    bool upstream_done;
+    bt_message_iterator_next_status upstream_status;
+    const bt_error *upstream_error;
 };
 
 struct debug_info_source
@@ -81,6 +146,71 @@ struct debug_info_source
     gchar *bin_loc;
 };
 
+/*
+ * Address range of a bin info within the address space of a process.
+ */
+struct bin_addr_range
+{
+    uint64_t low_addr;
+    uint64_t high_addr;
+
+    /*
+     * Maximum `high_addr` of this range and of all the preceding
+     * ranges of the array: a lookup stops scanning backward as soon as
+     * this is less than or equal to the searched address.
+     */
+    uint64_t max_high_addr;
+
+    /* Weak: owned by `baddr_to_bin_info` */
+    struct bin_info *bin;
+};
+
+/*
+ * Debug info source which a symbolization worker thread looks up
+ * ahead of the message iterator.
+ */
+struct debug_info_prefetch_item
+{
+    /* Weak */
+    struct debug_info *debug_info;
+
+    int64_t vpid;
+    uint64_t ip;
+
+    /* Weak: bin info containing `ip` */
+    struct bin_info *bin;
+
+    /* Weak: symbolization cache file of `bin`, or `nullptr` */
+    struct sym_cache_file *sym_cache_file;
+
+    /* Result, or `nullptr` if not found (owned by this) */
+    struct debug_info_source *dbg_info_src;
+};
+
+/*
+ * Prefetch items which a single worker thread looks up.
+ *
+ * All the items having the same bin info, or the same symbolization
+ * cache file, belong to the same job so that concurrent jobs never
+ * access the same object.
+ */
+struct debug_info_prefetch_job
+{
+    bt_self_component *self_comp;
+
+    /* Array of `struct debug_info_prefetch_item` */
+    GArray *items;
+};
+
+struct debug_info_prefetch_key
+{
+    /* Weak */
+    struct debug_info *debug_info;
+
+    int64_t vpid;
+    uint64_t ip;
+};
+
 struct proc_debug_info_sources
 {
     /*
@@ -90,10 +220,10 @@ struct proc_debug_info_sources
     GHashTable *baddr_to_bin_info;
 
     /*
-     * Hash table: IP (pointer to uint64_t) to (struct debug_info_source *);
-     * owned by proc_debug_info_sources.
+     * Array of `struct bin_addr_range`, sorted by low address, with
+     * one entry per bin info of `baddr_to_bin_info`.
      */
-    GHashTable *ip_to_debug_info_src;
+    GArray *bin_addr_ranges;
 };
 
 struct debug_info
@@ -109,6 +239,12 @@ struct debug_info
      * (struct proc_debug_info_sources*); owned by debug_info.
      */
     GHashTable *vpid_to_proc_dbg_info_src;
+
+    /*
+     * Cache of (VPID, IP) to (struct debug_info_source *); owned by
+     * debug_info.
+     */
+    struct ip_cache *ip_cache;
     GQuark q_statedump_bin_info;
     GQuark q_statedump_debug_link;
     GQuark q_statedump_build_id;
@@ -146,21 +282,62 @@ static void debug_info_source_destroy(struct debug_info_source *debug_info_src)
     g_free(debug_info_src);
 }
 
-static struct debug_info_source *
-debug_info_source_create_from_bin(struct bin_info *bin, uint64_t ip, bt_self_component *self_comp)
+static int debug_info_source_set_src_loc(struct debug_info_source *debug_info_src,
+                                         uint64_t line_no, const char *filename,
+                                         bt_logging_level log_level, bt_self_component *self_comp)
 {
-    int ret;
-    struct debug_info_source *debug_info_src = nullptr;
-    struct source_location *src_loc = nullptr;
-    bt_logging_level log_level;
+    debug_info_src->line_no = g_strdup_printf("%" PRId64, line_no);
+    if (!debug_info_src->line_no) {
+        BT_COMP_LOGE_APPEND_CAUSE(self_comp, "Error occurred when setting `line_no` field.");
+        return -1;
+    }
 
-    BT_ASSERT(bin);
+    if (filename) {
+        debug_info_src->src_path = g_strdup(filename);
+        if (!debug_info_src->src_path) {
+            return -1;
+        }
 
-    log_level = bin->log_level;
+        debug_info_src->short_src_path = get_filename_from_path(debug_info_src->src_path);
+    }
 
-    debug_info_src = g_new0(struct debug_info_source, 1);
+    return 0;
+}
+
+/*
+ * Looks up the function name and the source location of `ip` within
+ * `bin`, first in `sym_cache_file` (if not `nullptr`), and then with
+ * the ELF/DWARF information of `bin`, adding the result to
+ * `sym_cache_file`.
+ */
+static int debug_info_source_lookup_bin(struct debug_info_source *debug_info_src,
+                                        struct bin_info *bin, uint64_t ip,
+                                        struct sym_cache_file *sym_cache_file,
+                                        bt_self_component *self_comp)
+{
+    int ret;
+    struct source_location *src_loc = nullptr;
+    struct sym_cache_result cache_result = {};
+    const uint64_t offset = ip - bin->low_addr;
+    bt_logging_level log_level = bin->log_level;
+
+    if (sym_cache_file && sym_cache_file_lookup(sym_cache_file, offset, &cache_result)) {
+        /* Cached: don't even open the ELF and DWARF files */
+        if (cache_result.func) {
+            debug_info_src->func = g_strdup(cache_result.func);
+            if (!debug_info_src->func) {
+                goto error;
+            }
+        }
+
+        if (cache_result.has_src_loc) {
+            ret = debug_info_source_set_src_loc(debug_info_src, cache_result.line_no,
+                                                cache_result.src_path, log_level, self_comp);
+            if (ret) {
+                goto error;
+            }
+        }
 
-    if (!debug_info_src) {
         goto end;
     }
 
@@ -180,21 +357,56 @@ debug_info_source_create_from_bin(struct bin_info *bin, uint64_t ip, bt_self_com
     }
 
     if (src_loc) {
-        debug_info_src->line_no = g_strdup_printf("%" PRId64, src_loc->line_no);
-        if (!debug_info_src->line_no) {
-            BT_COMP_LOGE_APPEND_CAUSE(self_comp, "Error occurred when setting `line_no` field.");
+        ret = debug_info_source_set_src_loc(debug_info_src, src_loc->line_no, src_loc->filename,
+                                            log_level, self_comp);
+        if (ret) {
             goto error;
         }
+    }
 
-        if (src_loc->filename) {
-            debug_info_src->src_path = g_strdup(src_loc->filename);
-            if (!debug_info_src->src_path) {
-                goto error;
-            }
+    if (sym_cache_file) {
+        cache_result.func = debug_info_src->func;
+        cache_result.has_src_loc = src_loc;
+        cache_result.src_path = src_loc ? src_loc->filename : nullptr;
+        cache_result.line_no = src_loc ? src_loc->line_no : 0;
+        sym_cache_file_add(sym_cache_file, offset, &cache_result);
+    }
 
-            debug_info_src->short_src_path = get_filename_from_path(debug_info_src->src_path);
-        }
-        source_location_destroy(src_loc);
+end:
+    source_location_destroy(src_loc);
+    return 0;
+
+error:
+    source_location_destroy(src_loc);
+    return -1;
+}
+
+/*
+ * Creates the debug info source of `ip` within `bin`, using the
+ * symbolization cache file `sym_cache_file` if not `nullptr`.
+ *
+ * Only accesses `bin` and `sym_cache_file`: a symbolization worker
+ * thread may call this function.
+ */
+static struct debug_info_source *
+debug_info_source_create_from_bin(struct bin_info *bin, uint64_t ip,
+                                  struct sym_cache_file *sym_cache_file,
+                                  bt_self_component *self_comp)
+{
+    int ret;
+    struct debug_info_source *debug_info_src = nullptr;
+
+    BT_ASSERT(bin);
+
+    debug_info_src = g_new0(struct debug_info_source, 1);
+
+    if (!debug_info_src) {
+        goto end;
+    }
+
+    ret = debug_info_source_lookup_bin(debug_info_src, bin, ip, sym_cache_file, self_comp);
+    if (ret) {
+        goto error;
     }
 
     if (bin->elf_path) {
@@ -225,12 +437,12 @@ static void proc_debug_info_sources_destroy(struct proc_debug_info_sources *proc
         return;
     }
 
-    if (proc_dbg_info_src->baddr_to_bin_info) {
-        g_hash_table_destroy(proc_dbg_info_src->baddr_to_bin_info);
+    if (proc_dbg_info_src->bin_addr_ranges) {
+        g_array_free(proc_dbg_info_src->bin_addr_ranges, TRUE);
     }
 
-    if (proc_dbg_info_src->ip_to_debug_info_src) {
-        g_hash_table_destroy(proc_dbg_info_src->ip_to_debug_info_src);
+    if (proc_dbg_info_src->baddr_to_bin_info) {
+        g_hash_table_destroy(proc_dbg_info_src->baddr_to_bin_info);
     }
 
     g_free(proc_dbg_info_src);
@@ -251,10 +463,8 @@ static struct proc_debug_info_sources *proc_debug_info_sources_create(void)
         goto error;
     }
 
-    proc_dbg_info_src->ip_to_debug_info_src =
-        g_hash_table_new_full(g_int64_hash, g_int64_equal, (GDestroyNotify) g_free,
-                              (GDestroyNotify) debug_info_source_destroy);
-    if (!proc_dbg_info_src->ip_to_debug_info_src) {
+    proc_dbg_info_src->bin_addr_ranges = g_array_new(FALSE, FALSE, sizeof(struct bin_addr_range));
+    if (!proc_dbg_info_src->bin_addr_ranges) {
         goto error;
     }
 
@@ -266,25 +476,134 @@ error:
     return nullptr;
 }
 
-static struct proc_debug_info_sources *proc_debug_info_sources_ht_get_entry(GHashTable *ht,
-                                                                            int64_t vpid)
+/*
+ * Returns the index of the first range of `ranges` of which the low
+ * address is greater than `addr`.
+ */
+static guint bin_addr_ranges_upper_bound(GArray *ranges, uint64_t addr)
 {
-    gpointer key = g_new0(int64_t, 1);
-    struct proc_debug_info_sources *proc_dbg_info_src = nullptr;
+    guint low = 0;
+    guint high = ranges->len;
 
-    if (!key) {
-        goto end;
+    while (low < high) {
+        const guint mid = low + (high - low) / 2;
+
+        if (bt_g_array_index(ranges, struct bin_addr_range, mid).low_addr <= addr) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
 
-    *((int64_t *) key) = vpid;
+    return low;
+}
+
+/*
+ * Updates the `max_high_addr` member of the ranges of `ranges` from the
+ * index `index`.
+ */
+static void bin_addr_ranges_update_max_high_addrs(GArray *ranges, guint index)
+{
+    uint64_t max_high_addr =
+        index == 0 ? 0 : bt_g_array_index(ranges, struct bin_addr_range, index - 1).max_high_addr;
+
+    for (guint i = index; i < ranges->len; i++) {
+        struct bin_addr_range *range = &bt_g_array_index(ranges, struct bin_addr_range, i);
+
+        max_high_addr = MAX(max_high_addr, range->high_addr);
+        range->max_high_addr = max_high_addr;
+    }
+}
+
+static void
+proc_debug_info_sources_add_bin_addr_range(struct proc_debug_info_sources *proc_dbg_info_src,
+                                           struct bin_info *bin)
+{
+    GArray *ranges = proc_dbg_info_src->bin_addr_ranges;
+    const guint index = bin_addr_ranges_upper_bound(ranges, bin->low_addr);
+    struct bin_addr_range range = {};
+
+    range.low_addr = bin->low_addr;
+    range.high_addr = bin->high_addr;
+    range.bin = bin;
+    g_array_insert_val(ranges, index, range);
+    bin_addr_ranges_update_max_high_addrs(ranges, index);
+}
+
+static void
+proc_debug_info_sources_remove_bin_addr_range(struct proc_debug_info_sources *proc_dbg_info_src,
+                                              struct bin_info *bin)
+{
+    GArray *ranges = proc_dbg_info_src->bin_addr_ranges;
+    guint index = bin_addr_ranges_upper_bound(ranges, bin->low_addr);
+
+    /* Find `bin` amongst the ranges having the same low address */
+    while (index > 0) {
+        index--;
+
+        if (bt_g_array_index(ranges, struct bin_addr_range, index).bin == bin) {
+            g_array_remove_index(ranges, index);
+            bin_addr_ranges_update_max_high_addrs(ranges, index);
+            return;
+        }
+    }
+
+    bt_common_abort();
+}
+
+/*
+ * Returns the bin info of `proc_dbg_info_src` which contains the
+ * address `ip`, or `nullptr` if none.
+ *
+ * The mappings of a process don't overlap, so this is a binary search
+ * followed by a single range check; with overlapping ranges, this
+ * function returns the matching range having the greatest low address.
+ */
+static struct bin_info *
+proc_debug_info_sources_find_bin(struct proc_debug_info_sources *proc_dbg_info_src, uint64_t ip)
+{
+    GArray *ranges = proc_dbg_info_src->bin_addr_ranges;
+    guint index = bin_addr_ranges_upper_bound(ranges, ip);
+
+    while (index > 0) {
+        const struct bin_addr_range *range =
+            &bt_g_array_index(ranges, struct bin_addr_range, index - 1);
+
+        if (range->max_high_addr <= ip) {
+            /* No preceding range can contain `ip` */
+            break;
+        }
+
+        if (ip < range->high_addr) {
+            BT_ASSERT_DBG(bin_info_has_address(range->bin, ip));
+            return range->bin;
+        }
+
+        index--;
+    }
+
+    return nullptr;
+}
+
+static struct proc_debug_info_sources *proc_debug_info_sources_ht_get_entry(GHashTable *ht,
+                                                                            int64_t vpid)
+{
+    gpointer key = nullptr;
+    struct proc_debug_info_sources *proc_dbg_info_src = nullptr;
 
     /* Exists? Return it */
-    proc_dbg_info_src = static_cast<proc_debug_info_sources *>(g_hash_table_lookup(ht, key));
+    proc_dbg_info_src = static_cast<proc_debug_info_sources *>(g_hash_table_lookup(ht, &vpid));
     if (proc_dbg_info_src) {
         goto end;
     }
 
     /* Otherwise, create and return it */
+    key = g_new0(int64_t, 1);
+    if (!key) {
+        goto end;
+    }
+
+    *((int64_t *) key) = vpid;
     proc_dbg_info_src = proc_debug_info_sources_create();
     if (!proc_dbg_info_src) {
         goto end;
@@ -401,60 +720,41 @@ proc_debug_info_sources_get_entry(struct debug_info *debug_info,
                                   struct proc_debug_info_sources *proc_dbg_info_src, uint64_t ip)
 {
     struct debug_info_source *debug_info_src = nullptr;
-    gpointer key = g_new0(uint64_t, 1);
-    GHashTableIter iter;
-    gpointer baddr, value;
-
-    if (!key) {
-        goto end;
-    }
-
-    *((uint64_t *) key) = ip;
+    struct bin_info *bin;
 
-    /* Look in IP to debug infos hash table first. */
-    debug_info_src = static_cast<debug_info_source *>(
-        g_hash_table_lookup(proc_dbg_info_src->ip_to_debug_info_src, key));
-    if (debug_info_src) {
+    /* Find the bin_info which contains `ip`. */
+    bin = proc_debug_info_sources_find_bin(proc_dbg_info_src, ip);
+    if (!bin) {
         goto end;
     }
 
-    /* Check in all bin_infos. */
-    g_hash_table_iter_init(&iter, proc_dbg_info_src->baddr_to_bin_info);
-
-    while (g_hash_table_iter_next(&iter, &baddr, &value)) {
-        struct bin_info *bin = static_cast<bin_info *>(value);
-
-        if (!bin_info_has_address(bin, ip)) {
-            continue;
-        }
-
-        /*
-         * Found; add it to cache.
-         *
-         * FIXME: this should be bounded in size (and implement
-         * a caching policy), and entries should be prunned when
-         * libraries are unmapped.
-         */
-        debug_info_src = debug_info_source_create_from_bin(bin, ip, debug_info->self_comp);
-        if (debug_info_src) {
-            g_hash_table_insert(proc_dbg_info_src->ip_to_debug_info_src, key, debug_info_src);
-            /* Ownership passed to ht. */
-            key = nullptr;
-        }
-        break;
-    }
+    debug_info_src = debug_info_source_create_from_bin(
+        bin, ip,
+        debug_info->comp->sym_cache ? sym_cache_borrow_file(debug_info->comp->sym_cache, bin) :
+                                      nullptr,
+        debug_info->self_comp);
 
 end:
-    free(key);
     return debug_info_src;
 }
 
+/*
+ * The returned debug info source remains owned by the IP cache of
+ * `debug_info`: it's only valid until the next query.
+ */
 static struct debug_info_source *debug_info_query(struct debug_info *debug_info, int64_t vpid,
                                                   uint64_t ip)
 {
     struct debug_info_source *dbg_info_src = nullptr;
     struct proc_debug_info_sources *proc_dbg_info_src;
 
+    /* Look in the (VPID, IP) to debug info source cache first. */
+    dbg_info_src =
+        static_cast<debug_info_source *>(ip_cache_lookup(debug_info->ip_cache, vpid, ip));
+    if (dbg_info_src) {
+        goto end;
+    }
+
     proc_dbg_info_src =
         proc_debug_info_sources_ht_get_entry(debug_info->vpid_to_proc_dbg_info_src, vpid);
     if (!proc_dbg_info_src) {
@@ -462,6 +762,10 @@ static struct debug_info_source *debug_info_query(struct debug_info *debug_info,
     }
 
     dbg_info_src = proc_debug_info_sources_get_entry(debug_info, proc_dbg_info_src, ip);
+    if (dbg_info_src) {
+        /* Found; add it to the cache, which takes its ownership. */
+        ip_cache_insert(debug_info->ip_cache, vpid, ip, dbg_info_src);
+    }
 
 end:
     return dbg_info_src;
@@ -491,6 +795,12 @@ static struct debug_info *debug_info_create(struct debug_info_component *comp,
         goto error;
     }
 
+    debug_info->ip_cache =
+        ip_cache_create(IP_CACHE_CAPACITY, (GDestroyNotify) debug_info_source_destroy);
+    if (!debug_info->ip_cache) {
+        goto error;
+    }
+
     debug_info->comp = comp;
     ret = debug_info_init(debug_info);
     if (ret) {
@@ -503,6 +813,11 @@ static struct debug_info *debug_info_create(struct debug_info_component *comp,
 end:
     return debug_info;
 error:
+    if (debug_info->vpid_to_proc_dbg_info_src) {
+        g_hash_table_destroy(debug_info->vpid_to_proc_dbg_info_src);
+    }
+
+    ip_cache_destroy(debug_info->ip_cache);
     g_free(debug_info);
     return nullptr;
 }
@@ -523,6 +838,17 @@ static void debug_info_destroy(struct debug_info *debug_info)
         g_hash_table_destroy(debug_info->vpid_to_proc_dbg_info_src);
     }
 
+    if (debug_info->ip_cache) {
+        const struct ip_cache_stats *stats = &debug_info->ip_cache->stats;
+
+        BT_COMP_LOGI("IP cache statistics: lookups=%" PRIu64 ", hits=%" PRIu64
+                     ", hit-rate=%.2f%%, insertions=%" PRIu64 ", evictions=%" PRIu64
+                     ", invalidations=%" PRIu64,
+                     stats->lookups, stats->hits, ip_cache_hit_rate(debug_info->ip_cache) * 100,
+                     stats->insertions, stats->evictions, stats->invalidations);
+        ip_cache_destroy(debug_info->ip_cache);
+    }
+
     remove_listener_status = bt_trace_remove_destruction_listener(
         debug_info->input_trace, debug_info->destruction_listener_id);
     if (remove_listener_status != BT_TRACE_REMOVE_LISTENER_STATUS_OK) {
@@ -703,6 +1029,7 @@ static void handle_bin_info_event(struct debug_info *debug_info, const bt_event
     g_hash_table_insert(proc_dbg_info_src->baddr_to_bin_info, key, bin);
     /* Ownership passed to ht. */
     key = nullptr;
+    proc_debug_info_sources_add_bin_addr_range(proc_dbg_info_src, bin);
 
 end:
     g_free(key);
@@ -724,6 +1051,7 @@ static void handle_event_lib_unload(struct debug_info *debug_info, const bt_even
 {
     gboolean ret;
     struct proc_debug_info_sources *proc_dbg_info_src;
+    struct bin_info *bin;
     uint64_t baddr;
     int64_t vpid;
 
@@ -741,6 +1069,13 @@ static void handle_event_lib_unload(struct debug_info *debug_info, const bt_even
         goto end;
     }
 
+    bin = static_cast<bin_info *>(
+        g_hash_table_lookup(proc_dbg_info_src->baddr_to_bin_info, (gpointer) &baddr));
+    BT_ASSERT(bin);
+
+    /* The cached debug info sources of this mapping are now stale */
+    ip_cache_invalidate_range(debug_info->ip_cache, vpid, bin->low_addr, bin->high_addr);
+    proc_debug_info_sources_remove_bin_addr_range(proc_dbg_info_src, bin);
     ret = g_hash_table_remove(proc_dbg_info_src->baddr_to_bin_info, (gpointer) &baddr);
     BT_ASSERT(ret);
 end:
@@ -760,8 +1095,9 @@ static void handle_event_statedump_start(struct debug_info *debug_info, const bt
         goto end;
     }
 
+    g_array_set_size(proc_dbg_info_src->bin_addr_ranges, 0);
     g_hash_table_remove_all(proc_dbg_info_src->baddr_to_bin_info);
-    g_hash_table_remove_all(proc_dbg_info_src->ip_to_debug_info_src);
+    ip_cache_invalidate_vpid(debug_info->ip_cache, vpid);
 
 end:
     return;
@@ -844,6 +1180,7 @@ static void destroy_debug_info_comp(struct debug_info_component *debug_info)
         return;
     }
 
+    sym_cache_destroy(debug_info->sym_cache);
     g_free(debug_info->arg_debug_dir);
     g_free(debug_info->arg_debug_info_field_name);
     g_free(debug_info->arg_target_prefix);
@@ -1096,17 +1433,18 @@ end:
     return;
 }
 
-static void update_event_statedump_if_needed(struct debug_info_msg_iter *debug_it,
-                                             const bt_event *in_event)
+/*
+ * Returns whether or not `in_event` is an lttng_ust_statedump event
+ * AND has the right event common context fields, that is, whether or
+ * not it may update the debug-info view of its process.
+ */
+static bool is_event_statedump(struct debug_info_msg_iter *debug_it, const bt_event *in_event)
 {
     const bt_field *event_common_ctx;
     const bt_field_class *event_common_ctx_fc;
     const bt_event_class *in_event_class = bt_event_borrow_class_const(in_event);
+    bool is_statedump = false;
 
-    /*
-     * If the event is an lttng_ust_statedump event AND has the right event
-     * common context fields update the debug-info view for this process.
-     */
     event_common_ctx = bt_event_borrow_common_context_field_const(in_event);
     if (!event_common_ctx) {
         goto end;
@@ -1117,14 +1455,235 @@ static void update_event_statedump_if_needed(struct debug_info_msg_iter *debug_i
                                                 debug_it->ir_maps->debug_info_field_class_name)) {
         /* Checkout if it might be a one of lttng ust statedump events. */
         const char *in_event_name = bt_event_class_get_name(in_event_class);
-        if (strncmp(in_event_name, LTTNG_UST_STATEDUMP_PREFIX,
-                    strlen(LTTNG_UST_STATEDUMP_PREFIX)) == 0) {
-            /* Handle statedump events. */
-            handle_event_statedump(debug_it, in_event);
-        }
+
+        is_statedump = strncmp(in_event_name, LTTNG_UST_STATEDUMP_PREFIX,
+                               strlen(LTTNG_UST_STATEDUMP_PREFIX)) == 0;
     }
+
 end:
-    return;
+    return is_statedump;
+}
+
+static void update_event_statedump_if_needed(struct debug_info_msg_iter *debug_it,
+                                             const bt_event *in_event)
+{
+    /*
+     * If the event is an lttng_ust_statedump event AND has the right event
+     * common context fields update the debug-info view for this process.
+     */
+    if (is_event_statedump(debug_it, in_event)) {
+        /* Handle statedump events. */
+        handle_event_statedump(debug_it, in_event);
+    }
+}
+
+static void debug_info_prefetch_job_destroy(struct debug_info_prefetch_job *job)
+{
+    if (!job) {
+        return;
+    }
+
+    if (job->items) {
+        for (guint i = 0; i < job->items->len; i++) {
+            debug_info_source_destroy(
+                bt_g_array_index(job->items, struct debug_info_prefetch_item, i).dbg_info_src);
+        }
+
+        g_array_free(job->items, TRUE);
+    }
+
+    g_free(job);
+}
+
+/*
+ * Executes the prefetch job `data`; called by a symbolization worker
+ * thread.
+ */
+static void debug_info_prefetch_job_exec(gpointer data)
+{
+    struct debug_info_prefetch_job *job = static_cast<debug_info_prefetch_job *>(data);
+
+    for (guint i = 0; i < job->items->len; i++) {
+        struct debug_info_prefetch_item *item =
+            &bt_g_array_index(job->items, struct debug_info_prefetch_item, i);
+
+        item->dbg_info_src = debug_info_source_create_from_bin(
+            item->bin, item->ip, item->sym_cache_file, job->self_comp);
+    }
+}
+
+static guint debug_info_prefetch_key_hash(gconstpointer v)
+{
+    const struct debug_info_prefetch_key *key = static_cast<const debug_info_prefetch_key *>(v);
+    uint64_t hash = key->ip * UINT64_C(0x9e3779b97f4a7c15);
+
+    hash ^= (uint64_t) key->vpid * UINT64_C(0xc2b2ae3d27d4eb4f);
+    hash ^= (uint64_t) (uintptr_t) key->debug_info;
+    return (guint) (hash ^ (hash >> 32));
+}
+
+static gboolean debug_info_prefetch_key_equal(gconstpointer v1, gconstpointer v2)
+{
+    const struct debug_info_prefetch_key *key1 = static_cast<const debug_info_prefetch_key *>(v1);
+    const struct debug_info_prefetch_key *key2 = static_cast<const debug_info_prefetch_key *>(v2);
+
+    return key1->debug_info == key2->debug_info && key1->vpid == key2->vpid &&
+           key1->ip == key2->ip;
+}
+
+/*
+ * Adds a prefetch item for the debug info source of `in_event`, if
+ * needed.
+ *
+ * The prefetch item uses the current state of the debug info of the
+ * trace of `in_event`: the caller must not call this function for an
+ * event following a statedump event which isn't handled yet.
+ */
+static void debug_info_msg_iter_prefetch_event(struct debug_info_msg_iter *debug_it,
+                                               const bt_event *in_event)
+{
+    const bt_field *in_common_ctx_field;
+    struct debug_info *debug_info;
+    struct proc_debug_info_sources *proc_dbg_info_src;
+    struct debug_info_prefetch_item item = {};
+    struct debug_info_prefetch_key key = {};
+    struct debug_info_prefetch_key *new_key;
+    struct debug_info_prefetch_job *job;
+    gpointer job_key;
+
+    in_common_ctx_field = bt_event_borrow_common_context_field_const(in_event);
+    if (!in_common_ctx_field ||
+        !is_event_common_ctx_dbg_info_compatible(bt_field_borrow_class_const(in_common_ctx_field),
+                                                 debug_it->ir_maps->debug_info_field_class_name)) {
+        return;
+    }
+
+    debug_info = static_cast<struct debug_info *>(
+        g_hash_table_lookup(debug_it->debug_info_map,
+                            bt_stream_borrow_trace_const(bt_event_borrow_stream_const(in_event))));
+    if (!debug_info) {
+        return;
+    }
+
+    key.debug_info = debug_info;
+    key.vpid = bt_field_integer_signed_get_value(
+        bt_field_structure_borrow_member_field_by_name_const(in_common_ctx_field, VPID_FIELD_NAME));
+    key.ip = bt_field_integer_unsigned_get_value(
+        bt_field_structure_borrow_member_field_by_name_const(in_common_ctx_field, IP_FIELD_NAME));
+
+    if (ip_cache_contains(debug_info->ip_cache, key.vpid, key.ip) ||
+        bt_g_hash_table_contains(debug_it->prefetch_keys, &key)) {
+        /* Already looked up or being looked up */
+        return;
+    }
+
+    proc_dbg_info_src = static_cast<proc_debug_info_sources *>(
+        g_hash_table_lookup(debug_info->vpid_to_proc_dbg_info_src, &key.vpid));
+    if (!proc_dbg_info_src) {
+        return;
+    }
+
+    item.bin = proc_debug_info_sources_find_bin(proc_dbg_info_src, key.ip);
+    if (!item.bin) {
+        return;
+    }
+
+    item.debug_info = debug_info;
+    item.vpid = key.vpid;
+    item.ip = key.ip;
+
+    if (debug_info->comp->sym_cache) {
+        item.sym_cache_file = sym_cache_borrow_file(debug_info->comp->sym_cache, item.bin);
+    }
+
+    /* Find or create the job of the bin info or symbolization cache file */
+    job_key = item.sym_cache_file ? (gpointer) item.sym_cache_file : (gpointer) item.bin;
+    job = static_cast<debug_info_prefetch_job *>(
+        g_hash_table_lookup(debug_it->prefetch_job_map, job_key));
+    if (!job) {
+        job = g_new0(struct debug_info_prefetch_job, 1);
+        job->self_comp = debug_it->self_comp;
+        job->items = g_array_new(FALSE, FALSE, sizeof(struct debug_info_prefetch_item));
+        g_ptr_array_add(debug_it->prefetch_jobs, job);
+        g_hash_table_insert(debug_it->prefetch_job_map, job_key, job);
+    }
+
+    g_array_append_val(job->items, item);
+    new_key = g_new(struct debug_info_prefetch_key, 1);
+    *new_key = key;
+    g_hash_table_insert(debug_it->prefetch_keys, new_key, new_key);
+}
+
+/*
+ * Adds prefetch items for the messages of the window of `debug_it`
+ * which it didn't consider yet, up to the first statedump event, and
+ * submits the resulting jobs to the symbolization worker threads.
+ */
+static void debug_info_msg_iter_prefetch_window(struct debug_info_msg_iter *debug_it)
+{
+    GHashTableIter iter;
+    gpointer job;
+
+    while (debug_it->window_prefetched_count < debug_it->window_msgs->len) {
+        const bt_message *msg = static_cast<const bt_message *>(
+            g_ptr_array_index(debug_it->window_msgs, debug_it->window_prefetched_count));
+
+        if (bt_message_get_type(msg) == BT_MESSAGE_TYPE_EVENT) {
+            const bt_event *in_event = bt_message_event_borrow_event_const(msg);
+
+            if (is_event_statedump(debug_it, in_event)) {
+                /*
+                 * This event may change the state which the
+                 * following events need: resume once it's handled.
+                 */
+                break;
+            }
+
+            debug_info_msg_iter_prefetch_event(debug_it, in_event);
+        }
+
+        debug_it->window_prefetched_count++;
+    }
+
+    g_hash_table_iter_init(&iter, debug_it->prefetch_job_map);
+
+    while (g_hash_table_iter_next(&iter, nullptr, &job)) {
+        sym_workers_submit(debug_it->sym_workers, job);
+    }
+
+    g_hash_table_remove_all(debug_it->prefetch_job_map);
+}
+
+/*
+ * Waits for the submitted prefetch jobs of `debug_it` and moves their
+ * results to the IP caches, where the message handling finds them.
+ */
+static void debug_info_msg_iter_collect_prefetched(struct debug_info_msg_iter *debug_it)
+{
+    sym_workers_wait(debug_it->sym_workers);
+
+    for (guint i = 0; i < debug_it->prefetch_jobs->len; i++) {
+        struct debug_info_prefetch_job *job =
+            static_cast<debug_info_prefetch_job *>(g_ptr_array_index(debug_it->prefetch_jobs, i));
+
+        for (guint j = 0; j < job->items->len; j++) {
+            struct debug_info_prefetch_item *item =
+                &bt_g_array_index(job->items, struct debug_info_prefetch_item, j);
+
+            if (!item->dbg_info_src) {
+                continue;
+            }
+
+            BT_ASSERT_DBG(!ip_cache_contains(item->debug_info->ip_cache, item->vpid, item->ip));
+            ip_cache_insert(item->debug_info->ip_cache, item->vpid, item->ip, item->dbg_info_src);
+
+            /* Moved to the IP cache */
+            item->dbg_info_src = nullptr;
+        }
+    }
+
+    g_ptr_array_set_size(debug_it->prefetch_jobs, 0);
+    g_hash_table_remove_all(debug_it->prefetch_keys);
 }
 
 static bt_message *handle_event_message(struct debug_info_msg_iter *debug_it,
@@ -1136,6 +1695,7 @@ static bt_message *handle_event_message(struct debug_info_msg_iter *debug_it,
     const bt_stream *in_stream;
     const bt_stream *out_stream;
     bt_event_class *out_event_class;
+    const struct event_copy_plan *copy_plan;
     bt_packet *out_packet = nullptr;
     bt_event *out_event;
     bt_logging_level log_level = debug_it->log_level;
@@ -1156,6 +1716,10 @@ static bt_message *handle_event_message(struct debug_info_msg_iter *debug_it,
     }
     BT_ASSERT_DBG(out_event_class);
 
+    /* Borrow the plan to copy the input event, created with the event class. */
+    copy_plan = trace_ir_mapping_borrow_event_copy_plan(debug_it->ir_maps, in_event_class);
+    BT_ASSERT_DBG(copy_plan);
+
     /* Borrow the input stream. */
     in_stream = bt_event_borrow_stream_const(in_event);
     BT_ASSERT_DBG(in_stream);
@@ -1202,7 +1766,7 @@ static bt_message *handle_event_message(struct debug_info_msg_iter *debug_it,
     out_event = bt_message_event_borrow_event(out_message);
 
     /* Copy the original fields to the output event. */
-    if (copy_event_content(in_event, out_event, log_level, self_comp) !=
+    if (copy_event_content(in_event, out_event, copy_plan, log_level, self_comp) !=
         DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK) {
         BT_COMP_LOGE_APPEND_CAUSE(self_comp,
                                   "Error copying event message content output event message: "
@@ -1536,6 +2100,10 @@ static struct bt_param_validation_map_value_entry_descr debug_info_params[] = {
      bt_param_validation_value_descr::makeString()},
     {"full-path", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
      bt_param_validation_value_descr::makeBool()},
+    {"cache-dir", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
+     bt_param_validation_value_descr::makeString()},
+    {"symbolization-threads", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
+     bt_param_validation_value_descr::makeUnsignedInteger()},
     BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_END};
 
 static bt_component_class_initialize_method_status
@@ -1587,6 +2155,35 @@ init_from_params(struct debug_info_component *debug_info_component, const bt_val
         debug_info_component->arg_full_path = BT_FALSE;
     }
 
+    value = bt_value_map_borrow_entry_value_const(params, "symbolization-threads");
+    if (value) {
+        const uint64_t thread_count = bt_value_integer_unsigned_get(value);
+
+        if (thread_count > MAX_SYMBOLIZATION_THREADS) {
+            status = BT_COMPONENT_CLASS_INITIALIZE_METHOD_STATUS_ERROR;
+            BT_COMP_LOGE_APPEND_CAUSE(debug_info_component->self_comp,
+                                      "Invalid `symbolization-threads` parameter: "
+                                      "expecting at most %u: value=%" PRIu64,
+                                      MAX_SYMBOLIZATION_THREADS, thread_count);
+            goto end;
+        }
+
+        debug_info_component->arg_symbolization_threads = (unsigned int) thread_count;
+    }
+
+    value = bt_value_map_borrow_entry_value_const(params, "cache-dir");
+    if (value) {
+        debug_info_component->sym_cache = sym_cache_create(bt_value_string_get(value), log_level,
+                                                           debug_info_component->self_comp);
+        if (!debug_info_component->sym_cache) {
+            status = BT_COMPONENT_CLASS_INITIALIZE_METHOD_STATUS_ERROR;
+            BT_COMP_LOGE_APPEND_CAUSE(debug_info_component->self_comp,
+                                      "Cannot create symbolization cache: path=\"%s\"",
+                                      bt_value_string_get(value));
+            goto end;
+        }
+    }
+
     status = BT_COMPONENT_CLASS_INITIALIZE_METHOD_STATUS_OK;
 
 end:
@@ -1682,6 +2279,145 @@ void debug_info_comp_finalize(bt_self_component_filter *self_comp_flt)
     destroy_debug_info_comp(debug_info);
 }
 
+/*
+ * Drops the messages of the window of `debug_it` and forgets the
+ * upstream status.
+ */
+static void debug_info_msg_iter_clear_window(struct debug_info_msg_iter *debug_it)
+{
+    for (guint i = 0; i < debug_it->window_msgs->len; i++) {
+        bt_message_put_ref(
+            static_cast<const bt_message *>(g_ptr_array_index(debug_it->window_msgs, i)));
+    }
+
+    g_ptr_array_set_size(debug_it->window_msgs, 0);
+    debug_it->window_prefetched_count = 0;
+    debug_it->upstream_done = false;
+
+    if (debug_it->upstream_error) {
+        bt_error_release(debug_it->upstream_error);
+        debug_it->upstream_error = nullptr;
+    }
+}
+
+/*
+ * Next method with symbolization worker threads.
+ *
+ * `debug_it` keeps a window of up to `PREFETCH_WINDOW_SIZE` input
+ * messages. For each call:
+ *
+ * 1. Submit prefetch jobs for the window messages which weren't
+ *    considered yet.
+ *
+ * 2. Refill the window from upstream while the worker threads execute
+ *    the jobs: the symbolization of the messages overlaps with the
+ *    decoding of the following ones.
+ *
+ * 3. Wait for the jobs and move their results to the IP caches.
+ *
+ * 4. Handle the first messages of the window, in order, exactly like
+ *    without worker threads: their debug info sources are IP cache
+ *    hits.
+ */
+static bt_message_iterator_class_next_method_status
+debug_info_msg_iter_next_with_workers(struct debug_info_msg_iter *debug_it,
+                                      const bt_message_array_const msgs, uint64_t capacity,
+                                      uint64_t *count)
+{
+    bt_message_iterator_class_next_method_status status =
+        BT_MESSAGE_ITERATOR_CLASS_NEXT_METHOD_STATUS_OK;
+    guint msg_count;
+    guint i;
+
+    debug_info_msg_iter_prefetch_window(debug_it);
+
+    while (!debug_it->upstream_done && debug_it->window_msgs->len < PREFETCH_WINDOW_SIZE) {
+        bt_message_array_const input_msgs;
+        uint64_t input_count;
+        const bt_message_iterator_next_status upstream_status =
+            bt_message_iterator_next(debug_it->msg_iter, &input_msgs, &input_count);
+
+        if (upstream_status == BT_MESSAGE_ITERATOR_NEXT_STATUS_AGAIN) {
+            break;
+        } else if (upstream_status != BT_MESSAGE_ITERATOR_NEXT_STATUS_OK) {
+            /* Return the status once the window is empty */
+            debug_it->upstream_done = true;
+            debug_it->upstream_status = upstream_status;
+
+            if (upstream_status != BT_MESSAGE_ITERATOR_NEXT_STATUS_END) {
+                debug_it->upstream_error = bt_current_thread_take_error();
+            }
+
+            break;
+        }
+
+        for (i = 0; i < input_count; i++) {
+            g_ptr_array_add(debug_it->window_msgs, (gpointer) input_msgs[i]);
+        }
+    }
+
+    debug_info_msg_iter_collect_prefetched(debug_it);
+
+    if (debug_it->window_msgs->len == 0) {
+        if (!debug_it->upstream_done) {
+            status = BT_MESSAGE_ITERATOR_CLASS_NEXT_METHOD_STATUS_AGAIN;
+        } else {
+            status = static_cast<bt_message_iterator_class_next_method_status>(
+                debug_it->upstream_status);
+
+            if (debug_it->upstream_error) {
+                BT_CURRENT_THREAD_MOVE_ERROR_AND_RESET(debug_it->upstream_error);
+            }
+        }
+
+        goto end;
+    }
+
+    msg_count = MIN(debug_it->window_msgs->len, capacity);
+
+    for (i = 0; i < msg_count; i++) {
+        const bt_message *in_message =
+            static_cast<const bt_message *>(g_ptr_array_index(debug_it->window_msgs, i));
+        const bt_message *out_message = handle_message(debug_it, in_message);
+
+        if (!out_message) {
+            guint j;
+
+            /*
+             * Drop references of the output messages created
+             * before the failure and of the input messages not
+             * handled yet.
+             */
+            for (j = 0; j < i; j++) {
+                bt_message_put_ref(msgs[j]);
+            }
+
+            for (j = i; j < msg_count; j++) {
+                bt_message_put_ref(
+                    static_cast<const bt_message *>(g_ptr_array_index(debug_it->window_msgs, j)));
+            }
+
+            status = BT_MESSAGE_ITERATOR_CLASS_NEXT_METHOD_STATUS_MEMORY_ERROR;
+            break;
+        }
+
+        msgs[i] = out_message;
+
+        /*
+         * Drop our reference of the input message as we are done with
+         * it and created a output copy.
+         */
+        bt_message_put_ref(in_message);
+    }
+
+    g_ptr_array_remove_range(debug_it->window_msgs, 0, msg_count);
+    debug_it->window_prefetched_count -= MIN(debug_it->window_prefetched_count, msg_count);
+    *count = msg_count;
+
+end:
+    return status;
+}
+
 bt_message_iterator_class_next_method_status
 debug_info_msg_iter_next(bt_self_message_iterator *self_msg_iter, const bt_message_array_const msgs,
                          uint64_t capacity, uint64_t *count)
@@ -1711,6 +2447,12 @@ debug_info_msg_iter_next(bt_self_message_iterator *self_msg_iter, const bt_messa
     upstream_iterator = debug_info_msg_iter->msg_iter;
     BT_ASSERT_DBG(upstream_iterator);
 
+    if (debug_info_msg_iter->sym_workers) {
+        status =
+            debug_info_msg_iter_next_with_workers(debug_info_msg_iter, msgs, capacity, count);
+        goto end;
+    }
+
     upstream_iterator_ret_status = bt_message_iterator_next(upstream_iterator, &input_msgs, count);
     if (upstream_iterator_ret_status != BT_MESSAGE_ITERATOR_NEXT_STATUS_OK) {
         /*
@@ -1774,6 +2516,25 @@ static void debug_info_msg_iter_destroy(struct debug_info_msg_iter *debug_info_m
         goto end;
     }
 
+    sym_workers_destroy(debug_info_msg_iter->sym_workers);
+
+    if (debug_info_msg_iter->window_msgs) {
+        debug_info_msg_iter_clear_window(debug_info_msg_iter);
+        g_ptr_array_free(debug_info_msg_iter->window_msgs, TRUE);
+    }
+
+    if (debug_info_msg_iter->prefetch_jobs) {
+        g_ptr_array_free(debug_info_msg_iter->prefetch_jobs, TRUE);
+    }
+
+    if (debug_info_msg_iter->prefetch_job_map) {
+        g_hash_table_destroy(debug_info_msg_iter->prefetch_job_map);
+    }
+
+    if (debug_info_msg_iter->prefetch_keys) {
+        g_hash_table_destroy(debug_info_msg_iter->prefetch_keys);
+    }
+
     if (debug_info_msg_iter->msg_iter) {
         bt_message_iterator_put_ref(debug_info_msg_iter->msg_iter);
     }
@@ -1857,12 +2618,35 @@ debug_info_msg_iter_init(bt_self_message_iterator *self_msg_iter,
         goto error;
     }
 
-    ret = bt_fd_cache_init(&debug_info_msg_iter->fd_cache, log_level);
+    ret = bt_fd_cache_init(&debug_info_msg_iter->fd_cache, 0, log_level);
     if (ret) {
         status = BT_MESSAGE_ITERATOR_CLASS_INITIALIZE_METHOD_STATUS_MEMORY_ERROR;
         goto error;
     }
 
+    if (debug_info_msg_iter->debug_info_component->arg_symbolization_threads > 0) {
+        debug_info_msg_iter->window_msgs = g_ptr_array_sized_new(PREFETCH_WINDOW_SIZE);
+        debug_info_msg_iter->prefetch_jobs =
+            bt_g_ptr_array_new_full(16, (GDestroyNotify) debug_info_prefetch_job_destroy);
+        debug_info_msg_iter->prefetch_job_map = g_hash_table_new(g_direct_hash, g_direct_equal);
+        debug_info_msg_iter->prefetch_keys =
+            g_hash_table_new_full(debug_info_prefetch_key_hash, debug_info_prefetch_key_equal,
+                                  (GDestroyNotify) g_free, nullptr);
+        if (!debug_info_msg_iter->window_msgs || !debug_info_msg_iter->prefetch_jobs ||
+            !debug_info_msg_iter->prefetch_job_map || !debug_info_msg_iter->prefetch_keys) {
+            status = BT_MESSAGE_ITERATOR_CLASS_INITIALIZE_METHOD_STATUS_MEMORY_ERROR;
+            goto error;
+        }
+
+        debug_info_msg_iter->sym_workers = sym_workers_create(
+            debug_info_msg_iter->debug_info_component->arg_symbolization_threads,
+            debug_info_prefetch_job_exec, log_level, self_comp);
+        if (!debug_info_msg_iter->sym_workers) {
+            status = BT_MESSAGE_ITERATOR_CLASS_INITIALIZE_METHOD_STATUS_ERROR;
+            goto error;
+        }
+    }
+
     bt_self_message_iterator_configuration_set_can_seek_forward(
         config, bt_message_iterator_can_seek_forward(debug_info_msg_iter->msg_iter));
 
@@ -1910,6 +2694,10 @@ debug_info_msg_iter_seek_beginning(bt_self_message_iterator *self_msg_iter)
     }
 
     /* Clear this iterator data. */
+    if (debug_info_msg_iter->window_msgs) {
+        debug_info_msg_iter_clear_window(debug_info_msg_iter);
+    }
+
     trace_ir_maps_clear(debug_info_msg_iter->ir_maps);
     g_hash_table_remove_all(debug_info_msg_iter->debug_info_map);
 
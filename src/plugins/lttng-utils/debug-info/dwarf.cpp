@@ -6,6 +6,8 @@
  * Babeltrace - DWARF Information Reader
  */
 
+#include <algorithm>
+
 #include <glib.h>
 #include <stdbool.h>
 
@@ -339,3 +341,453 @@ int bt_dwarf_die_contains_addr(struct bt_dwarf_die *die, uint64_t addr, bool *co
 error:
     return -1;
 }
+
+struct bt_dwarf_die *bt_dwarf_die_create_at(struct bt_dwarf_cu *cu, Dwarf_Off offset,
+                                            unsigned int depth)
+{
+    Dwarf_Die *dwarf_die = nullptr;
+    struct bt_dwarf_die *die = nullptr;
+
+    if (!cu) {
+        goto error;
+    }
+
+    dwarf_die = g_new0(Dwarf_Die, 1);
+    if (!dwarf_die) {
+        goto error;
+    }
+
+    if (!dwarf_offdie(cu->dwarf_info, offset, dwarf_die)) {
+        goto error;
+    }
+
+    die = g_new0(struct bt_dwarf_die, 1);
+    if (!die) {
+        goto error;
+    }
+
+    die->cu = cu;
+    die->dwarf_die = dwarf_die;
+    die->depth = depth;
+
+    return die;
+
+error:
+    g_free(dwarf_die);
+    g_free(die);
+    return nullptr;
+}
+
+struct bt_dwarf_addr_index_cu
+{
+    Dwarf_Off offset;
+    Dwarf_Off next_offset;
+    size_t header_size;
+
+    /* True if at least one address range of this CU is indexed */
+    bool has_ranges;
+};
+
+struct bt_dwarf_addr_index_range
+{
+    uint64_t low_addr;
+    uint64_t high_addr;
+
+    /*
+     * Maximum high address of this range and of all the ranges
+     * before it in the sorted array: a backward scan from the
+     * insertion point of some address may stop as soon as this is
+     * less than or equal to the address.
+     */
+    uint64_t max_high_addr;
+
+    /* Offset of the function DIE (unused for CU ranges) */
+    Dwarf_Off die_offset;
+
+    /* Index of the CU in `bt_dwarf_addr_index::cus` */
+    guint cu_index;
+};
+
+struct bt_dwarf_addr_index
+{
+    Dwarf *dwarf_info;
+
+    /* Array of `struct bt_dwarf_addr_index_cu`, in CU order */
+    GArray *cus;
+
+    /* Arrays of `struct bt_dwarf_addr_index_range`, sorted by low address */
+    GArray *cu_ranges;
+    GArray *func_ranges;
+};
+
+static void addr_index_append_die_ranges(GArray *ranges, Dwarf_Die *dwarf_die, guint cu_index,
+                                         bool *appended)
+{
+    Dwarf_Addr base, start, end;
+    ptrdiff_t offset = 0;
+
+    /*
+     * dwarf_ranges() handles both the `DW_AT_low_pc`/`DW_AT_high_pc`
+     * and the `DW_AT_ranges` cases, like dwarf_haspc() does.
+     */
+    while ((offset = dwarf_ranges(dwarf_die, offset, &base, &start, &end)) > 0) {
+        struct bt_dwarf_addr_index_range range = {};
+
+        if (start >= end) {
+            continue;
+        }
+
+        range.low_addr = start;
+        range.high_addr = end;
+        range.die_offset = dwarf_dieoffset(dwarf_die);
+        range.cu_index = cu_index;
+        g_array_append_val(ranges, range);
+
+        if (appended) {
+            *appended = true;
+        }
+    }
+}
+
+static gint addr_index_range_compare(gconstpointer a, gconstpointer b)
+{
+    const struct bt_dwarf_addr_index_range *range_a =
+        (const struct bt_dwarf_addr_index_range *) a;
+    const struct bt_dwarf_addr_index_range *range_b =
+        (const struct bt_dwarf_addr_index_range *) b;
+
+    if (range_a->low_addr != range_b->low_addr) {
+        return range_a->low_addr < range_b->low_addr ? -1 : 1;
+    }
+
+    if (range_a->die_offset != range_b->die_offset) {
+        return range_a->die_offset < range_b->die_offset ? -1 : 1;
+    }
+
+    return 0;
+}
+
+static void addr_index_sort_ranges(GArray *ranges)
+{
+    uint64_t max_high_addr = 0;
+    guint i;
+
+    g_array_sort(ranges, addr_index_range_compare);
+
+    for (i = 0; i < ranges->len; i++) {
+        struct bt_dwarf_addr_index_range *range =
+            &g_array_index(ranges, struct bt_dwarf_addr_index_range, i);
+
+        max_high_addr = MAX(max_high_addr, range->high_addr);
+        range->max_high_addr = max_high_addr;
+    }
+}
+
+/*
+ * Returns the index of the first range of `ranges` of which the low
+ * address is greater than `addr`.
+ */
+static guint addr_index_ranges_upper_bound(GArray *ranges, uint64_t addr)
+{
+    guint low = 0, high = ranges->len;
+
+    while (low < high) {
+        const guint mid = low + (high - low) / 2;
+
+        if (g_array_index(ranges, struct bt_dwarf_addr_index_range, mid).low_addr <= addr) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/*
+ * Returns the index of the CU of which the DIE offset is
+ * `cu_die_offset`, or -1 if there's none.
+ */
+static int64_t addr_index_find_cu_by_die_offset(struct bt_dwarf_addr_index *index,
+                                                Dwarf_Off cu_die_offset)
+{
+    guint low = 0, high = index->cus->len;
+
+    while (low < high) {
+        const guint mid = low + (high - low) / 2;
+        const struct bt_dwarf_addr_index_cu *cu =
+            &g_array_index(index->cus, struct bt_dwarf_addr_index_cu, mid);
+        const Dwarf_Off mid_die_offset = cu->offset + cu->header_size;
+
+        if (mid_die_offset == cu_die_offset) {
+            return mid;
+        } else if (mid_die_offset < cu_die_offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return -1;
+}
+
+static void addr_index_add_aranges(struct bt_dwarf_addr_index *index)
+{
+    Dwarf_Aranges *aranges;
+    size_t arange_count, i;
+
+    if (dwarf_getaranges(index->dwarf_info, &aranges, &arange_count)) {
+        /* No usable `.debug_aranges`: fall back to the CU DIEs */
+        return;
+    }
+
+    for (i = 0; i < arange_count; i++) {
+        Dwarf_Arange *arange = dwarf_onearange(aranges, i);
+        struct bt_dwarf_addr_index_range range = {};
+        Dwarf_Addr addr;
+        Dwarf_Word length;
+        Dwarf_Off cu_die_offset;
+        int64_t cu_index;
+
+        if (!arange || dwarf_getarangeinfo(arange, &addr, &length, &cu_die_offset) ||
+            length == 0) {
+            continue;
+        }
+
+        cu_index = addr_index_find_cu_by_die_offset(index, cu_die_offset);
+        if (cu_index < 0) {
+            continue;
+        }
+
+        range.low_addr = addr;
+        range.high_addr = addr + length;
+        range.cu_index = cu_index;
+        g_array_append_val(index->cu_ranges, range);
+        g_array_index(index->cus, struct bt_dwarf_addr_index_cu, cu_index).has_ranges = true;
+    }
+}
+
+struct bt_dwarf_addr_index *bt_dwarf_addr_index_create(Dwarf *dwarf_info)
+{
+    struct bt_dwarf_addr_index *index = nullptr;
+    struct bt_dwarf_cu *cu = nullptr;
+    guint i;
+    int ret;
+
+    if (!dwarf_info) {
+        goto error;
+    }
+
+    index = g_new0(struct bt_dwarf_addr_index, 1);
+    if (!index) {
+        goto error;
+    }
+
+    index->dwarf_info = dwarf_info;
+    index->cus = g_array_new(FALSE, FALSE, sizeof(struct bt_dwarf_addr_index_cu));
+    index->cu_ranges = g_array_new(FALSE, FALSE, sizeof(struct bt_dwarf_addr_index_range));
+    index->func_ranges = g_array_new(FALSE, FALSE, sizeof(struct bt_dwarf_addr_index_range));
+    if (!index->cus || !index->cu_ranges || !index->func_ranges) {
+        goto error;
+    }
+
+    cu = bt_dwarf_cu_create(dwarf_info);
+    if (!cu) {
+        goto error;
+    }
+
+    /* Index the function DIEs of all the CUs */
+    while ((ret = bt_dwarf_cu_next(cu)) == 0) {
+        struct bt_dwarf_addr_index_cu index_cu = {};
+        struct bt_dwarf_die *die;
+
+        index_cu.offset = cu->offset;
+        index_cu.next_offset = cu->next_offset;
+        index_cu.header_size = cu->header_size;
+        g_array_append_val(index->cus, index_cu);
+
+        die = bt_dwarf_die_create(cu);
+        if (!die) {
+            goto error;
+        }
+
+        while (bt_dwarf_die_next(die) == 0) {
+            int tag;
+
+            if (bt_dwarf_die_get_tag(die, &tag)) {
+                bt_dwarf_die_destroy(die);
+                goto error;
+            }
+
+            if (tag == DW_TAG_subprogram) {
+                addr_index_append_die_ranges(index->func_ranges, die->dwarf_die,
+                                             index->cus->len - 1, nullptr);
+            }
+        }
+
+        bt_dwarf_die_destroy(die);
+    }
+
+    if (ret < 0) {
+        goto error;
+    }
+
+    /*
+     * Index the address ranges of the CUs, preferably from
+     * `.debug_aranges`, and then from the CU DIEs for the CUs which
+     * `.debug_aranges` doesn't cover.
+     */
+    addr_index_add_aranges(index);
+
+    for (i = 0; i < index->cus->len; i++) {
+        struct bt_dwarf_addr_index_cu *index_cu =
+            &g_array_index(index->cus, struct bt_dwarf_addr_index_cu, i);
+        Dwarf_Die cu_die;
+
+        if (index_cu->has_ranges) {
+            continue;
+        }
+
+        if (!dwarf_offdie(dwarf_info, index_cu->offset + index_cu->header_size, &cu_die)) {
+            /*
+             * Can't get the DIE of this CU: leave it without ranges
+             * (bt_dwarf_addr_index_get_cus() always returns such a
+             * CU) and keep indexing the other CUs.
+             */
+            continue;
+        }
+
+        addr_index_append_die_ranges(index->cu_ranges, &cu_die, i, &index_cu->has_ranges);
+    }
+
+    addr_index_sort_ranges(index->cu_ranges);
+    addr_index_sort_ranges(index->func_ranges);
+    bt_dwarf_cu_destroy(cu);
+    return index;
+
+error:
+    bt_dwarf_cu_destroy(cu);
+    bt_dwarf_addr_index_destroy(index);
+    return nullptr;
+}
+
+void bt_dwarf_addr_index_destroy(struct bt_dwarf_addr_index *index)
+{
+    if (!index) {
+        return;
+    }
+
+    if (index->cus) {
+        g_array_free(index->cus, TRUE);
+    }
+
+    if (index->cu_ranges) {
+        g_array_free(index->cu_ranges, TRUE);
+    }
+
+    if (index->func_ranges) {
+        g_array_free(index->func_ranges, TRUE);
+    }
+
+    g_free(index);
+}
+
+void bt_dwarf_addr_index_get_cus(struct bt_dwarf_addr_index *index, uint64_t addr,
+                                 GArray *cu_indexes)
+{
+    const guint first_index = cu_indexes->len;
+    guint range_index = addr_index_ranges_upper_bound(index->cu_ranges, addr);
+    guint i, dst_index;
+
+    while (range_index > 0) {
+        const struct bt_dwarf_addr_index_range *range =
+            &g_array_index(index->cu_ranges, struct bt_dwarf_addr_index_range, range_index - 1);
+
+        if (range->max_high_addr <= addr) {
+            break;
+        }
+
+        if (addr < range->high_addr) {
+            g_array_append_val(cu_indexes, range->cu_index);
+        }
+
+        range_index--;
+    }
+
+    for (i = 0; i < index->cus->len; i++) {
+        if (!g_array_index(index->cus, struct bt_dwarf_addr_index_cu, i).has_ranges) {
+            g_array_append_val(cu_indexes, i);
+        }
+    }
+
+    if (cu_indexes->len - first_index < 2) {
+        return;
+    }
+
+    /* Sort in CU order and remove the duplicates */
+    std::sort(&g_array_index(cu_indexes, guint, first_index),
+              &g_array_index(cu_indexes, guint, 0) + cu_indexes->len);
+
+    for (i = first_index + 1, dst_index = first_index + 1; i < cu_indexes->len; i++) {
+        const guint cu_index = g_array_index(cu_indexes, guint, i);
+
+        if (cu_index != g_array_index(cu_indexes, guint, dst_index - 1)) {
+            g_array_index(cu_indexes, guint, dst_index) = cu_index;
+            dst_index++;
+        }
+    }
+
+    g_array_set_size(cu_indexes, dst_index);
+}
+
+void bt_dwarf_addr_index_set_cu(struct bt_dwarf_addr_index *index, guint cu_index,
+                                struct bt_dwarf_cu *cu)
+{
+    const struct bt_dwarf_addr_index_cu *index_cu =
+        &g_array_index(index->cus, struct bt_dwarf_addr_index_cu, cu_index);
+
+    cu->dwarf_info = index->dwarf_info;
+    cu->offset = index_cu->offset;
+    cu->next_offset = index_cu->next_offset;
+    cu->header_size = index_cu->header_size;
+}
+
+int bt_dwarf_addr_index_find_func_die(struct bt_dwarf_addr_index *index, uint64_t addr,
+                                      int64_t cu_index, struct bt_dwarf_cu *cu,
+                                      struct bt_dwarf_die **die)
+{
+    const struct bt_dwarf_addr_index_range *found_range = nullptr;
+    guint range_index = addr_index_ranges_upper_bound(index->func_ranges, addr);
+
+    /*
+     * DIE offsets increase in CU and DIE order: keep the containing
+     * range having the lowest DIE offset.
+     */
+    while (range_index > 0) {
+        const struct bt_dwarf_addr_index_range *range =
+            &g_array_index(index->func_ranges, struct bt_dwarf_addr_index_range, range_index - 1);
+
+        if (range->max_high_addr <= addr) {
+            break;
+        }
+
+        if (addr < range->high_addr && (cu_index < 0 || range->cu_index == cu_index) &&
+            (!found_range || range->die_offset < found_range->die_offset)) {
+            found_range = range;
+        }
+
+        range_index--;
+    }
+
+    if (!found_range) {
+        return 1;
+    }
+
+    bt_dwarf_addr_index_set_cu(index, found_range->cu_index, cu);
+    *die = bt_dwarf_die_create_at(cu, found_range->die_offset, 1);
+    if (!*die) {
+        return -1;
+    }
+
+    return 0;
+}
@@ -11,6 +11,7 @@
 
 #include <dwarf.h>
 #include <elfutils/libdw.h>
+#include <glib.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -202,4 +203,96 @@ int bt_dwarf_die_get_call_line(struct bt_dwarf_die *die, uint64_t *line_no);
  */
 int bt_dwarf_die_contains_addr(struct bt_dwarf_die *die, uint64_t addr, bool *contains);
 
+/**
+ * Instantiate a structure to access the debug information entry (DIE)
+ * at the offset `offset` within the compile unit `cu`.
+ *
+ * @param cu		bt_dwarf_cu instance
+ * @param offset	Offset in bytes in the DWARF file to the DIE
+ * @param depth		Depth of the DIE
+ * @returns		Pointer to the new bt_dwarf_die on success,
+ *			`nullptr` on failure.
+ */
+struct bt_dwarf_die *bt_dwarf_die_create_at(struct bt_dwarf_cu *cu, Dwarf_Off offset,
+                                            unsigned int depth);
+
+/*
+ * Address index of a given set of debug information (Dwarf type).
+ *
+ * This index contains the address ranges of the compile units (CU),
+ * from `.debug_aranges` when available, and the address ranges of the
+ * function DIEs (DW_TAG_subprogram at depth 1, see
+ * bt_dwarf_die_next()), sorted by low address, so that finding the CU
+ * or the function containing an address doesn't require to walk all
+ * the DIEs.
+ */
+struct bt_dwarf_addr_index;
+
+/**
+ * Build the address index of `dwarf_info`.
+ *
+ * This walks all the CUs and their depth 1 DIEs once.
+ *
+ * @param dwarf_info	Dwarf instance
+ * @returns		Pointer to the new bt_dwarf_addr_index on
+ *			success, `nullptr` on failure.
+ */
+struct bt_dwarf_addr_index *bt_dwarf_addr_index_create(Dwarf *dwarf_info);
+
+/**
+ * Destroy the given bt_dwarf_addr_index instance.
+ *
+ * @param index	bt_dwarf_addr_index instance
+ */
+void bt_dwarf_addr_index_destroy(struct bt_dwarf_addr_index *index);
+
+/**
+ * Get the indexes of the CUs which may contain the address `addr`, in
+ * CU order.
+ *
+ * Those are the CUs of which an address range contains `addr`, and the
+ * CUs without any known address range.
+ *
+ * @param index		bt_dwarf_addr_index instance
+ * @param addr		The address to look for
+ * @param cu_indexes	Array of `guint` to which to append the CU
+ *			indexes
+ */
+void bt_dwarf_addr_index_get_cus(struct bt_dwarf_addr_index *index, uint64_t addr,
+                                 GArray *cu_indexes);
+
+/**
+ * Set the compile unit `cu` to the CU having the index `cu_index`
+ * (see bt_dwarf_addr_index_get_cus()).
+ *
+ * @param index		bt_dwarf_addr_index instance
+ * @param cu_index	Index of the CU
+ * @param cu		bt_dwarf_cu instance to set
+ */
+void bt_dwarf_addr_index_set_cu(struct bt_dwarf_addr_index *index, guint cu_index,
+                                struct bt_dwarf_cu *cu);
+
+/**
+ * Find the first function DIE, in CU and DIE order, which contains
+ * the address `addr`.
+ *
+ * If `cu_index` is not negative, only consider the function DIEs of
+ * the CU having this index.
+ *
+ * On success, if found, `cu` is set to the CU of the function DIE, and
+ * the out parameter `die` is set to a new bt_dwarf_die instance, at
+ * depth 1, of which the ownership is passed to the caller.
+ *
+ * @param index		bt_dwarf_addr_index instance
+ * @param addr		The address to look for
+ * @param cu_index	Index of the CU to which to restrict the search,
+ *			or -1
+ * @param cu		bt_dwarf_cu instance to set
+ * @param die		Out parameter, the function DIE
+ * @returns		0 on success, 1 if not found, -1 on failure
+ */
+int bt_dwarf_addr_index_find_func_die(struct bt_dwarf_addr_index *index, uint64_t addr,
+                                      int64_t cu_index, struct bt_dwarf_cu *cu,
+                                      struct bt_dwarf_die **die);
+
 #endif /* BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_DWARF_HPP */
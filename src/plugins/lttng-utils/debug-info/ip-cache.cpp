@@ -0,0 +1,299 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ *
+ * Babeltrace - Bounded (VPID, IP) cache
+ */
+
+#include "common/assert.h"
+
+#include "ip-cache.hpp"
+
+static inline guint ip_cache_hash(const struct ip_cache *cache, int64_t vpid, uint64_t ip)
+{
+    uint64_t hash = ip * UINT64_C(0x9e3779b97f4a7c15);
+
+    hash ^= (uint64_t) vpid * UINT64_C(0xc2b2ae3d27d4eb4f);
+    hash ^= hash >> 29;
+    return (guint) hash & cache->slot_mask;
+}
+
+static inline void ip_cache_lru_unlink(struct ip_cache *cache, guint index)
+{
+    struct ip_cache_entry *entry = &cache->entries[index];
+
+    if (entry->prev == IP_CACHE_NO_ENTRY) {
+        cache->lru_head = entry->next;
+    } else {
+        cache->entries[entry->prev].next = entry->next;
+    }
+
+    if (entry->next == IP_CACHE_NO_ENTRY) {
+        cache->lru_tail = entry->prev;
+    } else {
+        cache->entries[entry->next].prev = entry->prev;
+    }
+}
+
+static inline void ip_cache_lru_push_front(struct ip_cache *cache, guint index)
+{
+    struct ip_cache_entry *entry = &cache->entries[index];
+
+    entry->prev = IP_CACHE_NO_ENTRY;
+    entry->next = cache->lru_head;
+
+    if (cache->lru_head == IP_CACHE_NO_ENTRY) {
+        cache->lru_tail = index;
+    } else {
+        cache->entries[cache->lru_head].prev = index;
+    }
+
+    cache->lru_head = index;
+}
+
+struct ip_cache *ip_cache_create(guint capacity, GDestroyNotify value_destroy)
+{
+    struct ip_cache *cache;
+    guint slot_count = 1;
+    guint i;
+
+    BT_ASSERT(capacity > 0);
+    BT_ASSERT(capacity <= G_MAXUINT / 4);
+
+    cache = g_new0(struct ip_cache, 1);
+    if (!cache) {
+        goto error;
+    }
+
+    while (slot_count < capacity * 2) {
+        slot_count *= 2;
+    }
+
+    cache->entries = g_new0(struct ip_cache_entry, capacity);
+    if (!cache->entries) {
+        goto error;
+    }
+
+    cache->slots = g_new0(guint, slot_count);
+    if (!cache->slots) {
+        goto error;
+    }
+
+    cache->capacity = capacity;
+    cache->slot_mask = slot_count - 1;
+    cache->lru_head = IP_CACHE_NO_ENTRY;
+    cache->lru_tail = IP_CACHE_NO_ENTRY;
+    cache->value_destroy = value_destroy;
+
+    /* Chain all the entries in the free list */
+    for (i = 0; i < capacity; i++) {
+        cache->entries[i].next = i + 1 < capacity ? i + 1 : IP_CACHE_NO_ENTRY;
+    }
+
+    cache->free_head = 0;
+    return cache;
+
+error:
+    ip_cache_destroy(cache);
+    return nullptr;
+}
+
+void ip_cache_destroy(struct ip_cache *cache)
+{
+    if (!cache) {
+        return;
+    }
+
+    if (cache->entries && cache->value_destroy) {
+        guint index = cache->lru_head;
+
+        while (index != IP_CACHE_NO_ENTRY) {
+            cache->value_destroy(cache->entries[index].value);
+            index = cache->entries[index].next;
+        }
+    }
+
+    g_free(cache->entries);
+    g_free(cache->slots);
+    g_free(cache);
+}
+
+/*
+ * Returns the index of the entry (`vpid`, `ip`) of `cache`, or
+ * `IP_CACHE_NO_ENTRY` if there's none.
+ */
+static guint ip_cache_find(const struct ip_cache *cache, int64_t vpid, uint64_t ip)
+{
+    guint slot_index = ip_cache_hash(cache, vpid, ip);
+
+    while (cache->slots[slot_index] != 0) {
+        const guint index = cache->slots[slot_index] - 1;
+        const struct ip_cache_entry *entry = &cache->entries[index];
+
+        if (entry->ip == ip && entry->vpid == vpid) {
+            return index;
+        }
+
+        slot_index = (slot_index + 1) & cache->slot_mask;
+    }
+
+    return IP_CACHE_NO_ENTRY;
+}
+
+gpointer ip_cache_lookup(struct ip_cache *cache, int64_t vpid, uint64_t ip)
+{
+    const guint index = ip_cache_find(cache, vpid, ip);
+
+    cache->stats.lookups++;
+
+    if (index == IP_CACHE_NO_ENTRY) {
+        return nullptr;
+    }
+
+    if (cache->lru_head != index) {
+        ip_cache_lru_unlink(cache, index);
+        ip_cache_lru_push_front(cache, index);
+    }
+
+    cache->stats.hits++;
+    return cache->entries[index].value;
+}
+
+bool ip_cache_contains(const struct ip_cache *cache, int64_t vpid, uint64_t ip)
+{
+    return ip_cache_find(cache, vpid, ip) != IP_CACHE_NO_ENTRY;
+}
+
+/*
+ * Removes the entry at the index `index` of `cache`.
+ */
+static void ip_cache_remove(struct ip_cache *cache, guint index)
+{
+    struct ip_cache_entry *entry = &cache->entries[index];
+    guint slot_index = ip_cache_hash(cache, entry->vpid, entry->ip);
+    guint next_slot_index;
+
+    /* Find the slot of the entry */
+    while (cache->slots[slot_index] != index + 1) {
+        BT_ASSERT_DBG(cache->slots[slot_index] != 0);
+        slot_index = (slot_index + 1) & cache->slot_mask;
+    }
+
+    /*
+     * Empty the slot, shifting back the following slots of the probe
+     * sequence which may not be reachable otherwise (no tombstones).
+     */
+    next_slot_index = slot_index;
+
+    while (true) {
+        const struct ip_cache_entry *next_entry;
+        guint home_slot_index;
+
+        next_slot_index = (next_slot_index + 1) & cache->slot_mask;
+
+        if (cache->slots[next_slot_index] == 0) {
+            break;
+        }
+
+        next_entry = &cache->entries[cache->slots[next_slot_index] - 1];
+        home_slot_index = ip_cache_hash(cache, next_entry->vpid, next_entry->ip);
+
+        /*
+         * Keep the next entry in place if its home slot is
+         * cyclically within ]`slot_index`, `next_slot_index`].
+         */
+        if (((next_slot_index - home_slot_index) & cache->slot_mask) <
+            ((next_slot_index - slot_index) & cache->slot_mask)) {
+            continue;
+        }
+
+        cache->slots[slot_index] = cache->slots[next_slot_index];
+        slot_index = next_slot_index;
+    }
+
+    cache->slots[slot_index] = 0;
+
+    /* Release the entry */
+    ip_cache_lru_unlink(cache, index);
+
+    if (cache->value_destroy) {
+        cache->value_destroy(entry->value);
+    }
+
+    entry->value = nullptr;
+    entry->next = cache->free_head;
+    cache->free_head = index;
+    cache->count--;
+}
+
+void ip_cache_insert(struct ip_cache *cache, int64_t vpid, uint64_t ip, gpointer value)
+{
+    struct ip_cache_entry *entry;
+    guint slot_index;
+    guint index;
+
+    BT_ASSERT_DBG(value);
+
+    if (cache->count == cache->capacity) {
+        ip_cache_remove(cache, cache->lru_tail);
+        cache->stats.evictions++;
+    }
+
+    /* Take a free entry */
+    index = cache->free_head;
+    BT_ASSERT_DBG(index != IP_CACHE_NO_ENTRY);
+    entry = &cache->entries[index];
+    cache->free_head = entry->next;
+    entry->vpid = vpid;
+    entry->ip = ip;
+    entry->value = value;
+    ip_cache_lru_push_front(cache, index);
+    cache->count++;
+
+    /* Find an empty slot */
+    slot_index = ip_cache_hash(cache, vpid, ip);
+
+    while (cache->slots[slot_index] != 0) {
+        BT_ASSERT_DBG(cache->entries[cache->slots[slot_index] - 1].ip != ip ||
+                      cache->entries[cache->slots[slot_index] - 1].vpid != vpid);
+        slot_index = (slot_index + 1) & cache->slot_mask;
+    }
+
+    cache->slots[slot_index] = index + 1;
+    cache->stats.insertions++;
+}
+
+void ip_cache_invalidate_range(struct ip_cache *cache, int64_t vpid, uint64_t low_addr,
+                               uint64_t high_addr)
+{
+    guint index = cache->lru_head;
+
+    while (index != IP_CACHE_NO_ENTRY) {
+        const struct ip_cache_entry *entry = &cache->entries[index];
+        const guint next_index = entry->next;
+
+        if (entry->vpid == vpid && entry->ip >= low_addr && entry->ip < high_addr) {
+            ip_cache_remove(cache, index);
+            cache->stats.invalidations++;
+        }
+
+        index = next_index;
+    }
+}
+
+void ip_cache_invalidate_vpid(struct ip_cache *cache, int64_t vpid)
+{
+    guint index = cache->lru_head;
+
+    while (index != IP_CACHE_NO_ENTRY) {
+        const guint next_index = cache->entries[index].next;
+
+        if (cache->entries[index].vpid == vpid) {
+            ip_cache_remove(cache, index);
+            cache->stats.invalidations++;
+        }
+
+        index = next_index;
+    }
+}
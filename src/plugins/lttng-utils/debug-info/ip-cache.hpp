@@ -0,0 +1,139 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ *
+ * Babeltrace - Bounded (VPID, IP) cache
+ */
+
+#ifndef BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_IP_CACHE_HPP
+#define BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_IP_CACHE_HPP
+
+#include <glib.h>
+#include <stdint.h>
+
+/*
+ * Fixed-capacity cache of values keyed by (VPID, IP), with a least
+ * recently used (LRU) eviction policy.
+ *
+ * The entries are preallocated and the hash table uses open addressing
+ * with linear probing, so that neither a lookup nor an insertion
+ * allocates memory.
+ */
+struct ip_cache_entry
+{
+    int64_t vpid;
+    uint64_t ip;
+
+    /* Owned by the cache */
+    gpointer value;
+
+    /*
+     * Indexes of the previous (more recently used) and next (less
+     * recently used) entries in the LRU list, or `IP_CACHE_NO_ENTRY`.
+     *
+     * For a free entry, `next` is the index of the next free entry.
+     */
+    guint prev;
+    guint next;
+};
+
+struct ip_cache_stats
+{
+    uint64_t lookups;
+    uint64_t hits;
+    uint64_t insertions;
+    uint64_t evictions;
+    uint64_t invalidations;
+};
+
+struct ip_cache
+{
+    /* Array of `capacity` entries */
+    struct ip_cache_entry *entries;
+    guint capacity;
+
+    /* Number of used entries */
+    guint count;
+
+    /*
+     * Hash table slots: index of an entry plus one, or 0 for an empty
+     * slot. The slot count is a power of two, at least twice the
+     * capacity, so that probe sequences remain short.
+     */
+    guint *slots;
+    guint slot_mask;
+
+    /* Most and least recently used entries */
+    guint lru_head;
+    guint lru_tail;
+
+    /* First free entry */
+    guint free_head;
+
+    GDestroyNotify value_destroy;
+    struct ip_cache_stats stats;
+};
+
+#define IP_CACHE_NO_ENTRY G_MAXUINT
+
+/*
+ * Creates a cache of `capacity` entries (greater than 0).
+ *
+ * `value_destroy`, if not `nullptr`, is called for each value which
+ * the cache evicts, invalidates, or owns when it's destroyed.
+ */
+struct ip_cache *ip_cache_create(guint capacity, GDestroyNotify value_destroy);
+
+void ip_cache_destroy(struct ip_cache *cache);
+
+/*
+ * Returns the value of the entry (`vpid`, `ip`) of `cache`, making it
+ * the most recently used one, or `nullptr` if there's none.
+ *
+ * The returned value remains valid until the next insertion or
+ * invalidation.
+ */
+gpointer ip_cache_lookup(struct ip_cache *cache, int64_t vpid, uint64_t ip);
+
+/*
+ * Returns whether or not `cache` contains the entry (`vpid`, `ip`),
+ * without counting a lookup nor making it the most recently used one.
+ */
+bool ip_cache_contains(const struct ip_cache *cache, int64_t vpid, uint64_t ip);
+
+/*
+ * Adds the entry (`vpid`, `ip`) with the value `value` (not `nullptr`)
+ * to `cache`, evicting the least recently used entry if `cache` is
+ * full.
+ *
+ * `cache` must not contain an entry (`vpid`, `ip`).
+ */
+void ip_cache_insert(struct ip_cache *cache, int64_t vpid, uint64_t ip, gpointer value);
+
+/*
+ * Removes the entries of `cache` having the VPID `vpid` and an IP
+ * within [`low_addr`, `high_addr`[.
+ */
+void ip_cache_invalidate_range(struct ip_cache *cache, int64_t vpid, uint64_t low_addr,
+                               uint64_t high_addr);
+
+/*
+ * Removes all the entries of `cache` having the VPID `vpid`.
+ */
+void ip_cache_invalidate_vpid(struct ip_cache *cache, int64_t vpid);
+
+/*
+ * Returns the ratio of lookups of `cache` which were hits, between 0
+ * and 1.
+ */
+static inline double ip_cache_hit_rate(const struct ip_cache *cache)
+{
+    if (cache->stats.lookups == 0) {
+        return 0;
+    }
+
+    return (double) cache->stats.hits / (double) cache->stats.lookups;
+}
+
+#endif /* BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_IP_CACHE_HPP */
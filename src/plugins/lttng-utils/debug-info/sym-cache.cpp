@@ -0,0 +1,489 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ *
+ * Babeltrace - Persistent symbolization cache
+ */
+
+#define BT_COMP_LOG_SELF_COMP (cache->self_comp)
+#define BT_LOG_OUTPUT_LEVEL   (cache->log_level)
+#define BT_LOG_TAG            "PLUGIN/FLT.LTTNG-UTILS.DEBUG-INFO/SYM-CACHE"
+
+#include <algorithm>
+
+#include <glib.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "logging/comp-logging.h"
+
+#include "common/assert.h"
+
+#include "bin-info.hpp"
+#include "sym-cache.hpp"
+
+#define SYM_CACHE_FILE_MAGIC   0x42544353
+#define SYM_CACHE_FILE_VERSION 1
+#define SYM_CACHE_FILE_SUFFIX  ".sym"
+
+/* No string (string offset) */
+#define SYM_CACHE_NO_STRING UINT32_MAX
+
+/* The source location is known */
+#define SYM_CACHE_ENTRY_FLAG_HAS_SRC_LOC (1U << 0)
+
+/*
+ * A cache file, in the native byte order, is:
+ *
+ * 1. A header.
+ * 2. `entry_count` entries, sorted by offset.
+ * 3. `strings_size` bytes of null-terminated strings.
+ */
+struct sym_cache_file_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t entry_count;
+    uint64_t strings_size;
+};
+
+struct sym_cache_file_entry
+{
+    uint64_t offset;
+    uint64_t line_no;
+
+    /* Offsets of strings, or `SYM_CACHE_NO_STRING` */
+    uint32_t func_offset;
+    uint32_t src_path_offset;
+
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+struct sym_cache_file
+{
+    /* Weak */
+    struct sym_cache *cache;
+
+    gchar *path;
+
+    /* Loaded file, or `nullptr` if none (or invalid) */
+    GMappedFile *mapped_file;
+
+    /* Point within `mapped_file` */
+    const struct sym_cache_file_entry *entries;
+    uint64_t entry_count;
+    const char *strings;
+    uint64_t strings_size;
+
+    /*
+     * New entries (`struct sym_cache_file_entry`), of which the
+     * string offsets are within `new_strings`.
+     */
+    GArray *new_entries;
+    GString *new_strings;
+
+    /* Offset (`uint64_t *`) to index of new entry plus one */
+    GHashTable *new_entry_indexes;
+};
+
+struct sym_cache
+{
+    bt_logging_level log_level;
+
+    /* Used for logging; can be `nullptr` */
+    bt_self_component *self_comp;
+
+    gchar *dir_path;
+
+    /* File name to `struct sym_cache_file *` (owned by this) */
+    GHashTable *files;
+};
+
+static void sym_cache_file_destroy(struct sym_cache_file *file)
+{
+    if (!file) {
+        return;
+    }
+
+    if (file->new_entry_indexes) {
+        g_hash_table_destroy(file->new_entry_indexes);
+    }
+
+    if (file->new_entries) {
+        g_array_free(file->new_entries, TRUE);
+    }
+
+    if (file->new_strings) {
+        g_string_free(file->new_strings, TRUE);
+    }
+
+    if (file->mapped_file) {
+        g_mapped_file_unref(file->mapped_file);
+    }
+
+    g_free(file->path);
+    g_free(file);
+}
+
+/*
+ * Maps the existing file of `file`, if any and valid.
+ */
+static void sym_cache_file_load(struct sym_cache_file *file)
+{
+    struct sym_cache *cache = file->cache;
+    const struct sym_cache_file_header *header;
+    GError *error = nullptr;
+    const char *data;
+    gsize size;
+
+    file->mapped_file = g_mapped_file_new(file->path, FALSE, &error);
+    if (!file->mapped_file) {
+        BT_COMP_LOGD("No symbolization cache file: path=\"%s\", msg=\"%s\"", file->path,
+                     error->message);
+        g_error_free(error);
+        return;
+    }
+
+    data = g_mapped_file_get_contents(file->mapped_file);
+    size = g_mapped_file_get_length(file->mapped_file);
+    header = (const struct sym_cache_file_header *) data;
+
+    if (size < sizeof(*header) || header->magic != SYM_CACHE_FILE_MAGIC ||
+        header->version != SYM_CACHE_FILE_VERSION ||
+        header->entry_count > (size - sizeof(*header)) / sizeof(struct sym_cache_file_entry) ||
+        header->strings_size !=
+            size - sizeof(*header) - header->entry_count * sizeof(struct sym_cache_file_entry) ||
+        (header->strings_size > 0 && data[size - 1] != '\0')) {
+        BT_COMP_LOGW("Ignoring invalid symbolization cache file: path=\"%s\"", file->path);
+        g_mapped_file_unref(file->mapped_file);
+        file->mapped_file = nullptr;
+        return;
+    }
+
+    file->entries = (const struct sym_cache_file_entry *) (data + sizeof(*header));
+    file->entry_count = header->entry_count;
+    file->strings = (const char *) (file->entries + file->entry_count);
+    file->strings_size = header->strings_size;
+    BT_COMP_LOGI("Loaded symbolization cache file: path=\"%s\", entry-count=%" PRIu64,
+                 file->path, file->entry_count);
+}
+
+static struct sym_cache_file *sym_cache_file_create(struct sym_cache *cache, const char *name)
+{
+    struct sym_cache_file *file = g_new0(struct sym_cache_file, 1);
+
+    if (!file) {
+        goto error;
+    }
+
+    file->cache = cache;
+    file->path = g_build_filename(cache->dir_path, name, nullptr);
+    file->new_entries = g_array_new(FALSE, FALSE, sizeof(struct sym_cache_file_entry));
+    file->new_strings = g_string_new(nullptr);
+    file->new_entry_indexes =
+        g_hash_table_new_full(g_int64_hash, g_int64_equal, (GDestroyNotify) g_free, nullptr);
+    if (!file->path || !file->new_entries || !file->new_strings || !file->new_entry_indexes) {
+        goto error;
+    }
+
+    sym_cache_file_load(file);
+    return file;
+
+error:
+    sym_cache_file_destroy(file);
+    return nullptr;
+}
+
+/*
+ * Returns the string at the offset `offset` within `strings`, or
+ * `nullptr` if none.
+ */
+static inline const char *entry_string(const char *strings, uint64_t strings_size,
+                                       uint32_t offset)
+{
+    if (offset == SYM_CACHE_NO_STRING || offset >= strings_size) {
+        return nullptr;
+    }
+
+    return &strings[offset];
+}
+
+static void set_result_from_entry(const struct sym_cache_file_entry *entry, const char *strings,
+                                  uint64_t strings_size, struct sym_cache_result *result)
+{
+    result->func = entry_string(strings, strings_size, entry->func_offset);
+    result->has_src_loc = entry->flags & SYM_CACHE_ENTRY_FLAG_HAS_SRC_LOC;
+    result->src_path = entry_string(strings, strings_size, entry->src_path_offset);
+    result->line_no = entry->line_no;
+}
+
+bool sym_cache_file_lookup(struct sym_cache_file *file, uint64_t offset,
+                           struct sym_cache_result *result)
+{
+    gpointer index_plus_one;
+
+    /* Loaded entries first: binary search */
+    if (file->entry_count > 0) {
+        const struct sym_cache_file_entry *end = file->entries + file->entry_count;
+        const struct sym_cache_file_entry *entry = std::lower_bound(
+            file->entries, end, offset,
+            [](const struct sym_cache_file_entry& cur_entry, uint64_t cur_offset) {
+                return cur_entry.offset < cur_offset;
+            });
+
+        if (entry != end && entry->offset == offset) {
+            set_result_from_entry(entry, file->strings, file->strings_size, result);
+            return true;
+        }
+    }
+
+    index_plus_one = g_hash_table_lookup(file->new_entry_indexes, &offset);
+    if (index_plus_one) {
+        set_result_from_entry(&g_array_index(file->new_entries, struct sym_cache_file_entry,
+                                             GPOINTER_TO_UINT(index_plus_one) - 1),
+                              file->new_strings->str, file->new_strings->len, result);
+        return true;
+    }
+
+    return false;
+}
+
+static uint32_t append_new_string(struct sym_cache_file *file, const char *str)
+{
+    uint32_t offset;
+
+    if (!str) {
+        return SYM_CACHE_NO_STRING;
+    }
+
+    offset = file->new_strings->len;
+    g_string_append_len(file->new_strings, str, strlen(str) + 1);
+    return offset;
+}
+
+void sym_cache_file_add(struct sym_cache_file *file, uint64_t offset,
+                        const struct sym_cache_result *result)
+{
+    struct sym_cache_file_entry entry = {};
+    uint64_t *key;
+
+    if (file->new_strings->len >= SYM_CACHE_NO_STRING / 2) {
+        /* Don't let the string offsets overflow */
+        return;
+    }
+
+    entry.offset = offset;
+    entry.line_no = result->line_no;
+    entry.func_offset = append_new_string(file, result->func);
+    entry.src_path_offset = append_new_string(file, result->src_path);
+    entry.flags = result->has_src_loc ? SYM_CACHE_ENTRY_FLAG_HAS_SRC_LOC : 0;
+
+    key = g_new(uint64_t, 1);
+    *key = offset;
+    g_array_append_val(file->new_entries, entry);
+    g_hash_table_insert(file->new_entry_indexes, key, GUINT_TO_POINTER(file->new_entries->len));
+}
+
+/*
+ * Writes the loaded and new entries of `file` to a new version of its
+ * file, atomically replacing the previous one.
+ */
+static void sym_cache_file_write(struct sym_cache_file *file)
+{
+    struct sym_cache *cache = file->cache;
+    struct sym_cache_file_header header = {};
+    GArray *entries = nullptr;
+    GString *contents = nullptr;
+    GError *error = nullptr;
+    guint i;
+
+    if (file->new_entries->len == 0) {
+        goto end;
+    }
+
+    if (file->strings_size + file->new_strings->len >= SYM_CACHE_NO_STRING) {
+        BT_COMP_LOGW("Symbolization cache file would be too large: path=\"%s\"", file->path);
+        goto end;
+    }
+
+    /*
+     * Merge the loaded and new entries: the strings of the new
+     * entries follow the loaded strings.
+     */
+    entries = g_array_sized_new(FALSE, FALSE, sizeof(struct sym_cache_file_entry),
+                                file->entry_count + file->new_entries->len);
+    g_array_append_vals(entries, file->entries, file->entry_count);
+
+    for (i = 0; i < file->new_entries->len; i++) {
+        struct sym_cache_file_entry entry =
+            g_array_index(file->new_entries, struct sym_cache_file_entry, i);
+
+        if (entry.func_offset != SYM_CACHE_NO_STRING) {
+            entry.func_offset += file->strings_size;
+        }
+
+        if (entry.src_path_offset != SYM_CACHE_NO_STRING) {
+            entry.src_path_offset += file->strings_size;
+        }
+
+        g_array_append_val(entries, entry);
+    }
+
+    std::sort(&g_array_index(entries, struct sym_cache_file_entry, 0),
+              &g_array_index(entries, struct sym_cache_file_entry, 0) + entries->len,
+              [](const struct sym_cache_file_entry& a, const struct sym_cache_file_entry& b) {
+                  return a.offset < b.offset;
+              });
+
+    header.magic = SYM_CACHE_FILE_MAGIC;
+    header.version = SYM_CACHE_FILE_VERSION;
+    header.entry_count = entries->len;
+    header.strings_size = file->strings_size + file->new_strings->len;
+    contents = g_string_sized_new(sizeof(header) +
+                                  entries->len * sizeof(struct sym_cache_file_entry) +
+                                  header.strings_size);
+    g_string_append_len(contents, (const char *) &header, sizeof(header));
+    g_string_append_len(contents, entries->data,
+                        entries->len * sizeof(struct sym_cache_file_entry));
+    g_string_append_len(contents, file->strings, file->strings_size);
+    g_string_append_len(contents, file->new_strings->str, file->new_strings->len);
+
+    if (!g_file_set_contents(file->path, contents->str, contents->len, &error)) {
+        BT_COMP_LOGW("Cannot write symbolization cache file: path=\"%s\", msg=\"%s\"",
+                     file->path, error->message);
+        g_error_free(error);
+        goto end;
+    }
+
+    BT_COMP_LOGI("Wrote symbolization cache file: path=\"%s\", entry-count=%u, "
+                 "new-entry-count=%u",
+                 file->path, entries->len, file->new_entries->len);
+
+end:
+    if (entries) {
+        g_array_free(entries, TRUE);
+    }
+
+    if (contents) {
+        g_string_free(contents, TRUE);
+    }
+}
+
+struct sym_cache *sym_cache_create(const char *dir_path, bt_logging_level log_level,
+                                   bt_self_component *self_comp)
+{
+    struct sym_cache *cache = g_new0(struct sym_cache, 1);
+
+    if (!cache) {
+        goto error;
+    }
+
+    cache->log_level = log_level;
+    cache->self_comp = self_comp;
+
+    if (g_mkdir_with_parents(dir_path, 0755)) {
+        BT_COMP_LOGE_APPEND_CAUSE_ERRNO(self_comp, "Cannot create symbolization cache directory",
+                                        ": path=\"%s\"", dir_path);
+        goto error;
+    }
+
+    cache->dir_path = g_strdup(dir_path);
+    cache->files = g_hash_table_new_full(g_str_hash, g_str_equal, (GDestroyNotify) g_free,
+                                         (GDestroyNotify) sym_cache_file_destroy);
+    if (!cache->dir_path || !cache->files) {
+        goto error;
+    }
+
+    return cache;
+
+error:
+    sym_cache_destroy(cache);
+    return nullptr;
+}
+
+void sym_cache_destroy(struct sym_cache *cache)
+{
+    if (!cache) {
+        return;
+    }
+
+    if (cache->files) {
+        GHashTableIter iter;
+        gpointer file;
+
+        g_hash_table_iter_init(&iter, cache->files);
+
+        while (g_hash_table_iter_next(&iter, nullptr, &file)) {
+            sym_cache_file_write(static_cast<sym_cache_file *>(file));
+        }
+
+        g_hash_table_destroy(cache->files);
+    }
+
+    g_free(cache->dir_path);
+    g_free(cache);
+}
+
+/*
+ * Returns the cache file name of `bin`, or `nullptr` if `bin` has no
+ * identity.
+ */
+static gchar *bin_file_name(const struct bin_info *bin)
+{
+    if (bin->build_id && bin->build_id_len > 0) {
+        GString *name = g_string_sized_new(bin->build_id_len * 2 + sizeof(SYM_CACHE_FILE_SUFFIX));
+        size_t i;
+
+        for (i = 0; i < bin->build_id_len; i++) {
+            g_string_append_printf(name, "%02x", bin->build_id[i]);
+        }
+
+        g_string_append(name, SYM_CACHE_FILE_SUFFIX);
+        return g_string_free(name, FALSE);
+    }
+
+    if (bin->dbg_link_filename) {
+        gchar *name = g_strdup_printf("dbglink-%08" PRIx32 "-%s" SYM_CACHE_FILE_SUFFIX,
+                                      bin->dbg_link_crc, bin->dbg_link_filename);
+        gchar *ch;
+
+        /* A debug link is a file name, but make sure */
+        for (ch = name; *ch; ch++) {
+            if (G_IS_DIR_SEPARATOR(*ch)) {
+                *ch = '_';
+            }
+        }
+
+        return name;
+    }
+
+    return nullptr;
+}
+
+struct sym_cache_file *sym_cache_borrow_file(struct sym_cache *cache, const struct bin_info *bin)
+{
+    struct sym_cache_file *file;
+    gchar *name = bin_file_name(bin);
+
+    if (!name) {
+        return nullptr;
+    }
+
+    file = static_cast<sym_cache_file *>(g_hash_table_lookup(cache->files, name));
+    if (file) {
+        g_free(name);
+        return file;
+    }
+
+    file = sym_cache_file_create(cache, name);
+    if (!file) {
+        g_free(name);
+        return nullptr;
+    }
+
+    /* Ownership of `name` passed to the hash table */
+    g_hash_table_insert(cache->files, name, file);
+    return file;
+}
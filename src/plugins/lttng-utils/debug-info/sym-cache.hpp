@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ *
+ * Babeltrace - Persistent symbolization cache
+ */
+
+#ifndef BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_SYM_CACHE_HPP
+#define BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_SYM_CACHE_HPP
+
+#include <glib.h>
+#include <stdint.h>
+
+#include <babeltrace2/babeltrace.h>
+
+struct bin_info;
+
+/*
+ * Persistent symbolization cache.
+ *
+ * A symbolization cache is a directory containing one file per binary,
+ * named after its build ID or, without a build ID, after its debug link
+ * CRC and file name. A binary without both isn't cached.
+ *
+ * A cache file contains the symbolization results (function name and
+ * source location) of offsets within the binary, sorted by offset so
+ * that a lookup is a binary search within the memory-mapped file.
+ *
+ * The cache file of a binary is loaded on its first lookup. New results
+ * are kept in memory and written back, merged with the loaded ones,
+ * when the cache is destroyed.
+ */
+struct sym_cache;
+
+/*
+ * Symbolization cache file of a single binary.
+ */
+struct sym_cache_file;
+
+/*
+ * Symbolization result of an offset.
+ *
+ * The strings belong to the cache file: they're only valid until the
+ * next sym_cache_file_add() call.
+ */
+struct sym_cache_result
+{
+    /* Function name, or `nullptr` if unknown */
+    const char *func;
+
+    /* Whether or not the source location is known */
+    bool has_src_loc;
+
+    /* Source file path, or `nullptr` if unknown */
+    const char *src_path;
+
+    uint64_t line_no;
+};
+
+/*
+ * Creates a symbolization cache using the directory `dir_path`,
+ * creating it if needed.
+ */
+struct sym_cache *sym_cache_create(const char *dir_path, bt_logging_level log_level,
+                                   bt_self_component *self_comp);
+
+/*
+ * Writes back the new results of `cache`, and destroys it.
+ */
+void sym_cache_destroy(struct sym_cache *cache);
+
+/*
+ * Borrows the cache file of the binary `bin`, loading it if needed.
+ *
+ * Returns `nullptr` if `bin` has neither a build ID nor a debug link.
+ */
+struct sym_cache_file *sym_cache_borrow_file(struct sym_cache *cache, const struct bin_info *bin);
+
+/*
+ * Looks up the result of the offset `offset` within `file`.
+ *
+ * Returns true and sets `*result` if found.
+ */
+bool sym_cache_file_lookup(struct sym_cache_file *file, uint64_t offset,
+                           struct sym_cache_result *result);
+
+/*
+ * Adds the result `result` of the offset `offset` to `file`.
+ */
+void sym_cache_file_add(struct sym_cache_file *file, uint64_t offset,
+                        const struct sym_cache_result *result);
+
+#endif /* BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_SYM_CACHE_HPP */
@@ -0,0 +1,125 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ *
+ * Babeltrace - Symbolization worker threads
+ */
+
+#define BT_COMP_LOG_SELF_COMP (workers->self_comp)
+#define BT_LOG_OUTPUT_LEVEL   (workers->log_level)
+#define BT_LOG_TAG            "PLUGIN/FLT.LTTNG-UTILS.DEBUG-INFO/SYM-WORKERS"
+#include <system_error>
+
+#include "logging/comp-logging.h"
+
+#include "common/assert.h"
+
+#include "sym-workers.hpp"
+
+static void sym_workers_thread_func(struct sym_workers *workers)
+{
+    std::unique_lock<std::mutex> lock {workers->mutex};
+
+    while (true) {
+        gpointer job;
+
+        workers->job_avail_cond.wait(lock, [workers] {
+            return workers->quit || !workers->jobs.empty();
+        });
+
+        if (workers->jobs.empty()) {
+            /* Quitting */
+            break;
+        }
+
+        job = workers->jobs.front();
+        workers->jobs.pop_front();
+        lock.unlock();
+        workers->job_func(job);
+
+        /*
+         * Nothing reports the error causes which the job appended
+         * to the error of this thread: the graph thread handles a
+         * failed symbolization like a missing one.
+         */
+        bt_current_thread_clear_error();
+        lock.lock();
+        BT_ASSERT_DBG(workers->pending_job_count > 0);
+        workers->pending_job_count--;
+
+        if (workers->pending_job_count == 0) {
+            workers->done_cond.notify_all();
+        }
+    }
+}
+
+struct sym_workers *sym_workers_create(unsigned int thread_count, sym_workers_job_func job_func,
+                                       bt_logging_level log_level, bt_self_component *self_comp)
+{
+    struct sym_workers *workers = new sym_workers;
+
+    BT_ASSERT(thread_count > 0);
+    BT_ASSERT(job_func);
+    workers->log_level = log_level;
+    workers->self_comp = self_comp;
+    workers->job_func = job_func;
+
+    try {
+        for (unsigned int i = 0; i < thread_count; i++) {
+            workers->threads.emplace_back(sym_workers_thread_func, workers);
+        }
+    } catch (const std::system_error& exc) {
+        BT_COMP_LOGE_APPEND_CAUSE(self_comp, "Failed to create symbolization worker thread: %s",
+                                  exc.what());
+        sym_workers_destroy(workers);
+        return nullptr;
+    }
+
+    BT_COMP_LOGI("Created symbolization worker threads: count=%u", thread_count);
+    return workers;
+}
+
+void sym_workers_destroy(struct sym_workers *workers)
+{
+    if (!workers) {
+        return;
+    }
+
+    sym_workers_wait(workers);
+
+    {
+        std::lock_guard<std::mutex> lock {workers->mutex};
+
+        workers->quit = true;
+    }
+
+    workers->job_avail_cond.notify_all();
+
+    for (std::thread& thread : workers->threads) {
+        thread.join();
+    }
+
+    delete workers;
+}
+
+void sym_workers_submit(struct sym_workers *workers, gpointer job)
+{
+    {
+        std::lock_guard<std::mutex> lock {workers->mutex};
+
+        workers->jobs.push_back(job);
+        workers->pending_job_count++;
+    }
+
+    workers->job_avail_cond.notify_one();
+}
+
+void sym_workers_wait(struct sym_workers *workers)
+{
+    std::unique_lock<std::mutex> lock {workers->mutex};
+
+    workers->done_cond.wait(lock, [workers] {
+        return workers->pending_job_count == 0;
+    });
+}
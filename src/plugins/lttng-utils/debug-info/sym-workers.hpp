@@ -0,0 +1,88 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ *
+ * Babeltrace - Symbolization worker threads
+ */
+
+#ifndef BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_SYM_WORKERS_HPP
+#define BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_SYM_WORKERS_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glib.h>
+
+#include <babeltrace2/babeltrace.h>
+
+/*
+ * Function which a worker thread calls to execute the job `job`.
+ */
+typedef void (*sym_workers_job_func)(gpointer job);
+
+/*
+ * Pool of symbolization worker threads.
+ *
+ * The graph thread submits jobs, and then waits for all of them to be
+ * executed before accessing anything which the jobs access: the pool
+ * doesn't synchronize the jobs with the graph thread otherwise.
+ *
+ * Jobs which the worker threads execute concurrently must not access
+ * the same objects.
+ */
+struct sym_workers
+{
+    bt_logging_level log_level;
+    bt_self_component *self_comp;
+    sym_workers_job_func job_func;
+    std::vector<std::thread> threads;
+
+    /* Protects all the members below */
+    std::mutex mutex;
+
+    /* Signaled when `jobs` becomes non-empty or `quit` becomes true */
+    std::condition_variable job_avail_cond;
+
+    /* Signaled when `pending_job_count` becomes 0 */
+    std::condition_variable done_cond;
+
+    /* Submitted jobs which no worker thread took yet (weak) */
+    std::deque<gpointer> jobs;
+
+    /* Number of submitted jobs which aren't executed yet */
+    unsigned int pending_job_count = 0;
+
+    /* True to make the worker threads quit */
+    bool quit = false;
+};
+
+/*
+ * Creates a pool of `thread_count` (greater than 0) worker threads
+ * which execute jobs with `job_func`.
+ *
+ * Returns `nullptr` if a worker thread can't be created.
+ */
+struct sym_workers *sym_workers_create(unsigned int thread_count, sym_workers_job_func job_func,
+                                       bt_logging_level log_level, bt_self_component *self_comp);
+
+/*
+ * Waits for the pending jobs of `workers`, and then destroys it,
+ * joining its worker threads.
+ */
+void sym_workers_destroy(struct sym_workers *workers);
+
+/*
+ * Submits the job `job` to `workers`.
+ */
+void sym_workers_submit(struct sym_workers *workers, gpointer job);
+
+/*
+ * Waits until `workers` executed all the submitted jobs.
+ */
+void sym_workers_wait(struct sym_workers *workers);
+
+#endif /* BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_SYM_WORKERS_HPP */
@@ -12,6 +12,7 @@
 #define BT_LOG_TAG            "PLUGIN/FLT.LTTNG-UTILS.DEBUG-INFO/TRACE-IR-DATA-COPY"
 #include <inttypes.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "logging/comp-logging.h"
 
@@ -192,8 +193,288 @@ end:
     return status;
 }
 
+static enum debug_info_trace_ir_mapping_status
+copy_field_content_with_plan(const struct field_copy_plan *plan, const bt_field *in_field,
+                             bt_field *out_field, bt_logging_level log_level,
+                             bt_self_component *self_comp);
+
+/*
+ * Copies the content of the input field `in_field`, of which the copy
+ * operation kind is the leaf kind `kind`, to the output field
+ * `out_field`.
+ */
+static inline enum debug_info_trace_ir_mapping_status
+copy_leaf_field_content(enum field_copy_op_kind kind, const bt_field *in_field,
+                        bt_field *out_field, bt_logging_level log_level,
+                        bt_self_component *self_comp)
+{
+    switch (kind) {
+    case FIELD_COPY_OP_KIND_BOOL:
+        bt_field_bool_set_value(out_field, bt_field_bool_get_value(in_field));
+        break;
+    case FIELD_COPY_OP_KIND_BIT_ARRAY:
+        bt_field_bit_array_set_value_as_integer(out_field,
+                                                bt_field_bit_array_get_value_as_integer(in_field));
+        break;
+    case FIELD_COPY_OP_KIND_UNSIGNED_INTEGER:
+        bt_field_integer_unsigned_set_value(out_field,
+                                            bt_field_integer_unsigned_get_value(in_field));
+        break;
+    case FIELD_COPY_OP_KIND_SIGNED_INTEGER:
+        bt_field_integer_signed_set_value(out_field, bt_field_integer_signed_get_value(in_field));
+        break;
+    case FIELD_COPY_OP_KIND_SINGLE_PRECISION_REAL:
+        bt_field_real_single_precision_set_value(
+            out_field, bt_field_real_single_precision_get_value(in_field));
+        break;
+    case FIELD_COPY_OP_KIND_DOUBLE_PRECISION_REAL:
+        bt_field_real_double_precision_set_value(
+            out_field, bt_field_real_double_precision_get_value(in_field));
+        break;
+    case FIELD_COPY_OP_KIND_STRING:
+    {
+        /*
+         * Clear and append with the known length: the output string
+         * field keeps its buffer, and this avoids measuring the input
+         * string again.
+         */
+        uint64_t len = bt_field_string_get_length(in_field);
+        bt_field_string_append_status append_status;
+
+        bt_field_string_clear(out_field);
+        append_status =
+            bt_field_string_append_with_length(out_field, bt_field_string_get_value(in_field), len);
+        if (append_status != BT_FIELD_STRING_APPEND_STATUS_OK) {
+            BT_COMP_LOGE_APPEND_CAUSE(self_comp,
+                                      "Cannot set string field's value: "
+                                      "out-str-f-addr=%p, len=%" PRIu64,
+                                      out_field, len);
+            return static_cast<debug_info_trace_ir_mapping_status>(append_status);
+        }
+
+        break;
+    }
+    case FIELD_COPY_OP_KIND_STATIC_BLOB:
+    case FIELD_COPY_OP_KIND_DYNAMIC_BLOB:
+    {
+        uint64_t in_length = bt_field_blob_get_length(in_field);
+
+        if (kind == FIELD_COPY_OP_KIND_DYNAMIC_BLOB) {
+            enum bt_field_blob_dynamic_set_length_status set_length_status =
+                bt_field_blob_dynamic_set_length(out_field, in_length);
+
+            if (set_length_status != BT_FIELD_DYNAMIC_BLOB_SET_LENGTH_STATUS_OK) {
+                BT_COMP_LOGE_APPEND_CAUSE(self_comp,
+                                          "Cannot set dynamic BLOB field length: "
+                                          "out-blob-f-addr=%p, len=%" PRIu64,
+                                          out_field, in_length);
+                return static_cast<debug_info_trace_ir_mapping_status>(set_length_status);
+            }
+        }
+
+        BT_ASSERT_DBG(bt_field_blob_get_length(out_field) == in_length);
+        memcpy(bt_field_blob_get_data(out_field), bt_field_blob_get_data_const(in_field),
+               in_length);
+        break;
+    }
+    default:
+        bt_common_abort();
+    }
+
+    return DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK;
+}
+
+static enum debug_info_trace_ir_mapping_status
+copy_struct_field_content_with_plan(const struct field_copy_plan *plan, const bt_field *in_field,
+                                    bt_field *out_field, bt_logging_level log_level,
+                                    bt_self_component *self_comp)
+{
+    enum debug_info_trace_ir_mapping_status status;
+    guint i;
+
+    /* Leaf members first: no recursion */
+    for (i = 0; i < plan->leaf_member_op_count; i++) {
+        const struct field_copy_member_op *op =
+            &g_array_index(plan->member_ops, struct field_copy_member_op, i);
+
+        status = copy_leaf_field_content(
+            op->kind, bt_field_structure_borrow_member_field_by_index_const(in_field, op->in_index),
+            bt_field_structure_borrow_member_field_by_index(out_field, op->out_index), log_level,
+            self_comp);
+        if (status != DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK) {
+            goto error;
+        }
+    }
+
+    for (; i < plan->member_ops->len; i++) {
+        const struct field_copy_member_op *op =
+            &g_array_index(plan->member_ops, struct field_copy_member_op, i);
+
+        status = copy_field_content_with_plan(
+            op->plan, bt_field_structure_borrow_member_field_by_index_const(in_field, op->in_index),
+            bt_field_structure_borrow_member_field_by_index(out_field, op->out_index), log_level,
+            self_comp);
+        if (status != DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK) {
+            goto error;
+        }
+    }
+
+    status = DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK;
+    goto end;
+
+error:
+    BT_COMP_LOGE_APPEND_CAUSE(self_comp,
+                              "Cannot copy struct member field: "
+                              "out-struct-f-addr=%p, in-member-index=%" PRIu64,
+                              out_field,
+                              g_array_index(plan->member_ops, struct field_copy_member_op, i)
+                                  .in_index);
+
+end:
+    return status;
+}
+
+/*
+ * Copies the content of the input field `in_field` to the output field
+ * `out_field` following the plan `plan`.
+ *
+ * Unlike copy_field_content(), this function doesn't need to find the
+ * type of the fields nor the output structure field members by name.
+ */
+static enum debug_info_trace_ir_mapping_status
+copy_field_content_with_plan(const struct field_copy_plan *plan, const bt_field *in_field,
+                             bt_field *out_field, bt_logging_level log_level,
+                             bt_self_component *self_comp)
+{
+    enum debug_info_trace_ir_mapping_status status;
+
+    BT_COMP_LOGT("Copying content of field with plan: in-f-addr=%p, out-f-addr=%p", in_field,
+                 out_field);
+
+    switch (plan->kind) {
+    case FIELD_COPY_OP_KIND_STRUCTURE:
+        status =
+            copy_struct_field_content_with_plan(plan, in_field, out_field, log_level, self_comp);
+        break;
+    case FIELD_COPY_OP_KIND_STATIC_ARRAY:
+    case FIELD_COPY_OP_KIND_DYNAMIC_ARRAY:
+    {
+        const struct field_copy_plan *elem_plan =
+            static_cast<const field_copy_plan *>(g_ptr_array_index(plan->sub_plans, 0));
+        uint64_t array_len = bt_field_array_get_length(in_field);
+
+        if (plan->kind == FIELD_COPY_OP_KIND_DYNAMIC_ARRAY) {
+            bt_field_array_dynamic_set_length_status set_len_status =
+                bt_field_array_dynamic_set_length(out_field, array_len);
+
+            if (set_len_status != BT_FIELD_DYNAMIC_ARRAY_SET_LENGTH_STATUS_OK) {
+                BT_COMP_LOGE_APPEND_CAUSE(self_comp,
+                                          "Cannot set dynamic array field's length field: "
+                                          "out-arr-f-addr=%p, arr-length=%" PRIu64,
+                                          out_field, array_len);
+                status = static_cast<debug_info_trace_ir_mapping_status>(set_len_status);
+                goto end;
+            }
+        }
+
+        status = DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK;
+
+        for (uint64_t i = 0; i < array_len; i++) {
+            const bt_field *in_element_field =
+                bt_field_array_borrow_element_field_by_index_const(in_field, i);
+            bt_field *out_element_field =
+                bt_field_array_borrow_element_field_by_index(out_field, i);
+
+            if (field_copy_op_kind_is_leaf(elem_plan->kind)) {
+                status = copy_leaf_field_content(elem_plan->kind, in_element_field,
+                                                 out_element_field, log_level, self_comp);
+            } else {
+                status = copy_field_content_with_plan(elem_plan, in_element_field,
+                                                      out_element_field, log_level, self_comp);
+            }
+
+            if (status != DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK) {
+                BT_COMP_LOGE_APPEND_CAUSE(self_comp,
+                                          "Cannot copy element field: "
+                                          "out-arr-f-addr=%p, out-arr-elem-f-addr=%p",
+                                          out_field, out_element_field);
+                goto end;
+            }
+        }
+
+        break;
+    }
+    case FIELD_COPY_OP_KIND_OPTION:
+    {
+        const bt_field *in_option_field = bt_field_option_borrow_field_const(in_field);
+        bt_field *out_option_field;
+
+        if (!in_option_field) {
+            bt_field_option_set_has_field(out_field, BT_FALSE);
+            status = DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK;
+            break;
+        }
+
+        bt_field_option_set_has_field(out_field, BT_TRUE);
+        out_option_field = bt_field_option_borrow_field(out_field);
+        BT_ASSERT_DBG(out_option_field);
+        status = copy_field_content_with_plan(
+            static_cast<const field_copy_plan *>(g_ptr_array_index(plan->sub_plans, 0)),
+            in_option_field, out_option_field, log_level, self_comp);
+        if (status != DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK) {
+            BT_COMP_LOGE_APPEND_CAUSE(self_comp,
+                                      "Cannot copy option field: "
+                                      "out-opt-f-addr=%p, out-opt-field-f-addr=%p",
+                                      out_field, out_option_field);
+            goto end;
+        }
+
+        break;
+    }
+    case FIELD_COPY_OP_KIND_VARIANT:
+    {
+        bt_field_variant_select_option_by_index_status sel_opt_status;
+        uint64_t in_selected_option_idx = bt_field_variant_get_selected_option_index(in_field);
+        bt_field *out_option_field;
+
+        sel_opt_status = bt_field_variant_select_option_by_index(out_field, in_selected_option_idx);
+        if (sel_opt_status != BT_FIELD_VARIANT_SELECT_OPTION_STATUS_OK) {
+            BT_COMP_LOGE_APPEND_CAUSE(self_comp,
+                                      "Cannot select variant field's option field: "
+                                      "out-var-f-addr=%p, opt-index=%" PRId64,
+                                      out_field, in_selected_option_idx);
+            status = static_cast<debug_info_trace_ir_mapping_status>(sel_opt_status);
+            goto end;
+        }
+
+        out_option_field = bt_field_variant_borrow_selected_option_field(out_field);
+        status = copy_field_content_with_plan(
+            static_cast<const field_copy_plan *>(
+                g_ptr_array_index(plan->sub_plans, in_selected_option_idx)),
+            bt_field_variant_borrow_selected_option_field_const(in_field), out_option_field,
+            log_level, self_comp);
+        if (status != DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK) {
+            BT_COMP_LOGE_APPEND_CAUSE(self_comp,
+                                      "Cannot copy element field: "
+                                      "out-var-f-addr=%p, out-opt-f-addr=%p",
+                                      out_field, out_option_field);
+            goto end;
+        }
+
+        break;
+    }
+    default:
+        status = copy_leaf_field_content(plan->kind, in_field, out_field, log_level, self_comp);
+        break;
+    }
+
+end:
+    return status;
+}
+
 enum debug_info_trace_ir_mapping_status copy_event_content(const bt_event *in_event,
                                                            bt_event *out_event,
+                                                           const struct event_copy_plan *plan,
                                                            bt_logging_level log_level,
                                                            bt_self_component *self_comp)
 {
@@ -201,14 +482,16 @@ enum debug_info_trace_ir_mapping_status copy_event_content(const bt_event *in_ev
     const bt_field *in_common_ctx_field, *in_specific_ctx_field, *in_payload_field;
     bt_field *out_common_ctx_field, *out_specific_ctx_field, *out_payload_field;
 
+    BT_ASSERT_DBG(plan);
     BT_COMP_LOGD("Copying content of event: in-e-addr=%p, out-e-addr=%p", in_event, out_event);
     in_common_ctx_field = bt_event_borrow_common_context_field_const(in_event);
     if (in_common_ctx_field) {
         out_common_ctx_field = bt_event_borrow_common_context_field(out_event);
         BT_ASSERT_DBG(out_common_ctx_field);
+        BT_ASSERT_DBG(plan->common_context);
 
-        status =
-            copy_field_content(in_common_ctx_field, out_common_ctx_field, log_level, self_comp);
+        status = copy_field_content_with_plan(plan->common_context, in_common_ctx_field,
+                                              out_common_ctx_field, log_level, self_comp);
         if (status != DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK) {
             BT_COMP_LOGE_APPEND_CAUSE(self_comp,
                                       "Cannot copy common context field: "
@@ -222,9 +505,10 @@ enum debug_info_trace_ir_mapping_status copy_event_content(const bt_event *in_ev
     if (in_specific_ctx_field) {
         out_specific_ctx_field = bt_event_borrow_specific_context_field(out_event);
         BT_ASSERT_DBG(out_specific_ctx_field);
+        BT_ASSERT_DBG(plan->specific_context);
 
-        status =
-            copy_field_content(in_specific_ctx_field, out_specific_ctx_field, log_level, self_comp);
+        status = copy_field_content_with_plan(plan->specific_context, in_specific_ctx_field,
+                                              out_specific_ctx_field, log_level, self_comp);
         if (status != DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK) {
             BT_COMP_LOGE_APPEND_CAUSE(self_comp,
                                       "Cannot copy specific context field: "
@@ -238,8 +522,10 @@ enum debug_info_trace_ir_mapping_status copy_event_content(const bt_event *in_ev
     if (in_payload_field) {
         out_payload_field = bt_event_borrow_payload_field(out_event);
         BT_ASSERT_DBG(out_payload_field);
+        BT_ASSERT_DBG(plan->payload);
 
-        status = copy_field_content(in_payload_field, out_payload_field, log_level, self_comp);
+        status = copy_field_content_with_plan(plan->payload, in_payload_field, out_payload_field,
+                                              log_level, self_comp);
         if (status != DEBUG_INFO_TRACE_IR_MAPPING_STATUS_OK) {
             BT_COMP_LOGE_APPEND_CAUSE(self_comp,
                                       "Cannot copy payloat field: "
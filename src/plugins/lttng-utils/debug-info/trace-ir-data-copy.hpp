@@ -26,8 +26,15 @@ enum debug_info_trace_ir_mapping_status copy_packet_content(const bt_packet *in_
                                                             bt_packet *out_packet,
                                                             bt_logging_level log_level,
                                                             bt_self_component *self_comp);
+
+/*
+ * Copies the content of the input event `in_event` to the output event
+ * `out_event` following the plan `plan` of the event class of
+ * `in_event` (see trace_ir_mapping_borrow_event_copy_plan()).
+ */
 enum debug_info_trace_ir_mapping_status copy_event_content(const bt_event *in_event,
                                                            bt_event *out_event,
+                                                           const struct event_copy_plan *plan,
                                                            bt_logging_level log_level,
                                                            bt_self_component *self_comp);
 enum debug_info_trace_ir_mapping_status copy_field_content(const bt_field *in_field,
@@ -296,6 +296,7 @@ bt_event_class *trace_ir_mapping_create_new_mapped_event_class(struct trace_ir_m
     const bt_stream_class *in_stream_class;
     bt_stream_class *out_stream_class;
     bt_event_class *out_event_class;
+    struct event_copy_plan *plan;
 
     BT_COMP_LOGD("Creating new mapped event class: in-ec-addr=%p", in_event_class);
 
@@ -336,6 +337,21 @@ bt_event_class *trace_ir_mapping_create_new_mapped_event_class(struct trace_ir_m
         goto error;
     }
 
+    /*
+     * Compile the plan to copy the content of the input events once
+     * for all the events of this event class.
+     */
+    plan = create_event_copy_plan(md_maps, in_event_class, out_event_class);
+    if (!plan) {
+        BT_COMP_LOGE_APPEND_CAUSE(self_comp,
+                                  "Error creating event copy plan: "
+                                  "in-ec-addr=%p, out-ec-addr=%p",
+                                  in_event_class, out_event_class);
+        goto error;
+    }
+
+    g_hash_table_insert(md_maps->event_copy_plan_map, (gpointer) in_event_class, plan);
+
     BT_COMP_LOGD("Created new mapped event class: in-ec-addr=%p, out-ec-addr=%p", in_event_class,
                  out_event_class);
 
@@ -360,6 +376,21 @@ bt_event_class *trace_ir_mapping_borrow_mapped_event_class(struct trace_ir_maps
     return borrow_mapped_event_class(md_maps, in_event_class);
 }
 
+const struct event_copy_plan *
+trace_ir_mapping_borrow_event_copy_plan(struct trace_ir_maps *ir_maps,
+                                        const bt_event_class *in_event_class)
+{
+    struct trace_ir_metadata_maps *md_maps;
+
+    BT_ASSERT_DBG(ir_maps);
+    BT_ASSERT_DBG(in_event_class);
+
+    md_maps = borrow_metadata_maps_from_input_event_class(ir_maps, in_event_class);
+
+    return static_cast<const event_copy_plan *>(
+        g_hash_table_lookup(md_maps->event_copy_plan_map, (gpointer) in_event_class));
+}
+
 static inline bt_packet *borrow_mapped_packet(struct trace_ir_data_maps *d_maps,
                                               const bt_packet *in_packet)
 {
@@ -548,6 +579,8 @@ struct trace_ir_metadata_maps *trace_ir_metadata_maps_create(struct trace_ir_map
                                                       (GDestroyNotify) bt_stream_class_put_ref);
     md_maps->event_class_map = g_hash_table_new_full(g_direct_hash, g_direct_equal, nullptr,
                                                      (GDestroyNotify) bt_event_class_put_ref);
+    md_maps->event_copy_plan_map = g_hash_table_new_full(g_direct_hash, g_direct_equal, nullptr,
+                                                         (GDestroyNotify) event_copy_plan_destroy);
     md_maps->field_class_map = g_hash_table_new_full(g_direct_hash, g_direct_equal, nullptr,
                                                      (GDestroyNotify) bt_field_class_put_ref);
     md_maps->clock_class_map = g_hash_table_new_full(g_direct_hash, g_direct_equal, nullptr,
@@ -604,6 +637,10 @@ void trace_ir_metadata_maps_destroy(struct trace_ir_metadata_maps *maps)
         g_hash_table_destroy(maps->stream_class_map);
     }
 
+    if (maps->event_copy_plan_map) {
+        g_hash_table_destroy(maps->event_copy_plan_map);
+    }
+
     if (maps->event_class_map) {
         g_hash_table_destroy(maps->event_class_map);
     }
@@ -35,6 +35,100 @@ struct field_class_resolving_context
     const bt_field_class *event_payload;
 };
 
+/* Kind of a field copy operation, resolved once from a field class type */
+enum field_copy_op_kind
+{
+    FIELD_COPY_OP_KIND_BOOL,
+    FIELD_COPY_OP_KIND_BIT_ARRAY,
+    FIELD_COPY_OP_KIND_UNSIGNED_INTEGER,
+    FIELD_COPY_OP_KIND_SIGNED_INTEGER,
+    FIELD_COPY_OP_KIND_SINGLE_PRECISION_REAL,
+    FIELD_COPY_OP_KIND_DOUBLE_PRECISION_REAL,
+    FIELD_COPY_OP_KIND_STRING,
+    FIELD_COPY_OP_KIND_STATIC_BLOB,
+    FIELD_COPY_OP_KIND_DYNAMIC_BLOB,
+    FIELD_COPY_OP_KIND_STRUCTURE,
+    FIELD_COPY_OP_KIND_STATIC_ARRAY,
+    FIELD_COPY_OP_KIND_DYNAMIC_ARRAY,
+    FIELD_COPY_OP_KIND_OPTION,
+    FIELD_COPY_OP_KIND_VARIANT,
+};
+
+/*
+ * Returns whether or not copying a field of kind `kind` doesn't
+ * involve copying other fields.
+ */
+static inline bool field_copy_op_kind_is_leaf(enum field_copy_op_kind kind)
+{
+    return kind < FIELD_COPY_OP_KIND_STRUCTURE;
+}
+
+struct field_copy_plan;
+
+/* Copy operation of a structure field member */
+struct field_copy_member_op
+{
+    /* Index of the member within the input structure field class */
+    uint64_t in_index;
+
+    /* Index of the member within the output structure field class */
+    uint64_t out_index;
+
+    enum field_copy_op_kind kind;
+
+    /* Plan to copy the member field: `nullptr` if `kind` is a leaf kind */
+    struct field_copy_plan *plan;
+};
+
+/*
+ * Plan to copy the content of an input field to an output field of the
+ * mapped field class.
+ *
+ * The plan holds what the generic copy_field_content() finds again for
+ * each field: the copy operation kind and, for a structure field, the
+ * index of each member within the output structure field class.
+ */
+struct field_copy_plan
+{
+    enum field_copy_op_kind kind;
+
+    /*
+     * `FIELD_COPY_OP_KIND_STRUCTURE`: `struct field_copy_member_op`
+     * elements, the operations of the leaf members first.
+     */
+    GArray *member_ops;
+
+    /* Number of leaf member operations at the beginning of `member_ops` */
+    guint leaf_member_op_count;
+
+    /*
+     * Plans of the contained fields (owned by this plan):
+     *
+     * Array field:
+     *     Element field plan.
+     *
+     * Option field:
+     *     Optional field plan.
+     *
+     * Variant field:
+     *     Plan of each option field, by option index.
+     */
+    GPtrArray *sub_plans;
+};
+
+/* Plans to copy the content of an input event to an output event */
+struct event_copy_plan
+{
+    /* Common context field plan, or `nullptr` if none (owned) */
+    struct field_copy_plan *common_context;
+
+    /* Specific context field plan, or `nullptr` if none (owned) */
+    struct field_copy_plan *specific_context;
+
+    /* Payload field plan, or `nullptr` if none (owned) */
+    struct field_copy_plan *payload;
+};
+
 struct trace_ir_metadata_maps
 {
     bt_logging_level log_level;
@@ -59,6 +153,14 @@ struct trace_ir_metadata_maps
      */
     GHashTable *event_class_map;
 
+    /*
+     * Map between input event class and the plan to copy the content
+     * of its events to events of the corresponding output event class.
+     * input event class: weak reference. Owned by an upstream component.
+     * event copy plan: owned by this structure.
+     */
+    GHashTable *event_copy_plan_map;
+
     /*
      * Map between input field class and its corresponding output field
      * class.
@@ -169,6 +271,10 @@ trace_ir_mapping_create_new_mapped_event_class(struct trace_ir_maps *ir_maps,
 bt_event_class *trace_ir_mapping_borrow_mapped_event_class(struct trace_ir_maps *ir_maps,
                                                            const bt_event_class *in_event_class);
 
+const struct event_copy_plan *
+trace_ir_mapping_borrow_event_copy_plan(struct trace_ir_maps *ir_maps,
+                                        const bt_event_class *in_event_class);
+
 bt_packet *trace_ir_mapping_create_new_mapped_packet(struct trace_ir_maps *ir_maps,
                                                      const bt_packet *in_packet);
 
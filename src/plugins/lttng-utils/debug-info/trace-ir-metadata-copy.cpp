@@ -13,6 +13,7 @@
 #define BT_LOG_TAG            "PLUGIN/FLT.LTTNG-UTILS.DEBUG-INFO/TRACE-IR-META-COPY"
 #include <inttypes.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "logging/comp-logging.h"
 
@@ -777,3 +778,287 @@ copy_field_class_content(struct trace_ir_metadata_maps *md_maps,
 {
     return copy_field_class_content_internal(md_maps, in_field_class, out_field_class);
 }
+
+void field_copy_plan_destroy(struct field_copy_plan *plan)
+{
+    if (!plan) {
+        return;
+    }
+
+    if (plan->member_ops) {
+        for (guint i = 0; i < plan->member_ops->len; i++) {
+            field_copy_plan_destroy(
+                g_array_index(plan->member_ops, struct field_copy_member_op, i).plan);
+        }
+
+        g_array_free(plan->member_ops, TRUE);
+    }
+
+    if (plan->sub_plans) {
+        g_ptr_array_free(plan->sub_plans, TRUE);
+    }
+
+    g_free(plan);
+}
+
+static enum field_copy_op_kind field_copy_op_kind_from_fc_type(bt_field_class_type fc_type)
+{
+    if (fc_type == BT_FIELD_CLASS_TYPE_BOOL) {
+        return FIELD_COPY_OP_KIND_BOOL;
+    } else if (fc_type == BT_FIELD_CLASS_TYPE_BIT_ARRAY) {
+        return FIELD_COPY_OP_KIND_BIT_ARRAY;
+    } else if (bt_field_class_type_is(fc_type, BT_FIELD_CLASS_TYPE_UNSIGNED_INTEGER)) {
+        return FIELD_COPY_OP_KIND_UNSIGNED_INTEGER;
+    } else if (bt_field_class_type_is(fc_type, BT_FIELD_CLASS_TYPE_SIGNED_INTEGER)) {
+        return FIELD_COPY_OP_KIND_SIGNED_INTEGER;
+    } else if (fc_type == BT_FIELD_CLASS_TYPE_SINGLE_PRECISION_REAL) {
+        return FIELD_COPY_OP_KIND_SINGLE_PRECISION_REAL;
+    } else if (fc_type == BT_FIELD_CLASS_TYPE_DOUBLE_PRECISION_REAL) {
+        return FIELD_COPY_OP_KIND_DOUBLE_PRECISION_REAL;
+    } else if (fc_type == BT_FIELD_CLASS_TYPE_STRING) {
+        return FIELD_COPY_OP_KIND_STRING;
+    } else if (fc_type == BT_FIELD_CLASS_TYPE_STRUCTURE) {
+        return FIELD_COPY_OP_KIND_STRUCTURE;
+    } else if (bt_field_class_type_is(fc_type, BT_FIELD_CLASS_TYPE_STATIC_ARRAY)) {
+        return FIELD_COPY_OP_KIND_STATIC_ARRAY;
+    } else if (bt_field_class_type_is(fc_type, BT_FIELD_CLASS_TYPE_DYNAMIC_ARRAY)) {
+        return FIELD_COPY_OP_KIND_DYNAMIC_ARRAY;
+    } else if (bt_field_class_type_is(fc_type, BT_FIELD_CLASS_TYPE_OPTION)) {
+        return FIELD_COPY_OP_KIND_OPTION;
+    } else if (bt_field_class_type_is(fc_type, BT_FIELD_CLASS_TYPE_VARIANT)) {
+        return FIELD_COPY_OP_KIND_VARIANT;
+    } else if (bt_field_class_type_is(fc_type, BT_FIELD_CLASS_TYPE_STATIC_BLOB)) {
+        return FIELD_COPY_OP_KIND_STATIC_BLOB;
+    } else if (bt_field_class_type_is(fc_type, BT_FIELD_CLASS_TYPE_DYNAMIC_BLOB)) {
+        return FIELD_COPY_OP_KIND_DYNAMIC_BLOB;
+    }
+
+    bt_common_abort();
+}
+
+/*
+ * Finds the index of the member named `name` within the structure
+ * field class `struct_fc`.
+ */
+static uint64_t find_struct_member_index(const bt_field_class *struct_fc, const char *name)
+{
+    uint64_t member_count = bt_field_class_structure_get_member_count(struct_fc);
+
+    for (uint64_t i = 0; i < member_count; i++) {
+        const bt_field_class_structure_member *member =
+            bt_field_class_structure_borrow_member_by_index_const(struct_fc, i);
+
+        if (strcmp(bt_field_class_structure_member_get_name(member), name) == 0) {
+            return i;
+        }
+    }
+
+    /* The output structure field class has all the input members */
+    bt_common_abort();
+}
+
+static struct field_copy_plan *create_field_copy_plan(struct trace_ir_metadata_maps *md_maps,
+                                                      const bt_field_class *in_fc,
+                                                      const bt_field_class *out_fc);
+
+static int add_field_copy_sub_plan(struct trace_ir_metadata_maps *md_maps,
+                                   struct field_copy_plan *plan, const bt_field_class *in_fc,
+                                   const bt_field_class *out_fc)
+{
+    struct field_copy_plan *sub_plan = create_field_copy_plan(md_maps, in_fc, out_fc);
+
+    if (!sub_plan) {
+        return -1;
+    }
+
+    g_ptr_array_add(plan->sub_plans, sub_plan);
+    return 0;
+}
+
+static struct field_copy_plan *create_field_copy_plan(struct trace_ir_metadata_maps *md_maps,
+                                                      const bt_field_class *in_fc,
+                                                      const bt_field_class *out_fc)
+{
+    bt_logging_level log_level = md_maps->log_level;
+    bt_self_component *self_comp = md_maps->self_comp;
+    struct field_copy_plan *plan = g_new0(struct field_copy_plan, 1);
+
+    if (!plan) {
+        BT_COMP_LOGE_APPEND_CAUSE(self_comp, "Failed to allocate a field copy plan.");
+        goto error;
+    }
+
+    BT_ASSERT(bt_field_class_get_type(in_fc) == bt_field_class_get_type(out_fc));
+    plan->kind = field_copy_op_kind_from_fc_type(bt_field_class_get_type(in_fc));
+
+    if (field_copy_op_kind_is_leaf(plan->kind)) {
+        goto end;
+    }
+
+    if (plan->kind == FIELD_COPY_OP_KIND_STRUCTURE) {
+        uint64_t member_count = bt_field_class_structure_get_member_count(in_fc);
+
+        plan->member_ops = g_array_sized_new(FALSE, FALSE, sizeof(struct field_copy_member_op),
+                                             (guint) member_count);
+        if (!plan->member_ops) {
+            BT_COMP_LOGE_APPEND_CAUSE(self_comp, "Failed to allocate a GArray.");
+            goto error;
+        }
+
+        for (uint64_t i = 0; i < member_count; i++) {
+            const bt_field_class_structure_member *in_member =
+                bt_field_class_structure_borrow_member_by_index_const(in_fc, i);
+            const char *name = bt_field_class_structure_member_get_name(in_member);
+            struct field_copy_member_op op;
+
+            op.in_index = i;
+            op.out_index = find_struct_member_index(out_fc, name);
+            op.plan = nullptr;
+            op.kind = field_copy_op_kind_from_fc_type(bt_field_class_get_type(
+                bt_field_class_structure_member_borrow_field_class_const(in_member)));
+
+            if (field_copy_op_kind_is_leaf(op.kind)) {
+                /* Keep the leaf member operations together */
+                g_array_insert_val(plan->member_ops, plan->leaf_member_op_count, op);
+                plan->leaf_member_op_count++;
+                continue;
+            }
+
+            op.plan = create_field_copy_plan(
+                md_maps, bt_field_class_structure_member_borrow_field_class_const(in_member),
+                bt_field_class_structure_member_borrow_field_class_const(
+                    bt_field_class_structure_borrow_member_by_index_const(out_fc,
+                                                                          op.out_index)));
+            if (!op.plan) {
+                BT_COMP_LOGE_APPEND_CAUSE(self_comp,
+                                          "Failed to create structure member copy plan: "
+                                          "member-name=\"%s\"",
+                                          name);
+                goto error;
+            }
+
+            g_array_append_val(plan->member_ops, op);
+        }
+
+        goto end;
+    }
+
+    plan->sub_plans = g_ptr_array_new_with_free_func((GDestroyNotify) field_copy_plan_destroy);
+    if (!plan->sub_plans) {
+        BT_COMP_LOGE_APPEND_CAUSE(self_comp, "Failed to allocate a GPtrArray.");
+        goto error;
+    }
+
+    if (plan->kind == FIELD_COPY_OP_KIND_STATIC_ARRAY ||
+        plan->kind == FIELD_COPY_OP_KIND_DYNAMIC_ARRAY) {
+        if (add_field_copy_sub_plan(
+                md_maps, plan, bt_field_class_array_borrow_element_field_class_const(in_fc),
+                bt_field_class_array_borrow_element_field_class_const(out_fc))) {
+            goto error;
+        }
+    } else if (plan->kind == FIELD_COPY_OP_KIND_OPTION) {
+        if (add_field_copy_sub_plan(md_maps, plan,
+                                    bt_field_class_option_borrow_field_class_const(in_fc),
+                                    bt_field_class_option_borrow_field_class_const(out_fc))) {
+            goto error;
+        }
+    } else {
+        uint64_t option_count = bt_field_class_variant_get_option_count(in_fc);
+
+        BT_ASSERT(plan->kind == FIELD_COPY_OP_KIND_VARIANT);
+        BT_ASSERT(bt_field_class_variant_get_option_count(out_fc) == option_count);
+
+        for (uint64_t i = 0; i < option_count; i++) {
+            if (add_field_copy_sub_plan(
+                    md_maps, plan,
+                    bt_field_class_variant_option_borrow_field_class_const(
+                        bt_field_class_variant_borrow_option_by_index_const(in_fc, i)),
+                    bt_field_class_variant_option_borrow_field_class_const(
+                        bt_field_class_variant_borrow_option_by_index_const(out_fc, i)))) {
+                goto error;
+            }
+        }
+    }
+
+    goto end;
+
+error:
+    field_copy_plan_destroy(plan);
+    plan = nullptr;
+
+end:
+    return plan;
+}
+
+void event_copy_plan_destroy(struct event_copy_plan *plan)
+{
+    if (!plan) {
+        return;
+    }
+
+    field_copy_plan_destroy(plan->common_context);
+    field_copy_plan_destroy(plan->specific_context);
+    field_copy_plan_destroy(plan->payload);
+    g_free(plan);
+}
+
+struct event_copy_plan *create_event_copy_plan(struct trace_ir_metadata_maps *md_maps,
+                                               const bt_event_class *in_event_class,
+                                               const bt_event_class *out_event_class)
+{
+    bt_logging_level log_level = md_maps->log_level;
+    bt_self_component *self_comp = md_maps->self_comp;
+    const bt_field_class *in_fc, *out_fc;
+    struct event_copy_plan *plan = g_new0(struct event_copy_plan, 1);
+
+    BT_COMP_LOGD("Creating event copy plan: in-ec-addr=%p, out-ec-addr=%p", in_event_class,
+                 out_event_class);
+
+    if (!plan) {
+        BT_COMP_LOGE_APPEND_CAUSE(self_comp, "Failed to allocate an event copy plan.");
+        goto error;
+    }
+
+    in_fc = bt_stream_class_borrow_event_common_context_field_class_const(
+        bt_event_class_borrow_stream_class_const(in_event_class));
+    if (in_fc) {
+        out_fc = bt_stream_class_borrow_event_common_context_field_class_const(
+            bt_event_class_borrow_stream_class_const(out_event_class));
+        plan->common_context = create_field_copy_plan(md_maps, in_fc, out_fc);
+        if (!plan->common_context) {
+            BT_COMP_LOGE_APPEND_CAUSE(self_comp, "Failed to create common context copy plan.");
+            goto error;
+        }
+    }
+
+    in_fc = bt_event_class_borrow_specific_context_field_class_const(in_event_class);
+    if (in_fc) {
+        out_fc = bt_event_class_borrow_specific_context_field_class_const(out_event_class);
+        plan->specific_context = create_field_copy_plan(md_maps, in_fc, out_fc);
+        if (!plan->specific_context) {
+            BT_COMP_LOGE_APPEND_CAUSE(self_comp, "Failed to create specific context copy plan.");
+            goto error;
+        }
+    }
+
+    in_fc = bt_event_class_borrow_payload_field_class_const(in_event_class);
+    if (in_fc) {
+        out_fc = bt_event_class_borrow_payload_field_class_const(out_event_class);
+        plan->payload = create_field_copy_plan(md_maps, in_fc, out_fc);
+        if (!plan->payload) {
+            BT_COMP_LOGE_APPEND_CAUSE(self_comp, "Failed to create payload copy plan.");
+            goto error;
+        }
+    }
+
+    BT_COMP_LOGD("Created event copy plan: in-ec-addr=%p, out-ec-addr=%p", in_event_class,
+                 out_event_class);
+    goto end;
+
+error:
+    event_copy_plan_destroy(plan);
+    plan = nullptr;
+
+end:
+    return plan;
+}
@@ -42,4 +42,17 @@ enum debug_info_trace_ir_mapping_status copy_event_common_context_field_class_co
 bt_field_class *create_field_class_copy(struct trace_ir_metadata_maps *trace_ir_metadata_maps,
                                         const bt_field_class *in_field_class);
 
+/*
+ * Creates the plan to copy the content of events of the input event
+ * class `in_event_class` to events of its mapped output event class
+ * `out_event_class`, of which the content is already copied.
+ */
+struct event_copy_plan *
+create_event_copy_plan(struct trace_ir_metadata_maps *trace_ir_metadata_maps,
+                       const bt_event_class *in_event_class, const bt_event_class *out_event_class);
+
+void event_copy_plan_destroy(struct event_copy_plan *plan);
+
+void field_copy_plan_destroy(struct field_copy_plan *plan);
+
 #endif /* BABELTRACE_PLUGINS_LTTNG_UTILS_DEBUG_INFO_TRACE_IR_METADATA_COPY_HPP */
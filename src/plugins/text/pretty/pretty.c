@@ -45,6 +45,30 @@ void destroy_pretty_data(struct pretty_component *pretty)
 	}
 
 	bt_message_iterator_put_ref(pretty->iterator);
+	pretty_remove_trace_class_listeners(pretty);
+
+	if (pretty->event_class_templates) {
+		g_hash_table_destroy(pretty->event_class_templates);
+	}
+
+	if (pretty->trace_class_listener_ids) {
+		g_hash_table_destroy(pretty->trace_class_listener_ids);
+	}
+
+	/*
+	 * The component writes the pending output when a stream ends and
+	 * when the upstream message iterator ends, so there's pending
+	 * output here only when the graph didn't run to completion
+	 * (interrupted or failed).
+	 */
+	if (pretty->string && pretty->string->len > 0 && pretty->out) {
+		size_t size = pretty->string->len;
+
+		if (pretty_flush_output(pretty)) {
+			BT_COMP_LOGE_ERRNO("Failed to write pending output",
+				": size=%zu", size);
+		}
+	}
 
 	if (pretty->string) {
 		(void) g_string_free(pretty->string, TRUE);
@@ -54,6 +78,10 @@ void destroy_pretty_data(struct pretty_component *pretty)
 		(void) g_string_free(pretty->tmp_string, TRUE);
 	}
 
+	if (pretty->wall_clock_cache.str) {
+		(void) g_string_free(pretty->wall_clock_cache.str, TRUE);
+	}
+
 	if (pretty->out != stdout) {
 		int ret;
 
@@ -93,6 +121,21 @@ struct pretty_component *create_pretty(void)
 	if (!pretty->tmp_string) {
 		goto error;
 	}
+	pretty->wall_clock_cache.str = g_string_new("");
+	if (!pretty->wall_clock_cache.str) {
+		goto error;
+	}
+	pretty->event_class_templates = g_hash_table_new_full(g_direct_hash,
+		g_direct_equal, NULL,
+		(GDestroyNotify) pretty_event_class_template_destroy);
+	if (!pretty->event_class_templates) {
+		goto error;
+	}
+	pretty->trace_class_listener_ids = g_hash_table_new_full(
+		g_direct_hash, g_direct_equal, NULL, g_free);
+	if (!pretty->trace_class_listener_ids) {
+		goto error;
+	}
 end:
 	return pretty;
 
@@ -134,6 +177,18 @@ bt_message_iterator_class_next_method_status handle_message(
 			ret = BT_MESSAGE_ITERATOR_CLASS_NEXT_METHOD_STATUS_ERROR;
 		}
 		break;
+	case BT_MESSAGE_TYPE_STREAM_END:
+		/*
+		 * Write the pending output now so that a write error
+		 * becomes a consuming error instead of being reported
+		 * when the component is finalized.
+		 */
+		if (pretty_flush_output(pretty)) {
+			BT_COMP_LOGE_APPEND_CAUSE_ERRNO(pretty->self_comp,
+				"Failed to write output", ".");
+			ret = BT_MESSAGE_ITERATOR_CLASS_NEXT_METHOD_STATUS_ERROR;
+		}
+		break;
 	default:
 		break;
 	}
@@ -195,6 +250,17 @@ bt_component_class_sink_consume_method_status pretty_consume(
 	next_status = bt_message_iterator_next(it,
 		&msgs, &count);
 	if (next_status != BT_MESSAGE_ITERATOR_NEXT_STATUS_OK) {
+		/*
+		 * No messages for now: write the pending output instead
+		 * of keeping it until the next messages.
+		 */
+		if (pretty_flush_output(pretty)) {
+			BT_COMP_LOGE_APPEND_CAUSE(pretty->self_comp,
+				"Failed to write output.");
+			status = BT_COMPONENT_CLASS_SINK_CONSUME_METHOD_STATUS_ERROR;
+			goto end;
+		}
+
 		status = (int) next_status;
 		goto end;
 	}
@@ -329,6 +395,7 @@ struct bt_param_validation_map_value_entry_descr pretty_params[] = {
 	{ "field-emf", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL, { .type = BT_VALUE_TYPE_BOOL } },
 	{ "field-callsite", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL, { .type = BT_VALUE_TYPE_BOOL } },
 	{ "print-enum-flags", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL, { .type = BT_VALUE_TYPE_BOOL } },
+	{ "output-buffer-size", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL, { .type = BT_VALUE_TYPE_UNSIGNED_INTEGER } },
 	BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_END
 };
 
@@ -378,6 +445,16 @@ bt_component_class_initialize_method_status apply_params(
 		goto end;
 	}
 
+	value = bt_value_map_borrow_entry_value_const(params,
+		"output-buffer-size");
+	if (value) {
+		pretty->options.output_buffer_size =
+			bt_value_integer_unsigned_get(value);
+	} else {
+		/* Write each line as soon as it's printed */
+		pretty->options.output_buffer_size = 0;
+	}
+
 	apply_one_bool_with_default("no-delta", params,
 		&pretty->options.print_delta_field, false);
 	/* Reverse logic. */
@@ -59,6 +59,28 @@ struct pretty_options {
 	bool clock_gmt;
 	enum pretty_color_option color;
 	bool verbose;
+
+	/*
+	 * Size of pending output, in bytes, from which the component
+	 * writes it (0: write each line as soon as it's printed).
+	 */
+	uint64_t output_buffer_size;
+};
+
+/*
+ * Rendering of the seconds part of the last printed wall clock time.
+ */
+struct wall_clock_cache {
+	/* Whether or not `str` is the rendering of the members below */
+	bool is_valid;
+
+	bool is_negative;
+
+	/* Absolute value of the time, in seconds */
+	uint64_t sec_abs;
+
+	/* Date (if needed) and time, or seconds */
+	GString *str;
 };
 
 struct pretty_component {
@@ -68,6 +90,11 @@ struct pretty_component {
 	FILE *out, *err;
 	int depth;	/* nesting, used for tabulation alignment. */
 	bool start_line;
+
+	/*
+	 * Pending output: printed lines which the component didn't write
+	 * yet, followed with the line being printed.
+	 */
 	GString *string;
 	GString *tmp_string;
 	bool use_colors;
@@ -80,6 +107,8 @@ struct pretty_component {
 
 	bool negative_timestamp_warning_done;
 
+	struct wall_clock_cache wall_clock_cache;
+
 	/*
 	 * For each bit of the integer backing the enumeration we have a list
 	 * (GPtrArray) of labels (char *) for that bit.
@@ -92,6 +121,19 @@ struct pretty_component {
 	 */
 	GPtrArray *enum_bit_labels[ENUMERATION_MAX_BITFLAGS_COUNT];
 
+	/*
+	 * Event class (weak) -> rendering template
+	 * (`struct pretty_event_class_template *`, owned).
+	 */
+	GHashTable *event_class_templates;
+
+	/*
+	 * Trace class (weak) -> ID of the destruction listener which
+	 * removes the templates of its event classes
+	 * (`bt_listener_id *`, owned).
+	 */
+	GHashTable *trace_class_listener_ids;
+
 	bt_logging_level log_level;
 	bt_self_component *self_comp;
 };
@@ -122,6 +164,22 @@ int pretty_print_event(struct pretty_component *pretty,
 int pretty_print_discarded_items(struct pretty_component *pretty,
 		const bt_message *msg);
 
+/*
+ * Writes the pending output of `pretty` to its output stream, and then
+ * flushes the latter.
+ */
+int pretty_flush_output(struct pretty_component *pretty);
+
+struct pretty_event_class_template;
+
+void pretty_event_class_template_destroy(
+		struct pretty_event_class_template *tmpl);
+
+/*
+ * Removes the trace class destruction listeners which `pretty` added.
+ */
+void pretty_remove_trace_class_listeners(struct pretty_component *pretty);
+
 void pretty_print_init(void);
 
 #endif /* BABELTRACE_PLUGINS_TEXT_PRETTY_PRETTY_H */
@@ -5,6 +5,11 @@
  * Copyright 2016 Mathieu Desnoyers <mathieu.desnoyers@efficios.com>
  */
 
+#define BT_COMP_LOG_SELF_COMP (pretty->self_comp)
+#define BT_LOG_OUTPUT_LEVEL (pretty->log_level)
+#define BT_LOG_TAG "PLUGIN/SINK.TEXT.PRETTY/PRINT"
+#include "logging/comp-logging.h"
+
 #include <babeltrace2/babeltrace.h>
 #include "compat/bitfield.h"
 #include "common/common.h"
@@ -34,10 +39,101 @@ struct timestamp {
 	uint64_t clock_snapshot;	/* In cycles. */
 };
 
+/* Properties of an integer field class which print_integer() needs */
+struct integer_print_props {
+	bt_field_class_integer_preferred_display_base base;
+
+	/* Field value range, in bits */
+	int len;
+
+	bool is_signed;
+};
+
+enum field_template_kind {
+	FIELD_TEMPLATE_KIND_BOOL,
+	FIELD_TEMPLATE_KIND_BIT_ARRAY,
+	FIELD_TEMPLATE_KIND_ENUM,
+	FIELD_TEMPLATE_KIND_INTEGER,
+	FIELD_TEMPLATE_KIND_SINGLE_PRECISION_REAL,
+	FIELD_TEMPLATE_KIND_DOUBLE_PRECISION_REAL,
+	FIELD_TEMPLATE_KIND_STRING,
+	FIELD_TEMPLATE_KIND_STRUCT,
+	FIELD_TEMPLATE_KIND_OPTION,
+	FIELD_TEMPLATE_KIND_VARIANT,
+	FIELD_TEMPLATE_KIND_STATIC_ARRAY,
+	FIELD_TEMPLATE_KIND_DYNAMIC_ARRAY,
+	FIELD_TEMPLATE_KIND_BLOB,
+};
+
+/*
+ * Rendering template of a field class: what print_field() otherwise
+ * finds out from the field class of each field it prints.
+ */
+struct field_template {
+	enum field_template_kind kind;
+
+	/* `FIELD_TEMPLATE_KIND_ENUM` and `FIELD_TEMPLATE_KIND_INTEGER` */
+	struct integer_print_props int_props;
+
+	/*
+	 * `FIELD_TEMPLATE_KIND_ENUM` with the `print-enum-flags`
+	 * parameter: labels (`const char *`) of the mappings of which a
+	 * range is exactly each bit, for each bit
+	 * (`ENUMERATION_MAX_BITFLAGS_COUNT` arrays).
+	 */
+	GPtrArray **enum_bit_labels;
+
+	/*
+	 * `FIELD_TEMPLATE_KIND_STRUCT`: pre-rendered text preceding
+	 * each member field (separator, and name if needed) (`char *`).
+	 */
+	GPtrArray *member_prefixes;
+
+	/*
+	 * Templates of the contained field classes
+	 * (`struct field_template *`):
+	 *
+	 * Structure: template of each member.
+	 * Option: template of the optional field class.
+	 * Variant: template of each option.
+	 * Array: template of the element field class.
+	 */
+	GPtrArray *sub_templates;
+};
+
+/*
+ * Rendering template of an event class, created the first time the
+ * component prints an event of this class.
+ */
+struct pretty_event_class_template {
+	/* Trace class of the event class (weak) */
+	const bt_trace_class *trace_class;
+
+	/* Pre-rendered log level, or `NULL` not to print it */
+	gchar *log_level_str;
+
+	/* EMF URI (owned by the event class), or `NULL` not to print it */
+	const char *emf_uri;
+
+	/* Pre-rendered event name and the following separator */
+	gchar *name_fragment;
+
+	/* Templates of the root field classes (`NULL` if none) */
+	struct field_template *packet_context;
+	struct field_template *common_context;
+	struct field_template *specific_context;
+	struct field_template *payload;
+};
+
 static
 int print_field(struct pretty_component *pretty,
 		const bt_field *field, bool print_names);
 
+static
+int print_field_with_template(struct pretty_component *pretty,
+		const bt_field *field, const struct field_template *tmpl,
+		bool print_names);
+
 static
 void print_name_equal(struct pretty_component *pretty, const char *name)
 {
@@ -82,15 +178,134 @@ void print_timestamp_cycles(struct pretty_component *pretty,
 	}
 }
 
+/*
+ * Appends the `NSEC_PER_SEC`-based fractional part `nsec` (less than
+ * `NSEC_PER_SEC`) to `str` as `.NNNNNNNNN`, like the `.%09` format.
+ */
+static
+void append_nsec(GString *str, uint64_t nsec)
+{
+	char buf[sizeof(".000000000")];
+	int i;
+
+	BT_ASSERT_DBG(nsec < NSEC_PER_SEC);
+	buf[0] = '.';
+	buf[10] = '\0';
+
+	/* Always exactly nine digits: no data-dependent branch */
+	for (i = 9; i >= 1; i--) {
+		buf[i] = '0' + (char) (nsec % 10);
+		nsec /= 10;
+	}
+
+	bt_common_g_string_append(str, buf);
+}
+
+/*
+ * Appends `value` to `str` in decimal, like the `%` PRIu64 format.
+ */
+static
+void append_uint64(GString *str, uint64_t value)
+{
+	char buf[sizeof("18446744073709551615")];
+	char *digit = &buf[sizeof(buf) - 1];
+
+	*digit = '\0';
+
+	do {
+		digit--;
+		*digit = '0' + (char) (value % 10);
+		value /= 10;
+	} while (value != 0);
+
+	bt_common_g_string_append(str, digit);
+}
+
+/*
+ * Renders the seconds part (everything before the fractional part) of
+ * a wall clock time into `str`, replacing its content.
+ *
+ * Returns false if the time must be printed in seconds instead without
+ * caching the result (warning paths).
+ */
+static
+bool render_wall_clock_seconds(struct pretty_component *pretty,
+		GString *str, bool is_negative, uint64_t ts_sec_abs)
+{
+	struct tm tm;
+	time_t time_s = (time_t) ts_sec_abs;
+
+	g_string_truncate(str, 0);
+
+	if (pretty->options.clock_seconds) {
+		goto seconds;
+	}
+
+	if (is_negative && !pretty->negative_timestamp_warning_done) {
+		BT_COMP_LOGW_STR("Fallback to [sec.ns] to print negative time value. Use --clock-seconds.");
+		pretty->negative_timestamp_warning_done = true;
+		return false;
+	}
+
+	if (!pretty->options.clock_gmt) {
+		struct tm *res;
+
+		res = bt_localtime_r(&time_s, &tm);
+		if (!res) {
+			BT_COMP_LOGW("Unable to get localtime: seconds=%" PRIu64,
+				ts_sec_abs);
+			return false;
+		}
+	} else {
+		struct tm *res;
+
+		res = bt_gmtime_r(&time_s, &tm);
+		if (!res) {
+			BT_COMP_LOGW("Unable to get gmtime: seconds=%" PRIu64,
+				ts_sec_abs);
+			return false;
+		}
+	}
+	if (pretty->options.clock_date) {
+		char timestr[26];
+		size_t res;
+
+		/* Print date and time */
+		res = strftime(timestr, sizeof(timestr),
+				"%Y-%m-%d ", &tm);
+		if (!res) {
+			BT_COMP_LOGW_STR("Unable to print ascii time.");
+			return false;
+		}
+
+		g_string_append(str, timestr);
+	}
+
+	/* Print time in HH:MM:SS */
+	g_string_append_printf(str, "%02d:%02d:%02d", tm.tm_hour, tm.tm_min,
+		tm.tm_sec);
+	goto end;
+
+seconds:
+	if (is_negative) {
+		g_string_append_c(str, '-');
+	}
+
+	append_uint64(str, ts_sec_abs);
+
+end:
+	return true;
+}
+
 static
 void print_timestamp_wall(struct pretty_component *pretty,
 		const bt_clock_snapshot *clock_snapshot, bool update_last)
 {
 	int ret;
 	int64_t ts_nsec = 0;	/* add configurable offset */
-	int64_t ts_sec = 0;	/* add configurable offset */
-	uint64_t ts_sec_abs, ts_nsec_abs;
+	uint64_t ts_abs, ts_sec_abs, ts_nsec_abs;
 	bool is_negative;
+	struct wall_clock_cache *cache = &pretty->wall_clock_cache;
 
 	if (!clock_snapshot) {
 		bt_common_g_string_append(pretty->string, "??:??:??.?????????");
@@ -112,92 +327,39 @@ void print_timestamp_wall(struct pretty_component *pretty,
 		pretty->last_real_timestamp = ts_nsec;
 	}
 
-	ts_sec += ts_nsec / NSEC_PER_SEC;
-	ts_nsec = ts_nsec % NSEC_PER_SEC;
-
-	if (ts_sec >= 0 && ts_nsec >= 0) {
-		is_negative = false;
-		ts_sec_abs = ts_sec;
-		ts_nsec_abs = ts_nsec;
-	} else if (ts_sec > 0 && ts_nsec < 0) {
-		is_negative = false;
-		ts_sec_abs = ts_sec - 1;
-		ts_nsec_abs = NSEC_PER_SEC + ts_nsec;
-	} else if (ts_sec == 0 && ts_nsec < 0) {
-		is_negative = true;
-		ts_sec_abs = ts_sec;
-		ts_nsec_abs = -ts_nsec;
-	} else if (ts_sec < 0 && ts_nsec > 0) {
-		is_negative = true;
-		ts_sec_abs = -(ts_sec + 1);
-		ts_nsec_abs = NSEC_PER_SEC - ts_nsec;
-	} else if (ts_sec < 0 && ts_nsec == 0) {
-		is_negative = true;
-		ts_sec_abs = -ts_sec;
-		ts_nsec_abs = ts_nsec;
-	} else {	/* (ts_sec < 0 && ts_nsec < 0) */
-		is_negative = true;
-		ts_sec_abs = -ts_sec;
-		ts_nsec_abs = -ts_nsec;
-	}
-
-	if (!pretty->options.clock_seconds) {
-		struct tm tm;
-		time_t time_s = (time_t) ts_sec_abs;
-
-		if (is_negative && !pretty->negative_timestamp_warning_done) {
-			// TODO: log instead
-			fprintf(stderr, "[warning] Fallback to [sec.ns] to print negative time value. Use --clock-seconds.\n");
-			pretty->negative_timestamp_warning_done = true;
-			goto seconds;
-		}
-
-		if (!pretty->options.clock_gmt) {
-			struct tm *res;
-
-			res = bt_localtime_r(&time_s, &tm);
-			if (!res) {
-				// TODO: log instead
-				fprintf(stderr, "[warning] Unable to get localtime.\n");
-				goto seconds;
-			}
-		} else {
-			struct tm *res;
+	/*
+	 * Split the absolute value: the seconds and nanoseconds parts of
+	 * a time always have the same sign.
+	 */
+	is_negative = ts_nsec < 0;
+	ts_abs = is_negative ? -(uint64_t) ts_nsec : (uint64_t) ts_nsec;
+	ts_sec_abs = ts_abs / NSEC_PER_SEC;
+	ts_nsec_abs = ts_abs % NSEC_PER_SEC;
 
-			res = bt_gmtime_r(&time_s, &tm);
-			if (!res) {
-				// TODO: log instead
-				fprintf(stderr, "[warning] Unable to get gmtime.\n");
-				goto seconds;
-			}
+	/*
+	 * Consecutive events are typically within the same second:
+	 * render the seconds part once per second.
+	 */
+	if (!cache->is_valid || cache->sec_abs != ts_sec_abs ||
+			cache->is_negative != is_negative) {
+		cache->is_valid = render_wall_clock_seconds(pretty, cache->str,
+			is_negative, ts_sec_abs);
+		cache->is_negative = is_negative;
+		cache->sec_abs = ts_sec_abs;
+
+		if (!cache->is_valid) {
+			/* Fall back to seconds for this time only */
+			bt_common_g_string_append_printf(pretty->string,
+				"%s%" PRIu64, is_negative ? "-" : "",
+				ts_sec_abs);
+			goto nsec;
 		}
-		if (pretty->options.clock_date) {
-			char timestr[26];
-			size_t res;
-
-			/* Print date and time */
-			res = strftime(timestr, sizeof(timestr),
-					"%Y-%m-%d ", &tm);
-			if (!res) {
-				// TODO: log instead
-				fprintf(stderr, "[warning] Unable to print ascii time.\n");
-				goto seconds;
-			}
+	}
 
-			bt_common_g_string_append(pretty->string, timestr);
-		}
+	bt_common_g_string_append(pretty->string, cache->str->str);
 
-		/* Print time in HH:MM:SS.ns */
-		bt_common_g_string_append_printf(pretty->string,
-			"%02d:%02d:%02d.%09" PRIu64, tm.tm_hour, tm.tm_min,
-			tm.tm_sec, ts_nsec_abs);
-		goto end;
-	}
-seconds:
-	bt_common_g_string_append_printf(pretty->string, "%s%" PRId64 ".%09" PRIu64,
-		is_negative ? "-" : "", ts_sec_abs, ts_nsec_abs);
-end:
-	return;
+nsec:
+	append_nsec(pretty->string, ts_nsec_abs);
 }
 
 static
@@ -253,14 +415,13 @@ int print_event_timestamp(struct pretty_component *pretty,
 			}
 		} else {
 			if (pretty->delta_real_timestamp != -1ULL) {
-				uint64_t delta_sec, delta_nsec, delta;
+				uint64_t delta = pretty->delta_real_timestamp;
 
-				delta = pretty->delta_real_timestamp;
-				delta_sec = delta / NSEC_PER_SEC;
-				delta_nsec = delta % NSEC_PER_SEC;
-				bt_common_g_string_append_printf(pretty->string,
-					"+%" PRIu64 ".%09" PRIu64,
-					delta_sec, delta_nsec);
+				bt_common_g_string_append_c(pretty->string, '+');
+				append_uint64(pretty->string,
+					delta / NSEC_PER_SEC);
+				append_nsec(pretty->string,
+					delta % NSEC_PER_SEC);
 			} else {
 				bt_common_g_string_append(pretty->string, "+?.?????????");
 			}
@@ -277,19 +438,16 @@ end:
 
 static
 int print_event_header(struct pretty_component *pretty,
-		const bt_message *event_msg)
+		const bt_message *event_msg,
+		const struct pretty_event_class_template *tmpl)
 {
 	bool print_names = pretty->options.print_header_field_names;
 	int ret = 0;
-	const bt_event_class *event_class = NULL;
 	const bt_stream *stream = NULL;
 	const bt_trace *trace = NULL;
 	const bt_event *event = bt_message_event_borrow_event_const(event_msg);
-	const char *ev_name;
 	int dom_print = 0;
-	bt_property_availability prop_avail;
 
-	event_class = bt_event_borrow_class_const(event);
 	stream = bt_event_borrow_stream_const(event);
 	trace = bt_stream_borrow_trace_const(stream);
 	ret = print_event_timestamp(pretty, event_msg, &pretty->start_line);
@@ -398,65 +556,31 @@ int print_event_header(struct pretty_component *pretty,
 			dom_print = 1;
 		}
 	}
-	if (pretty->options.print_loglevel_field) {
-		static const char *log_level_names[] = {
-			[ BT_EVENT_CLASS_LOG_LEVEL_EMERGENCY ] = "TRACE_EMERG",
-			[ BT_EVENT_CLASS_LOG_LEVEL_ALERT ] = "TRACE_ALERT",
-			[ BT_EVENT_CLASS_LOG_LEVEL_CRITICAL ] = "TRACE_CRIT",
-			[ BT_EVENT_CLASS_LOG_LEVEL_ERROR ] = "TRACE_ERR",
-			[ BT_EVENT_CLASS_LOG_LEVEL_WARNING ] = "TRACE_WARNING",
-			[ BT_EVENT_CLASS_LOG_LEVEL_NOTICE ] = "TRACE_NOTICE",
-			[ BT_EVENT_CLASS_LOG_LEVEL_INFO ] = "TRACE_INFO",
-			[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_SYSTEM ] = "TRACE_DEBUG_SYSTEM",
-			[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_PROGRAM ] = "TRACE_DEBUG_PROGRAM",
-			[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_PROCESS ] = "TRACE_DEBUG_PROCESS",
-			[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_MODULE ] = "TRACE_DEBUG_MODULE",
-			[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_UNIT ] = "TRACE_DEBUG_UNIT",
-			[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_FUNCTION ] = "TRACE_DEBUG_FUNCTION",
-			[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_LINE ] = "TRACE_DEBUG_LINE",
-			[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG ] = "TRACE_DEBUG",
-		};
-		bt_event_class_log_level log_level;
-		const char *log_level_str = NULL;
-
-		prop_avail = bt_event_class_get_log_level(event_class,
-			&log_level);
-		if (prop_avail == BT_PROPERTY_AVAILABILITY_AVAILABLE) {
-			log_level_str = log_level_names[log_level];
-			BT_ASSERT_DBG(log_level_str);
-
-			if (!pretty->start_line) {
-				bt_common_g_string_append(pretty->string, ", ");
-			}
-			if (print_names) {
-				print_name_equal(pretty, "loglevel");
-			} else if (dom_print) {
-				bt_common_g_string_append(pretty->string, ":");
-			}
-
-			bt_common_g_string_append(pretty->string, log_level_str);
-			bt_common_g_string_append_printf(
-				pretty->string, " (%d)", (int) log_level);
-			dom_print = 1;
+	if (tmpl->log_level_str) {
+		if (!pretty->start_line) {
+			bt_common_g_string_append(pretty->string, ", ");
+		}
+		if (print_names) {
+			print_name_equal(pretty, "loglevel");
+		} else if (dom_print) {
+			bt_common_g_string_append(pretty->string, ":");
 		}
-	}
-	if (pretty->options.print_emf_field) {
-		const char *uri_str;
-
-		uri_str = bt_event_class_get_emf_uri(event_class);
-		if (uri_str) {
-			if (!pretty->start_line) {
-				bt_common_g_string_append(pretty->string, ", ");
-			}
-			if (print_names) {
-				print_name_equal(pretty, "model.emf.uri");
-			} else if (dom_print) {
-				bt_common_g_string_append(pretty->string, ":");
-			}
 
-			bt_common_g_string_append(pretty->string, uri_str);
-			dom_print = 1;
+		bt_common_g_string_append(pretty->string, tmpl->log_level_str);
+		dom_print = 1;
+	}
+	if (tmpl->emf_uri) {
+		if (!pretty->start_line) {
+			bt_common_g_string_append(pretty->string, ", ");
+		}
+		if (print_names) {
+			print_name_equal(pretty, "model.emf.uri");
+		} else if (dom_print) {
+			bt_common_g_string_append(pretty->string, ":");
 		}
+
+		bt_common_g_string_append(pretty->string, tmpl->emf_uri);
+		dom_print = 1;
 	}
 	if (dom_print && !print_names) {
 		bt_common_g_string_append(pretty->string, " ");
@@ -465,56 +589,35 @@ int print_event_header(struct pretty_component *pretty,
 		bt_common_g_string_append(pretty->string, ", ");
 	}
 	pretty->start_line = true;
-	if (print_names) {
-		print_name_equal(pretty, "name");
-	}
-	ev_name = bt_event_class_get_name(event_class);
-	if (pretty->use_colors) {
-		if (ev_name) {
-			bt_common_g_string_append(pretty->string,
-				color_event_name);
-		} else {
-			bt_common_g_string_append(pretty->string,
-				color_unknown);
-		}
-	}
-	if (ev_name) {
-		bt_common_g_string_append(pretty->string, ev_name);
-	} else {
-		bt_common_g_string_append(pretty->string, "<unknown>");
-	}
-	if (pretty->use_colors) {
-		bt_common_g_string_append(pretty->string, color_rst);
-	}
-	if (!print_names) {
-		bt_common_g_string_append(pretty->string, ": ");
-	} else {
-		bt_common_g_string_append(pretty->string, ", ");
-	}
+	bt_common_g_string_append(pretty->string, tmpl->name_fragment);
 
 end:
 	return ret;
 }
 
 static
-int print_integer(struct pretty_component *pretty,
-		const bt_field *field)
+void get_integer_print_props(const bt_field_class *int_fc,
+		struct integer_print_props *props)
+{
+	props->base = bt_field_class_integer_get_preferred_display_base(int_fc);
+	props->len = (int) bt_field_class_integer_get_field_value_range(int_fc);
+	props->is_signed = bt_field_class_type_is(
+		bt_field_class_get_type(int_fc),
+		BT_FIELD_CLASS_TYPE_SIGNED_INTEGER);
+}
+
+static
+int print_integer_with_props(struct pretty_component *pretty,
+		const bt_field *field, const struct integer_print_props *props)
 {
 	int ret = 0;
-	bt_field_class_integer_preferred_display_base base;
-	const bt_field_class *int_fc;
 	union {
 		uint64_t u;
 		int64_t s;
 	} v;
 	bool rst_color = false;
-	bt_field_class_type ft_type;
 
-	int_fc = bt_field_borrow_class_const(field);
-	BT_ASSERT_DBG(int_fc);
-	ft_type = bt_field_get_class_type(field);
-	if (bt_field_class_type_is(ft_type,
-			BT_FIELD_CLASS_TYPE_UNSIGNED_INTEGER)) {
+	if (!props->is_signed) {
 		v.u = bt_field_integer_unsigned_get_value(field);
 	} else {
 		v.s = bt_field_integer_signed_get_value(field);
@@ -525,13 +628,11 @@ int print_integer(struct pretty_component *pretty,
 		rst_color = true;
 	}
 
-	base = bt_field_class_integer_get_preferred_display_base(int_fc);
-	switch (base) {
+	switch (props->base) {
 	case BT_FIELD_CLASS_INTEGER_PREFERRED_DISPLAY_BASE_BINARY:
 	{
-		int bitnr, len;
+		int bitnr, len = props->len;
 
-		len = bt_field_class_integer_get_field_value_range(int_fc);
 		bt_common_g_string_append(pretty->string, "0b");
 		_bt_safe_lshift(v.u, 64 - len);
 		for (bitnr = 0; bitnr < len; bitnr++) {
@@ -543,12 +644,9 @@ int print_integer(struct pretty_component *pretty,
 	}
 	case BT_FIELD_CLASS_INTEGER_PREFERRED_DISPLAY_BASE_OCTAL:
 	{
-		if (bt_field_class_type_is(ft_type,
-				BT_FIELD_CLASS_TYPE_SIGNED_INTEGER)) {
-			int len;
+		if (props->is_signed) {
+			int len = props->len;
 
-			len = bt_field_class_integer_get_field_value_range(
-				int_fc);
 			if (len < 64) {
 			        size_t rounded_len;
 
@@ -563,8 +661,7 @@ int print_integer(struct pretty_component *pretty,
 		break;
 	}
 	case BT_FIELD_CLASS_INTEGER_PREFERRED_DISPLAY_BASE_DECIMAL:
-		if (bt_field_class_type_is(ft_type,
-				BT_FIELD_CLASS_TYPE_UNSIGNED_INTEGER)) {
+		if (!props->is_signed) {
 			bt_common_g_string_append_printf(pretty->string, "%" PRIu64, v.u);
 		} else {
 			bt_common_g_string_append_printf(pretty->string, "%" PRId64, v.s);
@@ -572,9 +669,8 @@ int print_integer(struct pretty_component *pretty,
 		break;
 	case BT_FIELD_CLASS_INTEGER_PREFERRED_DISPLAY_BASE_HEXADECIMAL:
 	{
-		int len;
+		int len = props->len;
 
-		len = bt_field_class_integer_get_field_value_range(int_fc);
 		if (len < 64) {
 			/* Round length to the nearest nibble */
 			uint8_t rounded_len = ((len + 3) & ~0x3);
@@ -596,6 +692,16 @@ end:
 	return ret;
 }
 
+static
+int print_integer(struct pretty_component *pretty,
+		const bt_field *field)
+{
+	struct integer_print_props props;
+
+	get_integer_print_props(bt_field_borrow_class_const(field), &props);
+	return print_integer_with_props(pretty, field, &props);
+}
+
 static
 void print_escape_string(struct pretty_component *pretty, const char *str)
 {
@@ -720,21 +826,22 @@ void print_enum_value_label_array(struct pretty_component *pretty,
  * Print arrays of labels and counts are ORed bit flags.
  */
 static
-void print_enum_value_bit_flag_label_arrays(struct pretty_component *pretty)
+void print_enum_value_bit_flag_label_arrays(struct pretty_component *pretty,
+		GPtrArray * const *bit_labels, uint64_t bits)
 {
 	uint64_t i;
 	bool first_label = true;
 
-	/* For each bit with a label count > 0, print the labels. */
+	/* For each bit set with a label count > 0, print the labels. */
 	for (i = 0; i < ENUMERATION_MAX_BITFLAGS_COUNT; i++) {
-		uint64_t label_count = pretty->enum_bit_labels[i]->len;
+		uint64_t label_count = bit_labels[i]->len;
 
-		if (label_count > 0) {
+		if ((bits & (UINT64_C(1) << i)) && label_count > 0) {
 			if (!first_label) {
 				bt_common_g_string_append(pretty->string, " | ");
 			}
 			print_enum_value_label_array(pretty, label_count,
-				(void *) pretty->enum_bit_labels[i]->pdata);
+				(void *) bit_labels[i]->pdata);
 			first_label = false;
 		}
 	}
@@ -824,7 +931,8 @@ void print_enum_unsigned_try_bit_flags(struct pretty_component *pretty,
 		}
 	}
 
-	print_enum_value_bit_flag_label_arrays(pretty);
+	print_enum_value_bit_flag_label_arrays(pretty,
+		pretty->enum_bit_labels, value);
 
 end:
 	return;
@@ -917,7 +1025,8 @@ void print_enum_signed_try_bit_flags(struct pretty_component *pretty,
 		}
 	}
 
-	print_enum_value_bit_flag_label_arrays(pretty);
+	print_enum_value_bit_flag_label_arrays(pretty,
+		pretty->enum_bit_labels, (uint64_t) value);
 
 end:
 	return;
@@ -959,9 +1068,56 @@ void print_enum_try_bit_flags(struct pretty_component *pretty,
 	}
 }
 
+/*
+ * Like print_enum_try_bit_flags(), but with the precomputed labels of
+ * each bit `bit_labels` (see `struct field_template`).
+ */
 static
-int print_enum(struct pretty_component *pretty,
-		const bt_field *field)
+void print_enum_try_bit_flags_with_labels(struct pretty_component *pretty,
+		const bt_field *field, GPtrArray * const *bit_labels)
+{
+	uint64_t value = 0;
+	uint64_t i;
+
+	if (bt_field_get_class_type(field) ==
+			BT_FIELD_CLASS_TYPE_UNSIGNED_ENUMERATION) {
+		value = bt_field_integer_unsigned_get_value(field);
+	} else {
+		int64_t signed_value = bt_field_integer_signed_get_value(field);
+
+		/* Negative value, not a bit flag enum */
+		if (signed_value > 0) {
+			value = (uint64_t) signed_value;
+		}
+	}
+
+	/* For 0, if there was a label for it, we would know by now. */
+	if (value == 0) {
+		print_enum_value_label_unknown(pretty);
+		goto end;
+	}
+
+	for (i = 0; i < ENUMERATION_MAX_BITFLAGS_COUNT; i++) {
+		if ((value & (UINT64_C(1) << i)) && bit_labels[i]->len == 0) {
+			/*
+			 * This bit has no matching label, so this field is
+			 * not a bit flag field, print unknown and return.
+			 */
+			print_enum_value_label_unknown(pretty);
+			goto end;
+		}
+	}
+
+	print_enum_value_bit_flag_label_arrays(pretty, bit_labels, value);
+
+end:
+	return;
+}
+
+static
+int print_enum_with_props(struct pretty_component *pretty,
+		const bt_field *field, const struct integer_print_props *props,
+		GPtrArray * const *bit_labels)
 {
 	int ret = 0;
 	bt_field_class_enumeration_mapping_label_array label_array;
@@ -996,14 +1152,19 @@ int print_enum(struct pretty_component *pretty,
 		 * decompose the value of the enum into bits and print it as a
 		 * bit flag enum.
 		 */
-		print_enum_try_bit_flags(pretty, field);
+		if (bit_labels) {
+			print_enum_try_bit_flags_with_labels(pretty, field,
+				bit_labels);
+		} else {
+			print_enum_try_bit_flags(pretty, field);
+		}
 	} else {
 		print_enum_value_label_unknown(pretty);
 	}
 
 	/* Print the actual value of the enum. */
 	bt_common_g_string_append(pretty->string, " : container = ");
-	ret = print_integer(pretty, field);
+	ret = print_integer_with_props(pretty, field, props);
 	if (ret != 0) {
 		goto end;
 	}
@@ -1012,6 +1173,16 @@ end:
 	return ret;
 }
 
+static
+int print_enum(struct pretty_component *pretty,
+		const bt_field *field)
+{
+	struct integer_print_props props;
+
+	get_integer_print_props(bt_field_borrow_class_const(field), &props);
+	return print_enum_with_props(pretty, field, &props, NULL);
+}
+
 static
 gint compare_strings(gconstpointer a, gconstpointer b)
 {
@@ -1405,7 +1576,7 @@ int print_field(struct pretty_component *pretty,
 
 static
 int print_stream_packet_context(struct pretty_component *pretty,
-		const bt_event *event)
+		const bt_event *event, const struct field_template *tmpl)
 {
 	int ret = 0;
 	const bt_packet *packet = NULL;
@@ -1426,7 +1597,8 @@ int print_stream_packet_context(struct pretty_component *pretty,
 	if (pretty->options.print_scope_field_names) {
 		print_name_equal(pretty, "stream.packet.context");
 	}
-	ret = print_field(pretty, main_field,
+	BT_ASSERT_DBG(tmpl);
+	ret = print_field_with_template(pretty, main_field, tmpl,
 			pretty->options.print_context_field_names);
 
 end:
@@ -1435,7 +1607,7 @@ end:
 
 static
 int print_stream_event_context(struct pretty_component *pretty,
-		const bt_event *event)
+		const bt_event *event, const struct field_template *tmpl)
 {
 	int ret = 0;
 	const bt_field *main_field = NULL;
@@ -1451,7 +1623,8 @@ int print_stream_event_context(struct pretty_component *pretty,
 	if (pretty->options.print_scope_field_names) {
 		print_name_equal(pretty, "stream.event.context");
 	}
-	ret = print_field(pretty, main_field,
+	BT_ASSERT_DBG(tmpl);
+	ret = print_field_with_template(pretty, main_field, tmpl,
 			pretty->options.print_context_field_names);
 
 end:
@@ -1460,7 +1633,7 @@ end:
 
 static
 int print_event_context(struct pretty_component *pretty,
-		const bt_event *event)
+		const bt_event *event, const struct field_template *tmpl)
 {
 	int ret = 0;
 	const bt_field *main_field = NULL;
@@ -1476,7 +1649,8 @@ int print_event_context(struct pretty_component *pretty,
 	if (pretty->options.print_scope_field_names) {
 		print_name_equal(pretty, "event.context");
 	}
-	ret = print_field(pretty, main_field,
+	BT_ASSERT_DBG(tmpl);
+	ret = print_field_with_template(pretty, main_field, tmpl,
 			pretty->options.print_context_field_names);
 
 end:
@@ -1485,7 +1659,7 @@ end:
 
 static
 int print_event_payload(struct pretty_component *pretty,
-		const bt_event *event)
+		const bt_event *event, const struct field_template *tmpl)
 {
 	int ret = 0;
 	const bt_field *main_field = NULL;
@@ -1501,7 +1675,8 @@ int print_event_payload(struct pretty_component *pretty,
 	if (pretty->options.print_scope_field_names) {
 		print_name_equal(pretty, "event.fields");
 	}
-	ret = print_field(pretty, main_field,
+	BT_ASSERT_DBG(tmpl);
+	ret = print_field_with_template(pretty, main_field, tmpl,
 			pretty->options.print_payload_field_names);
 
 end:
@@ -1509,78 +1684,757 @@ end:
 }
 
 static
-int flush_buf(FILE *stream, struct pretty_component *pretty)
+void field_template_destroy(struct field_template *tmpl)
 {
-	int ret = 0;
-
-	if (pretty->string->len == 0) {
+	if (!tmpl) {
 		goto end;
 	}
 
-	if (fwrite(pretty->string->str, pretty->string->len, 1, stream) != 1) {
-		ret = -1;
-	}
-
-end:
-	return ret;
-}
-
-int pretty_print_event(struct pretty_component *pretty,
-		const bt_message *event_msg)
-{
-	int ret;
-	const bt_event *event =
-		bt_message_event_borrow_event_const(event_msg);
-
-	BT_ASSERT_DBG(event);
-	pretty->start_line = true;
-	g_string_assign(pretty->string, "");
-	ret = print_event_header(pretty, event_msg);
-	if (ret != 0) {
-		goto end;
+	if (tmpl->member_prefixes) {
+		g_ptr_array_free(tmpl->member_prefixes, TRUE);
 	}
 
-	ret = print_stream_packet_context(pretty, event);
-	if (ret != 0) {
-		goto end;
+	if (tmpl->sub_templates) {
+		g_ptr_array_free(tmpl->sub_templates, TRUE);
 	}
 
-	ret = print_stream_event_context(pretty, event);
-	if (ret != 0) {
-		goto end;
-	}
+	if (tmpl->enum_bit_labels) {
+		uint64_t i;
 
-	ret = print_event_context(pretty, event);
-	if (ret != 0) {
-		goto end;
-	}
+		for (i = 0; i < ENUMERATION_MAX_BITFLAGS_COUNT; i++) {
+			if (tmpl->enum_bit_labels[i]) {
+				g_ptr_array_free(tmpl->enum_bit_labels[i], TRUE);
+			}
+		}
 
-	ret = print_event_payload(pretty, event);
-	if (ret != 0) {
-		goto end;
+		g_free(tmpl->enum_bit_labels);
 	}
 
-	bt_common_g_string_append_c(pretty->string, '\n');
-	if (flush_buf(pretty->out, pretty)) {
-		ret = -1;
-		goto end;
-	}
+	g_free(tmpl);
 
 end:
-	return ret;
+	return;
 }
 
+/*
+ * Finds, once for all, the labels of each bit of the enumeration field
+ * class `fc`, like print_enum_try_bit_flags() does for each field.
+ */
 static
-int print_discarded_elements_msg(struct pretty_component *pretty,
-		const bt_stream *stream,
-		const bt_clock_snapshot *begin_clock_snapshot,
-		const bt_clock_snapshot *end_clock_snapshot,
-		uint64_t count, const char *elem_type)
+int create_enum_bit_labels(struct field_template *tmpl,
+		const bt_field_class *fc)
 {
-	int ret = 0;
-	const bt_stream_class *stream_class = NULL;
-	const bt_trace *trace = NULL;
-	const char *stream_name;
+	bool is_signed = bt_field_class_get_type(fc) ==
+		BT_FIELD_CLASS_TYPE_SIGNED_ENUMERATION;
+	uint64_t i;
+
+	tmpl->enum_bit_labels = g_new0(GPtrArray *,
+		ENUMERATION_MAX_BITFLAGS_COUNT);
+	if (!tmpl->enum_bit_labels) {
+		return -1;
+	}
+
+	for (i = 0; i < ENUMERATION_MAX_BITFLAGS_COUNT; i++) {
+		uint64_t bit_value = UINT64_C(1) << i;
+
+		tmpl->enum_bit_labels[i] = g_ptr_array_new();
+		if (!tmpl->enum_bit_labels[i]) {
+			return -1;
+		}
+
+		if (is_signed) {
+			print_enum_signed_get_mapping_labels_for_value(fc,
+				(int64_t) bit_value, tmpl->enum_bit_labels[i]);
+		} else {
+			print_enum_unsigned_get_mapping_labels_for_value(fc,
+				bit_value, tmpl->enum_bit_labels[i]);
+		}
+	}
+
+	return 0;
+}
+
+static
+struct field_template *create_field_template(struct pretty_component *pretty,
+		const bt_field_class *fc, bool print_names);
+
+static
+int add_field_sub_template(struct pretty_component *pretty,
+		struct field_template *tmpl, const bt_field_class *fc,
+		bool print_names)
+{
+	struct field_template *sub_tmpl =
+		create_field_template(pretty, fc, print_names);
+
+	if (!sub_tmpl) {
+		return -1;
+	}
+
+	g_ptr_array_add(tmpl->sub_templates, sub_tmpl);
+	return 0;
+}
+
+static
+struct field_template *create_field_template(struct pretty_component *pretty,
+		const bt_field_class *fc, bool print_names)
+{
+	bt_field_class_type fc_type = bt_field_class_get_type(fc);
+	struct field_template *tmpl = g_new0(struct field_template, 1);
+	uint64_t i;
+
+	if (!tmpl) {
+		goto error;
+	}
+
+	if (fc_type == BT_FIELD_CLASS_TYPE_BOOL) {
+		tmpl->kind = FIELD_TEMPLATE_KIND_BOOL;
+	} else if (fc_type == BT_FIELD_CLASS_TYPE_BIT_ARRAY) {
+		tmpl->kind = FIELD_TEMPLATE_KIND_BIT_ARRAY;
+	} else if (bt_field_class_type_is(fc_type,
+			BT_FIELD_CLASS_TYPE_ENUMERATION)) {
+		tmpl->kind = FIELD_TEMPLATE_KIND_ENUM;
+		get_integer_print_props(fc, &tmpl->int_props);
+
+		if (pretty->options.print_enum_flags &&
+				create_enum_bit_labels(tmpl, fc)) {
+			goto error;
+		}
+	} else if (bt_field_class_type_is(fc_type,
+			BT_FIELD_CLASS_TYPE_INTEGER)) {
+		tmpl->kind = FIELD_TEMPLATE_KIND_INTEGER;
+		get_integer_print_props(fc, &tmpl->int_props);
+	} else if (fc_type == BT_FIELD_CLASS_TYPE_SINGLE_PRECISION_REAL) {
+		tmpl->kind = FIELD_TEMPLATE_KIND_SINGLE_PRECISION_REAL;
+	} else if (fc_type == BT_FIELD_CLASS_TYPE_DOUBLE_PRECISION_REAL) {
+		tmpl->kind = FIELD_TEMPLATE_KIND_DOUBLE_PRECISION_REAL;
+	} else if (fc_type == BT_FIELD_CLASS_TYPE_STRING) {
+		tmpl->kind = FIELD_TEMPLATE_KIND_STRING;
+	} else if (bt_field_class_type_is(fc_type, BT_FIELD_CLASS_TYPE_BLOB)) {
+		tmpl->kind = FIELD_TEMPLATE_KIND_BLOB;
+	} else {
+		tmpl->sub_templates = g_ptr_array_new_with_free_func(
+			(GDestroyNotify) field_template_destroy);
+		if (!tmpl->sub_templates) {
+			goto error;
+		}
+
+		if (fc_type == BT_FIELD_CLASS_TYPE_STRUCTURE) {
+			uint64_t member_count =
+				bt_field_class_structure_get_member_count(fc);
+
+			tmpl->kind = FIELD_TEMPLATE_KIND_STRUCT;
+			tmpl->member_prefixes =
+				g_ptr_array_new_with_free_func(g_free);
+			if (!tmpl->member_prefixes) {
+				goto error;
+			}
+
+			for (i = 0; i < member_count; i++) {
+				const bt_field_class_structure_member *member =
+					bt_field_class_structure_borrow_member_by_index_const(
+						fc, i);
+				const char *sep = i > 0 ? ", " : " ";
+				const char *name =
+					bt_field_class_structure_member_get_name(member);
+				gchar *prefix;
+
+				/* Same text as print_field_name_equal() */
+				if (!print_names) {
+					prefix = g_strdup(sep);
+				} else if (pretty->use_colors) {
+					prefix = g_strdup_printf("%s%s%s%s = ",
+						sep, color_field_name, name,
+						color_rst);
+				} else {
+					prefix = g_strdup_printf("%s%s = ",
+						sep, name);
+				}
+
+				g_ptr_array_add(tmpl->member_prefixes, prefix);
+
+				if (add_field_sub_template(pretty, tmpl,
+						bt_field_class_structure_member_borrow_field_class_const(
+							member),
+						print_names)) {
+					goto error;
+				}
+			}
+		} else if (bt_field_class_type_is(fc_type,
+				BT_FIELD_CLASS_TYPE_OPTION)) {
+			tmpl->kind = FIELD_TEMPLATE_KIND_OPTION;
+			if (add_field_sub_template(pretty, tmpl,
+					bt_field_class_option_borrow_field_class_const(fc),
+					print_names)) {
+				goto error;
+			}
+		} else if (bt_field_class_type_is(fc_type,
+				BT_FIELD_CLASS_TYPE_VARIANT)) {
+			uint64_t option_count =
+				bt_field_class_variant_get_option_count(fc);
+
+			tmpl->kind = FIELD_TEMPLATE_KIND_VARIANT;
+
+			for (i = 0; i < option_count; i++) {
+				if (add_field_sub_template(pretty, tmpl,
+						bt_field_class_variant_option_borrow_field_class_const(
+							bt_field_class_variant_borrow_option_by_index_const(
+								fc, i)),
+						print_names)) {
+					goto error;
+				}
+			}
+		} else {
+			if (fc_type == BT_FIELD_CLASS_TYPE_STATIC_ARRAY) {
+				tmpl->kind = FIELD_TEMPLATE_KIND_STATIC_ARRAY;
+			} else {
+				BT_ASSERT(bt_field_class_type_is(fc_type,
+					BT_FIELD_CLASS_TYPE_DYNAMIC_ARRAY));
+				tmpl->kind = FIELD_TEMPLATE_KIND_DYNAMIC_ARRAY;
+			}
+
+			if (add_field_sub_template(pretty, tmpl,
+					bt_field_class_array_borrow_element_field_class_const(fc),
+					print_names)) {
+				goto error;
+			}
+		}
+	}
+
+	goto end;
+
+error:
+	field_template_destroy(tmpl);
+	tmpl = NULL;
+
+end:
+	return tmpl;
+}
+
+static
+int print_struct_with_template(struct pretty_component *pretty,
+		const bt_field *_struct, const struct field_template *tmpl,
+		bool print_names)
+{
+	int ret = 0;
+	guint i;
+
+	bt_common_g_string_append(pretty->string, "{");
+	pretty->depth++;
+
+	for (i = 0; i < tmpl->sub_templates->len; i++) {
+		bt_common_g_string_append(pretty->string,
+			tmpl->member_prefixes->pdata[i]);
+		ret = print_field_with_template(pretty,
+			bt_field_structure_borrow_member_field_by_index_const(
+				_struct, i),
+			tmpl->sub_templates->pdata[i], print_names);
+		if (ret != 0) {
+			goto end;
+		}
+	}
+
+	pretty->depth--;
+	bt_common_g_string_append(pretty->string, " }");
+
+end:
+	return ret;
+}
+
+static
+int print_array_with_template(struct pretty_component *pretty,
+		const bt_field *array, const struct field_template *tmpl,
+		bool print_names)
+{
+	int ret = 0;
+	uint64_t len = bt_field_array_get_length(array);
+	const struct field_template *elem_tmpl = tmpl->sub_templates->pdata[0];
+	uint64_t i;
+
+	bt_common_g_string_append(pretty->string, "[");
+	pretty->depth++;
+
+	for (i = 0; i < len; i++) {
+		if (i != 0) {
+			bt_common_g_string_append(pretty->string, ", ");
+		} else {
+			bt_common_g_string_append(pretty->string, " ");
+		}
+		if (print_names) {
+			bt_common_g_string_append_printf(pretty->string,
+				"[%" PRIu64 "] = ", i);
+		}
+
+		ret = print_field_with_template(pretty,
+			bt_field_array_borrow_element_field_by_index_const(
+				array, i),
+			elem_tmpl, print_names);
+		if (ret != 0) {
+			goto end;
+		}
+	}
+
+	pretty->depth--;
+	bt_common_g_string_append(pretty->string, " ]");
+
+end:
+	return ret;
+}
+
+/*
+ * Prints the field `field` like print_field() does, but using the
+ * template `tmpl` of its class.
+ */
+static
+int print_field_with_template(struct pretty_component *pretty,
+		const bt_field *field, const struct field_template *tmpl,
+		bool print_names)
+{
+	int ret = 0;
+
+	switch (tmpl->kind) {
+	case FIELD_TEMPLATE_KIND_INTEGER:
+		ret = print_integer_with_props(pretty, field, &tmpl->int_props);
+		break;
+	case FIELD_TEMPLATE_KIND_ENUM:
+		ret = print_enum_with_props(pretty, field, &tmpl->int_props,
+			tmpl->enum_bit_labels);
+		break;
+	case FIELD_TEMPLATE_KIND_STRUCT:
+		ret = print_struct_with_template(pretty, field, tmpl,
+			print_names);
+		break;
+	case FIELD_TEMPLATE_KIND_STATIC_ARRAY:
+	case FIELD_TEMPLATE_KIND_DYNAMIC_ARRAY:
+		ret = print_array_with_template(pretty, field, tmpl,
+			print_names);
+		break;
+	case FIELD_TEMPLATE_KIND_OPTION:
+	{
+		const bt_field *content_field =
+			bt_field_option_borrow_field_const(field);
+
+		if (!content_field) {
+			bt_common_g_string_append(pretty->string, "<none>");
+			break;
+		}
+
+		bt_common_g_string_append(pretty->string, "{ ");
+		pretty->depth++;
+		ret = print_field_with_template(pretty, content_field,
+			tmpl->sub_templates->pdata[0], print_names);
+		if (ret != 0) {
+			break;
+		}
+		pretty->depth--;
+		bt_common_g_string_append(pretty->string, " }");
+		break;
+	}
+	case FIELD_TEMPLATE_KIND_VARIANT:
+	{
+		uint64_t opt_index =
+			bt_field_variant_get_selected_option_index(field);
+
+		bt_common_g_string_append(pretty->string, "{ ");
+		pretty->depth++;
+		ret = print_field_with_template(pretty,
+			bt_field_variant_borrow_selected_option_field_const(
+				field),
+			tmpl->sub_templates->pdata[opt_index], print_names);
+		if (ret != 0) {
+			break;
+		}
+		pretty->depth--;
+		bt_common_g_string_append(pretty->string, " }");
+		break;
+	}
+	default:
+		/* No class properties to reuse */
+		ret = print_field(pretty, field, print_names);
+		break;
+	}
+
+	return ret;
+}
+
+void pretty_event_class_template_destroy(
+		struct pretty_event_class_template *tmpl)
+{
+	if (!tmpl) {
+		goto end;
+	}
+
+	g_free(tmpl->log_level_str);
+	g_free(tmpl->name_fragment);
+	field_template_destroy(tmpl->packet_context);
+	field_template_destroy(tmpl->common_context);
+	field_template_destroy(tmpl->specific_context);
+	field_template_destroy(tmpl->payload);
+	g_free(tmpl);
+
+end:
+	return;
+}
+
+/*
+ * Creates the template of the root field class `fc` into `*tmpl`,
+ * if `fc` is set.
+ */
+static
+int create_root_field_template(struct pretty_component *pretty,
+		const bt_field_class *fc, bool print_names,
+		struct field_template **tmpl)
+{
+	if (!fc) {
+		return 0;
+	}
+
+	*tmpl = create_field_template(pretty, fc, print_names);
+	return *tmpl ? 0 : -1;
+}
+
+static
+struct pretty_event_class_template *create_event_class_template(
+		struct pretty_component *pretty,
+		const bt_event_class *event_class)
+{
+	static const char *log_level_names[] = {
+		[ BT_EVENT_CLASS_LOG_LEVEL_EMERGENCY ] = "TRACE_EMERG",
+		[ BT_EVENT_CLASS_LOG_LEVEL_ALERT ] = "TRACE_ALERT",
+		[ BT_EVENT_CLASS_LOG_LEVEL_CRITICAL ] = "TRACE_CRIT",
+		[ BT_EVENT_CLASS_LOG_LEVEL_ERROR ] = "TRACE_ERR",
+		[ BT_EVENT_CLASS_LOG_LEVEL_WARNING ] = "TRACE_WARNING",
+		[ BT_EVENT_CLASS_LOG_LEVEL_NOTICE ] = "TRACE_NOTICE",
+		[ BT_EVENT_CLASS_LOG_LEVEL_INFO ] = "TRACE_INFO",
+		[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_SYSTEM ] = "TRACE_DEBUG_SYSTEM",
+		[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_PROGRAM ] = "TRACE_DEBUG_PROGRAM",
+		[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_PROCESS ] = "TRACE_DEBUG_PROCESS",
+		[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_MODULE ] = "TRACE_DEBUG_MODULE",
+		[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_UNIT ] = "TRACE_DEBUG_UNIT",
+		[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_FUNCTION ] = "TRACE_DEBUG_FUNCTION",
+		[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG_LINE ] = "TRACE_DEBUG_LINE",
+		[ BT_EVENT_CLASS_LOG_LEVEL_DEBUG ] = "TRACE_DEBUG",
+	};
+	bool print_names = pretty->options.print_header_field_names;
+	const bt_stream_class *stream_class =
+		bt_event_class_borrow_stream_class_const(event_class);
+	struct pretty_event_class_template *tmpl =
+		g_new0(struct pretty_event_class_template, 1);
+	const char *ev_name;
+	GString *name_fragment = NULL;
+
+	if (!tmpl) {
+		goto error;
+	}
+
+	tmpl->trace_class = bt_stream_class_borrow_trace_class_const(
+		stream_class);
+
+	if (pretty->options.print_loglevel_field) {
+		bt_event_class_log_level log_level;
+
+		if (bt_event_class_get_log_level(event_class, &log_level) ==
+				BT_PROPERTY_AVAILABILITY_AVAILABLE) {
+			BT_ASSERT(log_level_names[log_level]);
+			tmpl->log_level_str = g_strdup_printf("%s (%d)",
+				log_level_names[log_level], (int) log_level);
+			if (!tmpl->log_level_str) {
+				goto error;
+			}
+		}
+	}
+
+	if (pretty->options.print_emf_field) {
+		tmpl->emf_uri = bt_event_class_get_emf_uri(event_class);
+	}
+
+	/* Event name, as print_event_header() used to print it */
+	name_fragment = g_string_new(NULL);
+	if (!name_fragment) {
+		goto error;
+	}
+
+	if (print_names) {
+		if (pretty->use_colors) {
+			g_string_append_printf(name_fragment, "%sname%s = ",
+				color_name, color_rst);
+		} else {
+			g_string_append(name_fragment, "name = ");
+		}
+	}
+
+	ev_name = bt_event_class_get_name(event_class);
+	if (pretty->use_colors) {
+		g_string_append(name_fragment,
+			ev_name ? color_event_name : color_unknown);
+	}
+
+	g_string_append(name_fragment, ev_name ? ev_name : "<unknown>");
+
+	if (pretty->use_colors) {
+		g_string_append(name_fragment, color_rst);
+	}
+
+	g_string_append(name_fragment, print_names ? ", " : ": ");
+	tmpl->name_fragment = g_string_free(name_fragment, FALSE);
+	name_fragment = NULL;
+
+	if (create_root_field_template(pretty,
+			bt_stream_class_borrow_packet_context_field_class_const(
+				stream_class),
+			pretty->options.print_context_field_names,
+			&tmpl->packet_context) ||
+			create_root_field_template(pretty,
+				bt_stream_class_borrow_event_common_context_field_class_const(
+					stream_class),
+				pretty->options.print_context_field_names,
+				&tmpl->common_context) ||
+			create_root_field_template(pretty,
+				bt_event_class_borrow_specific_context_field_class_const(
+					event_class),
+				pretty->options.print_context_field_names,
+				&tmpl->specific_context) ||
+			create_root_field_template(pretty,
+				bt_event_class_borrow_payload_field_class_const(
+					event_class),
+				pretty->options.print_payload_field_names,
+				&tmpl->payload)) {
+		goto error;
+	}
+
+	goto end;
+
+error:
+	if (name_fragment) {
+		g_string_free(name_fragment, TRUE);
+	}
+
+	pretty_event_class_template_destroy(tmpl);
+	tmpl = NULL;
+
+end:
+	return tmpl;
+}
+
+static
+gboolean event_class_template_is_of_trace_class(
+		gpointer key __attribute__((unused)), gpointer value,
+		gpointer user_data)
+{
+	const struct pretty_event_class_template *tmpl = value;
+
+	return tmpl->trace_class == user_data;
+}
+
+/*
+ * Called when a trace class of which the component created event
+ * class templates is destroyed: its event classes are gone too.
+ */
+static
+void trace_class_destruction_listener(const bt_trace_class *trace_class,
+		void *data)
+{
+	struct pretty_component *pretty = data;
+
+	g_hash_table_foreach_remove(pretty->event_class_templates,
+		event_class_template_is_of_trace_class, (gpointer) trace_class);
+	g_hash_table_remove(pretty->trace_class_listener_ids, trace_class);
+}
+
+static
+void remove_trace_class_listener(gpointer key, gpointer value,
+		gpointer user_data __attribute__((unused)))
+{
+	const bt_trace_class *trace_class = key;
+	const bt_listener_id *listener_id = value;
+
+	if (bt_trace_class_remove_destruction_listener(trace_class,
+			*listener_id) != BT_TRACE_CLASS_REMOVE_LISTENER_STATUS_OK) {
+		bt_current_thread_clear_error();
+	}
+}
+
+void pretty_remove_trace_class_listeners(struct pretty_component *pretty)
+{
+	if (!pretty->trace_class_listener_ids) {
+		goto end;
+	}
+
+	g_hash_table_foreach(pretty->trace_class_listener_ids,
+		remove_trace_class_listener, NULL);
+	g_hash_table_remove_all(pretty->trace_class_listener_ids);
+
+end:
+	return;
+}
+
+/*
+ * Returns the template of the event class `event_class`, creating it
+ * if needed.
+ */
+static
+const struct pretty_event_class_template *borrow_event_class_template(
+		struct pretty_component *pretty,
+		const bt_event_class *event_class)
+{
+	struct pretty_event_class_template *tmpl = g_hash_table_lookup(
+		pretty->event_class_templates, event_class);
+
+	if (tmpl) {
+		goto end;
+	}
+
+	tmpl = create_event_class_template(pretty, event_class);
+	if (!tmpl) {
+		goto end;
+	}
+
+	if (!g_hash_table_lookup(pretty->trace_class_listener_ids,
+			tmpl->trace_class)) {
+		bt_listener_id *listener_id = g_new(bt_listener_id, 1);
+
+		if (!listener_id) {
+			goto error;
+		}
+
+		if (bt_trace_class_add_destruction_listener(tmpl->trace_class,
+				trace_class_destruction_listener, pretty,
+				listener_id) != BT_TRACE_CLASS_ADD_LISTENER_STATUS_OK) {
+			g_free(listener_id);
+			goto error;
+		}
+
+		g_hash_table_insert(pretty->trace_class_listener_ids,
+			(gpointer) tmpl->trace_class, listener_id);
+	}
+
+	g_hash_table_insert(pretty->event_class_templates,
+		(gpointer) event_class, tmpl);
+	goto end;
+
+error:
+	pretty_event_class_template_destroy(tmpl);
+	tmpl = NULL;
+
+end:
+	return tmpl;
+}
+
+/*
+ * Writes the content of `pretty->string` to `stream`, and then clears
+ * it.
+ */
+static
+int flush_buf(FILE *stream, struct pretty_component *pretty)
+{
+	int ret = 0;
+
+	if (pretty->string->len == 0) {
+		goto end;
+	}
+
+	if (fwrite(pretty->string->str, pretty->string->len, 1, stream) != 1) {
+		ret = -1;
+	}
+
+	g_string_truncate(pretty->string, 0);
+
+end:
+	return ret;
+}
+
+int pretty_flush_output(struct pretty_component *pretty)
+{
+	int ret;
+
+	ret = flush_buf(pretty->out, pretty);
+	if (ret) {
+		goto end;
+	}
+
+	/* Also flush the stream to get any write error now */
+	if (fflush(pretty->out)) {
+		ret = -1;
+	}
+
+end:
+	return ret;
+}
+
+int pretty_print_event(struct pretty_component *pretty,
+		const bt_message *event_msg)
+{
+	int ret;
+	const bt_event *event =
+		bt_message_event_borrow_event_const(event_msg);
+	gsize line_start = pretty->string->len;
+	const struct pretty_event_class_template *tmpl;
+
+	BT_ASSERT_DBG(event);
+	tmpl = borrow_event_class_template(pretty,
+		bt_event_borrow_class_const(event));
+	if (!tmpl) {
+		ret = -1;
+		goto end;
+	}
+
+	pretty->start_line = true;
+	ret = print_event_header(pretty, event_msg, tmpl);
+	if (ret != 0) {
+		goto end;
+	}
+
+	ret = print_stream_packet_context(pretty, event, tmpl->packet_context);
+	if (ret != 0) {
+		goto end;
+	}
+
+	ret = print_stream_event_context(pretty, event, tmpl->common_context);
+	if (ret != 0) {
+		goto end;
+	}
+
+	ret = print_event_context(pretty, event, tmpl->specific_context);
+	if (ret != 0) {
+		goto end;
+	}
+
+	ret = print_event_payload(pretty, event, tmpl->payload);
+	if (ret != 0) {
+		goto end;
+	}
+
+	bt_common_g_string_append_c(pretty->string, '\n');
+
+	/*
+	 * Write the pending lines at once when there's enough of them
+	 * instead of calling fwrite() for each line.
+	 */
+	if (pretty->string->len >= pretty->options.output_buffer_size &&
+			flush_buf(pretty->out, pretty)) {
+		ret = -1;
+		goto end;
+	}
+
+end:
+	if (ret) {
+		/* Discard the partially printed line */
+		g_string_truncate(pretty->string, line_start);
+	}
+
+	return ret;
+}
+
+static
+int print_discarded_elements_msg(struct pretty_component *pretty,
+		const bt_stream *stream,
+		const bt_clock_snapshot *begin_clock_snapshot,
+		const bt_clock_snapshot *end_clock_snapshot,
+		uint64_t count, const char *elem_type)
+{
+	int ret = 0;
+	const bt_stream_class *stream_class = NULL;
+	const bt_trace *trace = NULL;
+	const char *stream_name;
 	const char *trace_name;
 	bt_uuid trace_uuid;
 	const char *trace_uid;
@@ -1617,8 +2471,16 @@ int print_discarded_elements_msg(struct pretty_component *pretty,
 		trace_uid = bt_trace_get_uid(trace);
 	}
 
+	/*
+	 * Write the pending lines first to keep the order of the
+	 * output when both streams are the same.
+	 */
+	if (flush_buf(pretty->out, pretty)) {
+		ret = -1;
+		goto end;
+	}
+
 	/* Format message */
-	g_string_assign(pretty->string, "");
 
 	if (count == UINT64_C(-1)) {
 		init_msg = "Tracer may have discarded";
@@ -1695,6 +2557,7 @@ int print_discarded_elements_msg(struct pretty_component *pretty,
 		ret = -1;
 	}
 
+end:
 	return ret;
 }
 
@@ -12,6 +12,8 @@
 #include "dummy/dummy.h"
 #include "muxer/comp.hpp"
 #include "muxer/msg-iter.hpp"
+#include "sampler/comp.hpp"
+#include "sampler/msg-iter.hpp"
 #include "trimmer/trimmer.h"
 
 #ifndef BT_BUILT_IN_PLUGINS
@@ -66,3 +68,10 @@ BT_PLUGIN_FILTER_COMPONENT_CLASS_DESCRIPTION(
     muxer, "Sort messages from multiple input ports to a single output port by time.");
 BT_PLUGIN_FILTER_COMPONENT_CLASS_HELP(muxer,
                                       "See the babeltrace2-filter.utils.muxer(7) manual page.");
+
+/* flt.utils.sampler */
+BT_CPP_PLUGIN_FILTER_COMPONENT_CLASS(sampler, bt2sampler::Comp);
+BT_PLUGIN_FILTER_COMPONENT_CLASS_DESCRIPTION(
+    sampler, "Keep a deterministic sample of the events of each stream.");
+BT_PLUGIN_FILTER_COMPONENT_CLASS_HELP(sampler,
+                                      "See the babeltrace2-filter.utils.sampler(7) manual page.");
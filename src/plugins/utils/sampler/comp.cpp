@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ */
+
+#include "cpp-common/bt2c/glib-up.hpp"
+
+#include "plugins/common/param-validation/param-validation.h"
+
+#include "comp.hpp"
+
+namespace bt2sampler {
+
+namespace {
+
+const char *modeChoices[] = {"count", "time", "hash", nullptr};
+
+const bt_param_validation_value_descr eventClsNamesElemDescr =
+    bt_param_validation_value_descr::makeString();
+
+const bt_param_validation_map_value_entry_descr paramsEntriesDescr[] = {
+    {"mode", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
+     bt_param_validation_value_descr::makeString(modeChoices)},
+    {"interval", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
+     bt_param_validation_value_descr::makeUnsignedInteger()},
+    {"period", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
+     bt_param_validation_value_descr::makeUnsignedInteger()},
+    {"field", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
+     bt_param_validation_value_descr::makeString()},
+    {"event-class-names", BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_OPTIONAL,
+     bt_param_validation_value_descr::makeArray(0, BT_PARAM_VALIDATION_INFINITE,
+                                                eventClsNamesElemDescr)},
+    BT_PARAM_VALIDATION_MAP_VALUE_ENTRY_END};
+
+} /* namespace */
+
+Comp::Comp(const bt2::SelfFilterComponent selfComp, const bt2::ConstMapValue params, void *) :
+    bt2::UserFilterComponent<Comp, MsgIter> {selfComp, "PLUGIN/FLT.UTILS.SAMPLER"}
+{
+    BT_CPPLOGI("Initializing component.");
+
+    /* Validate parameters */
+    {
+        gchar *error = nullptr;
+
+        if (bt_param_validation_validate(params.libObjPtr(), paramsEntriesDescr, &error) !=
+            BT_PARAM_VALIDATION_STATUS_OK) {
+            const bt2c::GCharUP errorFreer {error};
+
+            BT_CPPLOGE_APPEND_CAUSE_AND_THROW(bt2c::Error, "{}", error);
+        }
+    }
+
+    /* `mode` parameter */
+    bt2c::CStringView mode = "count";
+
+    if (const auto modeVal = params["mode"]) {
+        mode = modeVal->asString().value();
+
+        if (mode == "time") {
+            _mMode = Mode::Time;
+        } else if (mode == "hash") {
+            _mMode = Mode::Hash;
+        } else {
+            BT_ASSERT(mode == "count");
+        }
+    }
+
+    /* `interval` parameter */
+    if (const auto intervalVal = params["interval"]) {
+        _mInterval = intervalVal->asUnsignedInteger().value();
+
+        if (_mInterval == 0) {
+            BT_CPPLOGE_APPEND_CAUSE_AND_THROW(bt2c::Error,
+                                              "`interval` parameter must be greater than 0.");
+        }
+    }
+
+    /* `period` parameter */
+    if (const auto periodVal = params["period"]) {
+        _mPeriodNs = periodVal->asUnsignedInteger().value();
+
+        if (_mPeriodNs == 0) {
+            BT_CPPLOGE_APPEND_CAUSE_AND_THROW(bt2c::Error,
+                                              "`period` parameter must be greater than 0.");
+        }
+    } else if (_mMode == Mode::Time) {
+        BT_CPPLOGE_APPEND_CAUSE_AND_THROW(bt2c::Error,
+                                          "Missing `period` parameter with the `time` mode.");
+    }
+
+    /* `field` parameter */
+    if (const auto fieldVal = params["field"]) {
+        _mFieldName = fieldVal->asString().value().str();
+    } else if (_mMode == Mode::Hash) {
+        BT_CPPLOGE_APPEND_CAUSE_AND_THROW(bt2c::Error,
+                                          "Missing `field` parameter with the `hash` mode.");
+    }
+
+    /* `event-class-names` parameter */
+    if (const auto eventClsNamesVal = params["event-class-names"]) {
+        for (const auto eventClsNameVal : eventClsNamesVal->asArray()) {
+            _mEventClsNames.emplace(eventClsNameVal.asString().value());
+        }
+    }
+
+    /* Add single input and output ports */
+    try {
+        this->_addInputPort("in");
+        this->_addOutputPort("out");
+    } catch (const bt2c::Error&) {
+        BT_CPPLOGE_APPEND_CAUSE_AND_RETHROW("Failed to add the input and output ports.");
+    }
+
+    BT_CPPLOGI("Initialized component: mode={}, interval={}, period-ns={}, field-name={}, "
+               "event-class-name-count={}",
+               mode, _mInterval, _mPeriodNs, _mFieldName, _mEventClsNames.size());
+}
+
+void Comp::_getSupportedMipVersions(bt2::SelfComponentClass, bt2::ConstValue, bt2::LoggingLevel,
+                                    const bt2::UnsignedIntegerRangeSet ranges)
+{
+    ranges.addRange(0, 1);
+}
+
+} /* namespace bt2sampler */
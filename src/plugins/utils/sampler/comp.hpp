@@ -0,0 +1,74 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ */
+
+#ifndef BABELTRACE_PLUGINS_UTILS_SAMPLER_COMP_HPP
+#define BABELTRACE_PLUGINS_UTILS_SAMPLER_COMP_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+
+#include "cpp-common/bt2/plugin-dev.hpp"
+
+#include "msg-iter.hpp"
+
+namespace bt2sampler {
+
+class MsgIter;
+
+class Comp final : public bt2::UserFilterComponent<Comp, MsgIter>
+{
+    friend class MsgIter;
+    friend bt2::UserFilterComponent<Comp, MsgIter>;
+
+public:
+    /* How the message iterator decides to keep an event */
+    enum class Mode
+    {
+        /* Keep the first event out of each group of `_mInterval` events */
+        Count,
+
+        /* Keep the first event of each time bucket of `_mPeriodNs` ns */
+        Time,
+
+        /*
+         * Keep an event when the hash of the value of its
+         * `_mFieldName` payload member field is a multiple of
+         * `_mInterval`.
+         */
+        Hash,
+    };
+
+    explicit Comp(bt2::SelfFilterComponent selfComp, bt2::ConstMapValue params, void *);
+
+protected:
+    static void _getSupportedMipVersions(bt2::SelfComponentClass, bt2::ConstValue,
+                                         bt2::LoggingLevel, bt2::UnsignedIntegerRangeSet ranges);
+
+private:
+    /* Sampling mode */
+    Mode _mMode = Mode::Count;
+
+    /* Sampling interval (count and hash modes) */
+    std::uint64_t _mInterval = 10;
+
+    /* Duration of a time bucket (ns) (time mode) */
+    std::uint64_t _mPeriodNs = 0;
+
+    /* Name of the payload member field to hash (hash mode) */
+    std::string _mFieldName;
+
+    /*
+     * Names of the event classes to sample.
+     *
+     * Empty means to sample the events of all the event classes.
+     */
+    std::unordered_set<std::string> _mEventClsNames;
+};
+
+} /* namespace bt2sampler */
+
+#endif /* BABELTRACE_PLUGINS_UTILS_SAMPLER_COMP_HPP */
@@ -0,0 +1,629 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include <glib.h>
+
+#include <babeltrace2/babeltrace.h>
+
+#include "common/assert.h"
+#include "common/common.h"
+
+#include "comp.hpp"
+#include "msg-iter.hpp"
+
+namespace bt2sampler {
+
+MsgIter::MsgIter(const bt2::SelfMessageIterator selfMsgIter,
+                 const bt2::SelfMessageIteratorConfiguration cfg, bt2::SelfComponentOutputPort) :
+    bt2::UserMessageIterator<MsgIter, Comp> {selfMsgIter, "MSG-ITER"},
+    _mUpstreamMsgIter {this->_createMessageIterator(this->_component()._inputPorts()["in"])}
+{
+    /* We can seek forward if our upstream message iterator can */
+    cfg.canSeekForward(_mUpstreamMsgIter->canSeekForward());
+}
+
+MsgIter::~MsgIter()
+{
+    BT_CPPLOGI("Sampled events: event-count={}, kept-event-count={}, discarded-event-count={}",
+               _mEventCount, _mKeptEventCount, _mEventCount - _mKeptEventCount);
+}
+
+bool MsgIter::_canSeekBeginning()
+{
+    return _mUpstreamMsgIter->canSeekBeginning();
+}
+
+void MsgIter::_seekBeginning()
+{
+    /* This may throw! */
+    _mUpstreamMsgIter->seekBeginning();
+
+    /* Start over */
+    _mUpstreamMsgs.msgs.reset();
+    _mQueue.clear();
+    _mQueueBeginIndex = 0;
+    _mStreamStates.clear();
+}
+
+void MsgIter::_next(bt2::ConstMessageArray& msgs)
+{
+    while (true) {
+        this->_moveQueuedMsgs(msgs);
+
+        if (msgs.isFull()) {
+            return;
+        }
+
+        if (!_mUpstreamMsgs.msgs) {
+            if (!msgs.isEmpty()) {
+                /* Return what we have before getting more messages */
+                return;
+            }
+
+            /* This may throw */
+            _mUpstreamMsgs.msgs = _mUpstreamMsgIter->next();
+
+            if (!_mUpstreamMsgs.msgs) {
+                /*
+                 * No more upstream messages, and `msgs` is empty: this
+                 * is the end!
+                 *
+                 * All the streams ended, so there's no pending
+                 * discarded events message slot: the queue is empty.
+                 */
+                BT_ASSERT(_mQueue.empty());
+                BT_CPPLOGD("End of upstream message iterator.");
+                return;
+            }
+
+            _mUpstreamMsgs.index = 0;
+        }
+
+        this->_handleMsg((*_mUpstreamMsgs.msgs)[_mUpstreamMsgs.index]);
+        ++_mUpstreamMsgs.index;
+
+        if (_mUpstreamMsgs.index == _mUpstreamMsgs.msgs->length()) {
+            _mUpstreamMsgs.msgs.reset();
+        }
+    }
+}
+
+namespace {
+
+/*
+ * Returns the default clock snapshot of `msg`, a message having a
+ * stream, if any.
+ */
+bt2::OptionalBorrowedObject<bt2::ConstClockSnapshot>
+streamMsgDefCs(const bt2::ConstMessage msg) noexcept
+{
+    switch (msg.type()) {
+    case bt2::MessageType::Event:
+        if (msg.asEvent().streamClassDefaultClockClass()) {
+            return msg.asEvent().defaultClockSnapshot();
+        }
+
+        break;
+    case bt2::MessageType::PacketBeginning:
+        if (msg.asPacketBeginning().packet().stream().cls().packetsHaveBeginningClockSnapshot()) {
+            return msg.asPacketBeginning().defaultClockSnapshot();
+        }
+
+        break;
+    case bt2::MessageType::PacketEnd:
+        if (msg.asPacketEnd().packet().stream().cls().packetsHaveEndClockSnapshot()) {
+            return msg.asPacketEnd().defaultClockSnapshot();
+        }
+
+        break;
+    case bt2::MessageType::DiscardedEvents:
+        if (msg.asDiscardedEvents().stream().cls().discardedEventsHaveDefaultClockSnapshots()) {
+            return msg.asDiscardedEvents().beginningDefaultClockSnapshot();
+        }
+
+        break;
+    case bt2::MessageType::DiscardedPackets:
+        if (msg.asDiscardedPackets().stream().cls().discardedPacketsHaveDefaultClockSnapshots()) {
+            return msg.asDiscardedPackets().beginningDefaultClockSnapshot();
+        }
+
+        break;
+    case bt2::MessageType::StreamEnd:
+        if (msg.asStreamEnd().streamClassDefaultClockClass()) {
+            return msg.asStreamEnd().defaultClockSnapshot();
+        }
+
+        break;
+    default:
+        bt_common_abort();
+    }
+
+    return {};
+}
+
+/*
+ * Returns the stream of `msg`, a message having a stream.
+ */
+bt2::ConstStream msgStream(const bt2::ConstMessage msg) noexcept
+{
+    switch (msg.type()) {
+    case bt2::MessageType::PacketBeginning:
+        return msg.asPacketBeginning().packet().stream();
+    case bt2::MessageType::PacketEnd:
+        return msg.asPacketEnd().packet().stream();
+    case bt2::MessageType::DiscardedEvents:
+        return msg.asDiscardedEvents().stream();
+    case bt2::MessageType::DiscardedPackets:
+        return msg.asDiscardedPackets().stream();
+    case bt2::MessageType::StreamEnd:
+        return msg.asStreamEnd().stream();
+    default:
+        bt_common_abort();
+    }
+}
+
+/*
+ * 64-bit FNV-1a hash of the `size` bytes at `data`, continuing from
+ * the hash `hash`.
+ */
+std::uint64_t fnv1aHash(const void * const data, const std::size_t size,
+                        std::uint64_t hash = 0xcbf29ce484222325ULL) noexcept
+{
+    const auto bytes = static_cast<const unsigned char *>(data);
+
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+/*
+ * Returns the index of the time bucket of duration `periodNs`
+ * containing the time `ns`.
+ */
+std::int64_t timeBucket(const std::int64_t ns, const std::uint64_t periodNs) noexcept
+{
+    const auto period = static_cast<std::int64_t>(
+        std::min<std::uint64_t>(periodNs, std::numeric_limits<std::int64_t>::max()));
+    auto bucket = ns / period;
+
+    /* Round towards negative infinity */
+    if (ns % period != 0 && ns < 0) {
+        --bucket;
+    }
+
+    return bucket;
+}
+
+/*
+ * Position of the discarded events messages which the message iterator
+ * adds to a stream (see the `MsgIter` class comment).
+ */
+enum class DiscEventsMsgPos
+{
+    /* Before the beginning message of the packet */
+    BeforePkt,
+
+    /* Before the end message of the packet */
+    BeforePktEnd,
+
+    /* Before the next message of the stream having a time, if needed */
+    BeforeNextMsg,
+};
+
+/*
+ * Returns the position of the discarded events messages which the
+ * message iterator adds to a stream of class `streamCls`.
+ */
+DiscEventsMsgPos discEventsMsgPos(const bt2::ConstStreamClass streamCls) noexcept
+{
+    if (streamCls.supportsDiscardedEvents() && streamCls.supportsPackets()) {
+        if (!streamCls.discardedEventsHaveDefaultClockSnapshots()) {
+            return DiscEventsMsgPos::BeforePktEnd;
+        }
+
+        if (streamCls.packetsHaveBeginningClockSnapshot() &&
+            streamCls.packetsHaveEndClockSnapshot()) {
+            return DiscEventsMsgPos::BeforePkt;
+        }
+    }
+
+    return DiscEventsMsgPos::BeforeNextMsg;
+}
+
+} /* namespace */
+
+void MsgIter::_handleMsg(const bt2::ConstMessage msg)
+{
+    switch (msg.type()) {
+    case bt2::MessageType::Event:
+    {
+        const auto eventMsg = msg.asEvent();
+        const auto stream = eventMsg.event().stream();
+        auto& streamState = _mStreamStates[stream.libObjPtr()];
+
+        ++_mEventCount;
+
+        if (!this->_keepEvent(eventMsg, streamState)) {
+            ++streamState.discardedEventCount;
+            return;
+        }
+
+        ++_mKeptEventCount;
+
+        if (discEventsMsgPos(stream.cls()) == DiscEventsMsgPos::BeforeNextMsg) {
+            this->_queueDiscardedEventsMsg(stream, streamMsgDefCs(msg));
+        }
+
+        break;
+    }
+    case bt2::MessageType::PacketBeginning:
+        this->_handlePktBeginningMsg(msg.asPacketBeginning());
+        break;
+    case bt2::MessageType::PacketEnd:
+        this->_handlePktEndMsg(msg.asPacketEnd());
+        break;
+    case bt2::MessageType::DiscardedEvents:
+        this->_handleDiscEventsMsg(msg.asDiscardedEvents());
+        return;
+    case bt2::MessageType::DiscardedPackets:
+        this->_queueDiscardedEventsMsg(msgStream(msg), streamMsgDefCs(msg));
+        break;
+    case bt2::MessageType::StreamEnd:
+        this->_handleStreamEndMsg(msg.asStreamEnd());
+        break;
+    default:
+        break;
+    }
+
+    this->_queueMsg(msg.shared());
+}
+
+void MsgIter::_handlePktBeginningMsg(const bt2::ConstPacketBeginningMessage msg)
+{
+    const auto stream = msg.packet().stream();
+
+    if (discEventsMsgPos(stream.cls()) != DiscEventsMsgPos::BeforePkt) {
+        this->_queueDiscardedEventsMsg(stream, streamMsgDefCs(msg));
+        return;
+    }
+
+    auto& streamState = _mStreamStates[stream.libObjPtr()];
+
+    /*
+     * Reserve the place of the discarded events message of this packet,
+     * unless the upstream discarded events message which precedes this
+     * packet beginning message already did.
+     */
+    if (!streamState.discEventsMsgSlotIndex) {
+        streamState.discEventsMsgSlotIndex = this->_queueDiscEventsMsgSlot(bt2s::nullopt);
+    }
+
+    streamState.discEventsBeginCsVal = streamState.lastPktEndCsVal ?
+                                           *streamState.lastPktEndCsVal :
+                                           msg.defaultClockSnapshot().value();
+}
+
+void MsgIter::_handlePktEndMsg(const bt2::ConstPacketEndMessage msg)
+{
+    const auto stream = msg.packet().stream();
+
+    if (discEventsMsgPos(stream.cls()) != DiscEventsMsgPos::BeforePkt) {
+        this->_queueDiscardedEventsMsg(stream, streamMsgDefCs(msg));
+        return;
+    }
+
+    auto& streamState = _mStreamStates[stream.libObjPtr()];
+    const auto endCsVal = msg.defaultClockSnapshot().value();
+
+    this->_fillDiscEventsMsgSlot(stream, streamState, endCsVal);
+    streamState.lastPktEndCsVal = endCsVal;
+}
+
+void MsgIter::_handleDiscEventsMsg(const bt2::ConstDiscardedEventsMessage msg)
+{
+    const auto stream = msg.stream();
+    auto& streamState = _mStreamStates[stream.libObjPtr()];
+
+    if (discEventsMsgPos(stream.cls()) == DiscEventsMsgPos::BeforePkt) {
+        if (!streamState.discEventsMsgSlotIndex) {
+            /*
+             * Between two packets: this message is the discarded
+             * events message of the next packet, to which this message
+             * iterator adds its own count at the end of the packet.
+             */
+            streamState.discEventsMsgSlotIndex = this->_queueDiscEventsMsgSlot(msg.shared());
+            return;
+        }
+    } else if (streamState.discardedEventCount > 0) {
+        /* Report the events discarded so far with this message */
+        this->_queueMsg(this->_withDiscardedEventCount(msg, streamState.discardedEventCount));
+        streamState.discardedEventCount = 0;
+        return;
+    }
+
+    this->_queueMsg(msg.shared());
+}
+
+void MsgIter::_handleStreamEndMsg(const bt2::ConstStreamEndMessage msg)
+{
+    const auto stream = msg.stream();
+    const auto it = _mStreamStates.find(stream.libObjPtr());
+
+    if (it == _mStreamStates.end()) {
+        return;
+    }
+
+    if (it->second.discEventsMsgSlotIndex) {
+        /*
+         * Upstream discarded events message after the last packet: all
+         * the events which this message iterator discarded are within
+         * packets, so there's nothing to add to it.
+         */
+        BT_ASSERT_DBG(it->second.discardedEventCount == 0);
+
+        auto& queuedMsg = _mQueue[*it->second.discEventsMsgSlotIndex - _mQueueBeginIndex];
+
+        queuedMsg.isPending = false;
+    } else {
+        this->_queueDiscardedEventsMsg(stream, streamMsgDefCs(msg));
+    }
+
+    if (it->second.discardedEventCount > 0) {
+        BT_CPPLOGI("Cannot report discarded events without a default clock snapshot "
+                   "at the end of the stream: stream-id={}, discarded-event-count={}",
+                   stream.id(), it->second.discardedEventCount);
+    }
+
+    _mStreamStates.erase(it);
+}
+
+bool MsgIter::_keepEvent(const bt2::ConstEventMessage msg, _StreamState& streamState)
+{
+    const auto& comp = this->_component();
+    const auto event = msg.event();
+    const auto eventCls = event.cls();
+    auto eventClsStateIt = streamState.eventClsStates.find(eventCls.libObjPtr());
+
+    if (eventClsStateIt == streamState.eventClsStates.end()) {
+        /* First event of this class within this stream */
+        _EventClsState eventClsState;
+
+        if (comp._mEventClsNames.empty()) {
+            eventClsState.isSampled = true;
+        } else {
+            const auto name = eventCls.name();
+
+            eventClsState.isSampled =
+                name && comp._mEventClsNames.find(name.str()) != comp._mEventClsNames.end();
+        }
+
+        eventClsStateIt =
+            streamState.eventClsStates.emplace(eventCls.libObjPtr(), eventClsState).first;
+    }
+
+    auto& eventClsState = eventClsStateIt->second;
+
+    if (!eventClsState.isSampled) {
+        return true;
+    }
+
+    switch (comp._mMode) {
+    case Comp::Mode::Count:
+        return eventClsState.eventCount++ % comp._mInterval == 0;
+    case Comp::Mode::Time:
+    {
+        if (!msg.streamClassDefaultClockClass()) {
+            /* No time: keep all the events */
+            return true;
+        }
+
+        std::int64_t ns;
+
+        try {
+            ns = msg.defaultClockSnapshot().nsFromOrigin();
+        } catch (const bt2::OverflowError&) {
+            BT_CPPLOGD("Keeping event of which the time overflows: event-class-id={}",
+                       eventCls.id());
+            return true;
+        }
+
+        const auto bucket = timeBucket(ns, comp._mPeriodNs);
+
+        if (eventClsState.lastBucket && *eventClsState.lastBucket == bucket) {
+            return false;
+        }
+
+        eventClsState.lastBucket = bucket;
+        return true;
+    }
+    case Comp::Mode::Hash:
+        return this->_keepEventForHash(event);
+    default:
+        bt_common_abort();
+    }
+}
+
+bool MsgIter::_keepEventForHash(const bt2::ConstEvent event)
+{
+    const auto& comp = this->_component();
+    const auto payloadField = event.payloadField();
+
+    if (!payloadField) {
+        return true;
+    }
+
+    const auto field = (*payloadField)[comp._mFieldName];
+
+    if (!field) {
+        /* No such member field: keep all the events of this class */
+        return true;
+    }
+
+    std::uint64_t hash;
+
+    if (field->isBool()) {
+        const unsigned char val = field->asBool().value();
+
+        hash = fnv1aHash(&val, sizeof(val));
+    } else if (field->isUnsignedInteger()) {
+        const std::uint64_t val = field->asUnsignedInteger().value();
+
+        hash = fnv1aHash(&val, sizeof(val));
+    } else if (field->isSignedInteger()) {
+        const std::int64_t val = field->asSignedInteger().value();
+
+        hash = fnv1aHash(&val, sizeof(val));
+    } else if (field->isString()) {
+        const auto stringField = field->asString();
+
+        hash = fnv1aHash(stringField.value().data(), stringField.length());
+    } else {
+        /* Unsupported field type: keep the event */
+        return true;
+    }
+
+    return hash % comp._mInterval == 0;
+}
+
+void MsgIter::_queueDiscardedEventsMsg(
+    const bt2::ConstStream stream, const bt2::OptionalBorrowedObject<bt2::ConstClockSnapshot> cs)
+{
+    const auto it = _mStreamStates.find(stream.libObjPtr());
+
+    if (it == _mStreamStates.end() || it->second.discardedEventCount == 0) {
+        /* Nothing to report */
+        return;
+    }
+
+    auto& discardedEventCount = it->second.discardedEventCount;
+    const auto streamCls = stream.cls();
+
+    if (!streamCls.supportsDiscardedEvents()) {
+        /* Can't report them */
+        discardedEventCount = 0;
+        return;
+    }
+
+    bt2::DiscardedEventsMessage::Shared discEventsMsg;
+
+    if (streamCls.discardedEventsHaveDefaultClockSnapshots()) {
+        if (!cs) {
+            /* Report them later */
+            return;
+        }
+
+        /*
+         * Use the time of the message to forward as both the beginning
+         * and end times: this message iterator already forwarded
+         * messages of other streams having a time greater than the
+         * ones of the discarded events.
+         */
+        discEventsMsg = this->_createDiscardedEventsMessage(stream, cs->value(), cs->value());
+    } else {
+        discEventsMsg = this->_createDiscardedEventsMessage(stream);
+    }
+
+    discEventsMsg->count(discardedEventCount);
+    BT_CPPLOGD("Queuing discarded events message: stream-id={}, count={}", stream.id(),
+               discardedEventCount);
+    this->_queueMsg(std::move(discEventsMsg));
+    discardedEventCount = 0;
+}
+
+bt2::ConstMessage::Shared
+MsgIter::_withDiscardedEventCount(const bt2::ConstDiscardedEventsMessage msg,
+                                  const std::uint64_t count)
+{
+    const auto upstreamCount = msg.count();
+
+    if (!upstreamCount) {
+        /* Unknown count: it also covers the events discarded here */
+        return msg.shared();
+    }
+
+    const auto stream = msg.stream();
+    bt2::DiscardedEventsMessage::Shared discEventsMsg;
+
+    if (stream.cls().discardedEventsHaveDefaultClockSnapshots()) {
+        discEventsMsg = this->_createDiscardedEventsMessage(
+            stream, msg.beginningDefaultClockSnapshot().value(),
+            msg.endDefaultClockSnapshot().value());
+    } else {
+        discEventsMsg = this->_createDiscardedEventsMessage(stream);
+    }
+
+    discEventsMsg->count(*upstreamCount + count);
+    BT_CPPLOGD("Adding discarded events to upstream discarded events message: "
+               "stream-id={}, upstream-count={}, count={}",
+               stream.id(), *upstreamCount, count);
+    return discEventsMsg;
+}
+
+void MsgIter::_fillDiscEventsMsgSlot(const bt2::ConstStream stream, _StreamState& streamState,
+                                     const std::uint64_t endCsVal)
+{
+    BT_ASSERT_DBG(streamState.discEventsMsgSlotIndex);
+
+    auto& queuedMsg = _mQueue[*streamState.discEventsMsgSlotIndex - _mQueueBeginIndex];
+
+    BT_ASSERT_DBG(queuedMsg.isPending);
+
+    if (streamState.discardedEventCount > 0) {
+        if (queuedMsg.msg) {
+            queuedMsg.msg = this->_withDiscardedEventCount((*queuedMsg.msg)->asDiscardedEvents(),
+                                                           streamState.discardedEventCount);
+        } else {
+            auto discEventsMsg = this->_createDiscardedEventsMessage(
+                stream, streamState.discEventsBeginCsVal, endCsVal);
+
+            discEventsMsg->count(streamState.discardedEventCount);
+            BT_CPPLOGD("Inserting discarded events message before packet beginning message: "
+                       "stream-id={}, count={}, begin-cs-val={}, end-cs-val={}",
+                       stream.id(), streamState.discardedEventCount,
+                       streamState.discEventsBeginCsVal, endCsVal);
+            queuedMsg.msg = std::move(discEventsMsg);
+        }
+
+        streamState.discardedEventCount = 0;
+    }
+
+    queuedMsg.isPending = false;
+    streamState.discEventsMsgSlotIndex.reset();
+}
+
+void MsgIter::_queueMsg(bt2::ConstMessage::Shared msg)
+{
+    _mQueue.emplace_back();
+    _mQueue.back().msg = std::move(msg);
+}
+
+std::uint64_t MsgIter::_queueDiscEventsMsgSlot(bt2s::optional<bt2::ConstMessage::Shared> msg)
+{
+    _mQueue.emplace_back();
+    _mQueue.back().msg = std::move(msg);
+    _mQueue.back().isPending = true;
+    return _mQueueBeginIndex + _mQueue.size() - 1;
+}
+
+void MsgIter::_moveQueuedMsgs(bt2::ConstMessageArray& msgs)
+{
+    while (!_mQueue.empty() && !_mQueue.front().isPending && !msgs.isFull()) {
+        if (_mQueue.front().msg) {
+            msgs.append(std::move(*_mQueue.front().msg));
+        }
+
+        _mQueue.pop_front();
+        ++_mQueueBeginIndex;
+    }
+}
+
+} /* namespace bt2sampler */
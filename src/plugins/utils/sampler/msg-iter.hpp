@@ -0,0 +1,259 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright 2024 EfficiOS Inc.
+ */
+
+#ifndef BABELTRACE_PLUGINS_UTILS_SAMPLER_MSG_ITER_HPP
+#define BABELTRACE_PLUGINS_UTILS_SAMPLER_MSG_ITER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+#include "cpp-common/bt2/component-class-dev.hpp"
+#include "cpp-common/bt2/message-array.hpp"
+#include "cpp-common/bt2/message-iterator.hpp"
+#include "cpp-common/bt2/self-message-iterator-configuration.hpp"
+#include "cpp-common/bt2s/optional.hpp"
+
+namespace bt2sampler {
+
+class Comp;
+
+/*
+ * Sampler message iterator.
+ *
+ * This message iterator forwards all the messages of its upstream
+ * message iterator, except some of the event messages, depending on
+ * the sampling mode of its component.
+ *
+ * The sampling state is per stream and per event class, so that the
+ * result only depends on the event sequence of each stream, not on
+ * how the upstream message iterator interleaves the messages of
+ * different streams.
+ *
+ * When the class of a stream supports discarded events, the message
+ * iterator reports the events it discards with discarded events
+ * messages:
+ *
+ * Packets and discarded events messages with default clock snapshots:
+ *     One discarded events message per packet, immediately before the
+ *     packet beginning message, of which the time range goes from the
+ *     end of the previous packet (or the beginning of the packet for
+ *     the first one) to the end of the packet, like CTF does.
+ *
+ *     The message iterator therefore holds back all the messages to
+ *     forward from the beginning of such a packet until its end.
+ *
+ * Packets and discarded events messages without clock snapshots:
+ *     One discarded events message per packet, immediately before the
+ *     packet end message.
+ *
+ * Otherwise:
+ *     One discarded events message before the next message of the
+ *     same stream which it forwards and which has a default clock
+ *     snapshot, if needed: its beginning and end times are the time of
+ *     this next message.
+ *
+ * When there's already an upstream discarded events message where the
+ * message iterator would put its own, it adds its count to the count of
+ * the upstream message instead.
+ */
+class MsgIter final : public bt2::UserMessageIterator<MsgIter, Comp>
+{
+    friend bt2::UserMessageIterator<MsgIter, Comp>;
+
+private:
+    /* Sampling state of an event class within a stream */
+    struct _EventClsState final
+    {
+        /* Whether or not the sampling applies to this event class */
+        bool isSampled;
+
+        /* Number of events so far (count mode) */
+        std::uint64_t eventCount = 0;
+
+        /* Time bucket of the last kept event, if any (time mode) */
+        bt2s::optional<std::int64_t> lastBucket;
+    };
+
+    /* Sampling state of a stream */
+    struct _StreamState final
+    {
+        /*
+         * Number of events which this message iterator discarded since
+         * its last discarded events message for this stream.
+         */
+        std::uint64_t discardedEventCount = 0;
+
+        /*
+         * Index, within all the queued messages so far, of the pending
+         * discarded events message slot of the current or next packet,
+         * if any.
+         */
+        bt2s::optional<std::uint64_t> discEventsMsgSlotIndex;
+
+        /*
+         * Beginning default clock snapshot value of the discarded
+         * events message of the current packet.
+         */
+        std::uint64_t discEventsBeginCsVal = 0;
+
+        /* End default clock snapshot value of the last packet, if any */
+        bt2s::optional<std::uint64_t> lastPktEndCsVal;
+
+        /* Event class states (keys are libbabeltrace2 event classes) */
+        std::unordered_map<const bt_event_class *, _EventClsState> eventClsStates;
+    };
+
+    /* Message to forward */
+    struct _QueuedMsg final
+    {
+        /*
+         * Not set if it's a discarded events message slot which the
+         * message iterator didn't need.
+         */
+        bt2s::optional<bt2::ConstMessage::Shared> msg;
+
+        /* Whether or not it's a discarded events message slot to fill */
+        bool isPending = false;
+    };
+
+public:
+    explicit MsgIter(bt2::SelfMessageIterator selfMsgIter,
+                     bt2::SelfMessageIteratorConfiguration config,
+                     bt2::SelfComponentOutputPort selfPort);
+
+    ~MsgIter();
+
+private:
+    bool _canSeekBeginning();
+    void _seekBeginning();
+    void _next(bt2::ConstMessageArray& msgs);
+
+    /*
+     * Handles the upstream message `msg`, queuing zero, one, or two
+     * messages to forward.
+     */
+    void _handleMsg(bt2::ConstMessage msg);
+
+    /*
+     * Handles the upstream packet beginning message `msg`.
+     */
+    void _handlePktBeginningMsg(bt2::ConstPacketBeginningMessage msg);
+
+    /*
+     * Handles the upstream packet end message `msg`.
+     */
+    void _handlePktEndMsg(bt2::ConstPacketEndMessage msg);
+
+    /*
+     * Handles the upstream discarded events message `msg`.
+     */
+    void _handleDiscEventsMsg(bt2::ConstDiscardedEventsMessage msg);
+
+    /*
+     * Handles the upstream stream end message `msg`.
+     */
+    void _handleStreamEndMsg(bt2::ConstStreamEndMessage msg);
+
+    /*
+     * Returns whether or not to keep the event of `msg`, updating
+     * `streamState` accordingly.
+     */
+    bool _keepEvent(bt2::ConstEventMessage msg, _StreamState& streamState);
+
+    /*
+     * Returns whether or not to keep the event `event` considering the
+     * hash of the value of its configured payload member field.
+     */
+    bool _keepEventForHash(bt2::ConstEvent event);
+
+    /*
+     * If this message iterator discarded events of the stream `stream`
+     * since its last discarded events message for it, then queues a
+     * discarded events message.
+     *
+     * `cs` is the default clock snapshot of the next message of
+     * `stream`, if any.
+     *
+     * If the discarded events messages of `stream` need default clock
+     * snapshots and `cs` is missing, then this method doesn't queue
+     * anything: the next message of `stream` having a default clock
+     * snapshot will report those discarded events.
+     */
+    void _queueDiscardedEventsMsg(bt2::ConstStream stream,
+                                  bt2::OptionalBorrowedObject<bt2::ConstClockSnapshot> cs);
+
+    /*
+     * Returns a discarded events message which is like the upstream
+     * message `msg`, but of which the count also includes `count`
+     * events which this message iterator discarded.
+     */
+    bt2::ConstMessage::Shared _withDiscardedEventCount(bt2::ConstDiscardedEventsMessage msg,
+                                                       std::uint64_t count);
+
+    /*
+     * Fills the pending discarded events message slot of the stream
+     * `stream` having the state `streamState`, reporting the events
+     * which this message iterator discarded within the current packet.
+     *
+     * `endCsVal` is the end default clock snapshot value of the
+     * current packet.
+     */
+    void _fillDiscEventsMsgSlot(bt2::ConstStream stream, _StreamState& streamState,
+                                std::uint64_t endCsVal);
+
+    /*
+     * Queues the message `msg` to forward.
+     */
+    void _queueMsg(bt2::ConstMessage::Shared msg);
+
+    /*
+     * Queues a pending discarded events message slot, initially
+     * containing `msg`, returning its index (see
+     * `_StreamState::discEventsMsgSlotIndex`).
+     */
+    std::uint64_t _queueDiscEventsMsgSlot(bt2s::optional<bt2::ConstMessage::Shared> msg);
+
+    /*
+     * Moves the queued messages to forward to `msgs` until `msgs` is
+     * full or the next queued message is a pending discarded events
+     * message slot.
+     */
+    void _moveQueuedMsgs(bt2::ConstMessageArray& msgs);
+
+    /* Upstream message iterator */
+    bt2::MessageIterator::Shared _mUpstreamMsgIter;
+
+    /*
+     * Messages of the upstream message iterator to handle.
+     *
+     * `index` is the index of the next message to handle within `msgs`.
+     */
+    struct
+    {
+        bt2s::optional<bt2::ConstMessageArray> msgs;
+        std::size_t index;
+    } _mUpstreamMsgs;
+
+    /* Messages to forward, in order */
+    std::deque<_QueuedMsg> _mQueue;
+
+    /* Index, within all the queued messages so far, of `_mQueue[0]` */
+    std::uint64_t _mQueueBeginIndex = 0;
+
+    /* Stream states (keys are libbabeltrace2 streams) */
+    std::unordered_map<const bt_stream *, _StreamState> _mStreamStates;
+
+    /* Number of consumed event messages */
+    std::uint64_t _mEventCount = 0;
+
+    /* Number of kept event messages */
+    std::uint64_t _mKeptEventCount = 0;
+};
+
+} /* namespace bt2sampler */
+
+#endif /* BABELTRACE_PLUGINS_UTILS_SAMPLER_MSG_ITER_HPP */
@@ -0,0 +1,117 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Copyright (C) 2024 EfficiOS, Inc.
+ */
+
+#include <string>
+
+#include <babeltrace2/babeltrace.h>
+
+#include "cpp-common/bt2c/exc.hpp"
+#include "cpp-common/bt2c/str-scanner.hpp"
+
+#include "tap/tap.h"
+
+namespace {
+
+constexpr const char *jsonEscapeSeqStartList = "/bfnrtu";
+
+const bt2c::Logger logger {"test-module", "test-tag", bt2c::Logger::Level::None};
+
+/*
+ * Scans the whole literal string `litStr` (including its double
+ * quotes), setting `escapedStr` to the escaped string.
+ *
+ * Returns whether or not the string scanner scanned all of `litStr`.
+ */
+bool scanLitStr(const std::string& litStr, std::string& escapedStr)
+{
+    bt2c::StrScanner scanner {litStr, logger};
+    const auto str = scanner.tryScanLitStr(jsonEscapeSeqStartList);
+
+    if (!str.data()) {
+        return false;
+    }
+
+    escapedStr = str.to_string();
+    return scanner.isDone();
+}
+
+bool scanLitStrThrows(const std::string& litStr)
+{
+    bt2c::StrScanner scanner {litStr, logger};
+
+    try {
+        scanner.tryScanLitStr(jsonEscapeSeqStartList);
+    } catch (const bt2c::Error&) {
+        bt_current_thread_clear_error();
+        return true;
+    }
+
+    return false;
+}
+
+void testRegularChars()
+{
+    bool allOk = true;
+
+    /* Cover every length around the eight-character words */
+    for (std::size_t len = 0; len < 40; ++len) {
+        std::string str;
+        std::string escapedStr;
+
+        for (std::size_t i = 0; i < len; ++i) {
+            str.push_back(static_cast<char>('a' + i % 26));
+        }
+
+        if (!scanLitStr('"' + str + '"', escapedStr) || escapedStr != str) {
+            allOk = false;
+        }
+    }
+
+    ok(allOk, "Literal strings of regular characters are scanned");
+
+    std::string escapedStr;
+
+    ok(scanLitStr("\"caf\xc3\xa9 cr\xc3\xa8me br\xc3\xbbl\xc3\xa9\x65\"", escapedStr) &&
+           escapedStr == "caf\xc3\xa9 cr\xc3\xa8me br\xc3\xbbl\xc3\xa9\x65",
+       "UTF-8 sequences are kept as is");
+}
+
+void testEscapeSeqs()
+{
+    std::string escapedStr;
+
+    ok(scanLitStr(R"("abcdefghij\nklmnopqrstu\"vwxyz\\0123456789\u00e9\/end")", escapedStr) &&
+           escapedStr == "abcdefghij\nklmnopqrstu\"vwxyz\\0123456789\xc3\xa9/end",
+       "Escape sequences within regular characters are decoded");
+    ok(scanLitStr(R"("\t\t\t\t\t\t\t\t\t")", escapedStr) && escapedStr == "\t\t\t\t\t\t\t\t\t",
+       "Consecutive escape sequences are decoded");
+}
+
+void testInvalid()
+{
+    ok(scanLitStrThrows("\"abcdefghijklmnop\x01qrstuvwxyz\""),
+       "Control character after regular characters is illegal");
+    ok(scanLitStrThrows("\"abcdefghijklmnop\nqrstuvwxyz\""),
+       "Newline after regular characters is illegal");
+    ok(scanLitStrThrows("\"abcdefghijklmnop\x7fqrstuvwxyz\""),
+       "DEL character after regular characters is illegal");
+
+    bt2c::StrScanner scanner {"  \"abcdefghijklmnopqrstuvwxyz", logger};
+
+    ok(!scanner.tryScanLitStr(jsonEscapeSeqStartList).data() && *scanner.at() == '"',
+       "Unterminated literal string isn't scanned");
+}
+
+} /* namespace */
+
+int main()
+{
+    plan_tests(8);
+    testRegularChars();
+    testEscapeSeqs();
+    testInvalid();
+    return exit_status();
+}
@@ -0,0 +1,84 @@
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Copyright (C) 2024 EfficiOS Inc.
+#
+
+import bt2
+
+# Number of events of each stream: enough for a `sink.ctf.fs` component
+# to split each stream, which doesn't support packets, into a few
+# artificial packets of at least 4 MiB.
+_EVENT_COUNT = 40000
+
+
+class TheSourceIterator(bt2._UserMessageIterator):
+    def __init__(self, config, port):
+        tc, sc, ec = port.user_data
+
+        trace = tc()
+        self._streams = [
+            trace.create_stream(sc, name="stream-{}".format(i)) for i in range(2)
+        ]
+        self._ec = ec
+        self._msgs = [self._create_stream_beginning_message(s) for s in self._streams]
+        self._index = 0
+
+    def _create_event_msg(self, stream, index):
+        msg = self._create_event_message(self._ec, stream)
+        payload = msg.event.payload_field
+
+        # Field values of which the serialized sizes and alignment
+        # paddings vary from one event to another.
+        payload["str"] = "x" * ((index * 37) % 389)
+        payload["u8"] = index % 256
+        payload["dbl"] = index / 7
+        payload["arr"] = [i for i in range(index % 7)]
+
+        if index % 3 == 0:
+            payload["opt"].value = index
+
+        return msg
+
+    def __next__(self):
+        if len(self._msgs) == 0:
+            if self._index == _EVENT_COUNT:
+                raise StopIteration
+
+            for stream in self._streams:
+                self._msgs.append(self._create_event_msg(stream, self._index))
+
+            self._index += 1
+
+            if self._index == _EVENT_COUNT:
+                for stream in self._streams:
+                    self._msgs.append(self._create_stream_end_message(stream))
+
+        return self._msgs.pop(0)
+
+
+@bt2.plugin_component_class
+class TheSource(bt2._UserSourceComponent, message_iterator_class=TheSourceIterator):
+    def __init__(self, config, params, obj):
+        tc = self._create_trace_class()
+        payload_fc = tc.create_structure_field_class()
+        payload_fc.append_member("str", tc.create_string_field_class())
+        payload_fc.append_member("u8", tc.create_unsigned_integer_field_class(8))
+        payload_fc.append_member("dbl", tc.create_double_precision_real_field_class())
+        payload_fc.append_member(
+            "arr",
+            tc.create_dynamic_array_field_class(
+                tc.create_unsigned_integer_field_class(16)
+            ),
+        )
+        payload_fc.append_member(
+            "opt",
+            tc.create_option_field_class_without_selector_field(
+                tc.create_unsigned_integer_field_class(32)
+            ),
+        )
+        sc = tc.create_stream_class()
+        ec = sc.create_event_class(name="the-event", payload_field_class=payload_fc)
+        self._add_output_port("out", user_data=(tc, sc, ec))
+
+
+bt2.register_plugin(__name__, "foo")
@@ -4,6 +4,8 @@
  * Copyright (C) 2023 EfficiOS Inc.
  */
 
+#include <cstring>
+
 #include "common/assert.h"
 
 #include "utils/run-in.hpp"
@@ -12,7 +14,7 @@
 
 namespace {
 
-constexpr int NR_TESTS = 2;
+constexpr int NR_TESTS = 26;
 
 class TestStringClear final : public RunIn
 {
@@ -44,6 +46,181 @@ public:
     }
 };
 
+class TestEnumLabels final : public RunIn
+{
+public:
+    void onMsgIterInit(const bt2::SelfMessageIterator self) override
+    {
+        const auto traceCls = self.component().createTraceClass();
+        const auto streamCls = traceCls->createStreamClass();
+        const auto eventCls = streamCls->createEventClass();
+        const auto payloadCls = traceCls->createStructureFieldClass();
+        const auto uEnumCls = traceCls->createUnsignedEnumerationFieldClass();
+        const auto sEnumCls = traceCls->createSignedEnumerationFieldClass();
+
+        /* Overlapping mappings, one of them with two ranges */
+        uEnumCls->addMapping("low", bt2::UnsignedIntegerRangeSet::create()->addRange(0, 9));
+        uEnumCls->addMapping(
+            "mid", bt2::UnsignedIntegerRangeSet::create()->addRange(5, 14).addRange(100, 100));
+        uEnumCls->addMapping(
+            "max", bt2::UnsignedIntegerRangeSet::create()->addRange(UINT64_MAX - 1, UINT64_MAX));
+        sEnumCls->addMapping("neg", bt2::SignedIntegerRangeSet::create()->addRange(INT64_MIN, -1));
+        sEnumCls->addMapping("zero", bt2::SignedIntegerRangeSet::create()->addRange(0, 0));
+        payloadCls->appendMember("u", *uEnumCls);
+        payloadCls->appendMember("s", *sEnumCls);
+        eventCls->payloadFieldClass(*payloadCls);
+
+        const auto trace = traceCls->instantiate();
+        const auto stream = streamCls->instantiate(*trace);
+        const auto msg = self.createEventMessage(*eventCls, *stream);
+        const auto uField = (*msg->event().payloadField())["u"]->asUnsignedEnumeration();
+        const auto sField = (*msg->event().payloadField())["s"]->asSignedEnumeration();
+
+        uField.value(7);
+
+        {
+            const auto labels = uField.labels();
+
+            ok(labels.length() == 2 && labels[0] == "low" && labels[1] == "mid",
+               "overlapping mappings: labels in mapping order");
+        }
+
+        uField.value(12);
+        ok(uField.labels().length() == 1 && uField.labels()[0] == "mid",
+           "value within one mapping");
+        uField.value(100);
+        ok(uField.labels().length() == 1 && uField.labels()[0] == "mid",
+           "value within the second range of a mapping");
+        uField.value(50);
+        ok(uField.labels().length() == 0, "value within no mapping");
+        uField.value(UINT64_MAX);
+        ok(uField.labels().length() == 1 && uField.labels()[0] == "max",
+           "maximum value of the domain");
+        sField.value(INT64_MIN);
+
+        {
+            bt_field_class_enumeration_mapping_label_array labels;
+            std::uint64_t count;
+
+            bt_field_enumeration_signed_get_mapping_labels(sField.libObjPtr(), &labels, &count);
+            ok(count == 1 && std::strcmp(labels[0], "neg") == 0,
+               "minimum value of the signed domain");
+            sField.value(1);
+            bt_field_enumeration_signed_get_mapping_labels(sField.libObjPtr(), &labels, &count);
+            ok(count == 0, "signed value within no mapping");
+        }
+    }
+};
+
+/*
+ * Enumeration field classes of which the mapping ranges are close
+ * enough for the lookup index to use a dense table.
+ */
+class TestCompactEnumLabels final : public RunIn
+{
+public:
+    void onMsgIterInit(const bt2::SelfMessageIterator self) override
+    {
+        const auto traceCls = self.component().createTraceClass();
+        const auto streamCls = traceCls->createStreamClass();
+        const auto eventCls = streamCls->createEventClass();
+        const auto payloadCls = traceCls->createStructureFieldClass();
+        const auto uEnumCls = traceCls->createUnsignedEnumerationFieldClass();
+        const auto sEnumCls = traceCls->createSignedEnumerationFieldClass();
+        const auto wideEnumCls = traceCls->createUnsignedEnumerationFieldClass();
+
+        /* Ranges within 0..10, with a gap at 3 */
+        uEnumCls->addMapping("a", bt2::UnsignedIntegerRangeSet::create()->addRange(0, 2));
+        uEnumCls->addMapping("b", bt2::UnsignedIntegerRangeSet::create()->addRange(4, 10));
+        uEnumCls->addMapping("c", bt2::UnsignedIntegerRangeSet::create()->addRange(5, 5));
+
+        /* Ranges within -2..2, with a gap at 0 */
+        sEnumCls->addMapping("neg", bt2::SignedIntegerRangeSet::create()->addRange(-2, -1));
+        sEnumCls->addMapping("pos", bt2::SignedIntegerRangeSet::create()->addRange(1, 2));
+
+        /*
+         * From 0 to the maximum value, excluded: the label-less
+         * trailing segment starts at the maximum value.
+         */
+        wideEnumCls->addMapping(
+            "wide", bt2::UnsignedIntegerRangeSet::create()->addRange(0, UINT64_MAX - 1));
+
+        payloadCls->appendMember("u", *uEnumCls);
+        payloadCls->appendMember("s", *sEnumCls);
+        payloadCls->appendMember("wide", *wideEnumCls);
+        eventCls->payloadFieldClass(*payloadCls);
+
+        const auto trace = traceCls->instantiate();
+        const auto stream = streamCls->instantiate(*trace);
+        const auto msg = self.createEventMessage(*eventCls, *stream);
+        const auto uField = (*msg->event().payloadField())["u"]->asUnsignedEnumeration();
+        const auto sField = (*msg->event().payloadField())["s"]->asSignedEnumeration();
+        const auto wideField = (*msg->event().payloadField())["wide"]->asUnsignedEnumeration();
+
+        uField.value(0);
+        ok(uField.labels().length() == 1 && uField.labels()[0] == "a",
+           "compact: lowest value of the first range");
+        uField.value(2);
+        ok(uField.labels().length() == 1 && uField.labels()[0] == "a",
+           "compact: highest value of the first range");
+        uField.value(3);
+        ok(uField.labels().length() == 0, "compact: value within the gap");
+        uField.value(4);
+        ok(uField.labels().length() == 1 && uField.labels()[0] == "b",
+           "compact: lowest value of the second range");
+
+        uField.value(5);
+
+        {
+            const auto labels = uField.labels();
+
+            ok(labels.length() == 2 && labels[0] == "b" && labels[1] == "c",
+               "compact: overlapping mappings");
+        }
+
+        uField.value(10);
+        ok(uField.labels().length() == 1 && uField.labels()[0] == "b",
+           "compact: highest value of the domain");
+        uField.value(11);
+        ok(uField.labels().length() == 0, "compact: value following the domain");
+        uField.value(UINT64_MAX);
+        ok(uField.labels().length() == 0, "compact: maximum value");
+
+        bt_field_class_enumeration_mapping_label_array labels;
+        std::uint64_t count;
+
+        sField.value(INT64_MIN);
+        bt_field_enumeration_signed_get_mapping_labels(sField.libObjPtr(), &labels, &count);
+        ok(count == 0, "compact signed: minimum value");
+        sField.value(-3);
+        bt_field_enumeration_signed_get_mapping_labels(sField.libObjPtr(), &labels, &count);
+        ok(count == 0, "compact signed: value preceding the domain");
+        sField.value(-2);
+        bt_field_enumeration_signed_get_mapping_labels(sField.libObjPtr(), &labels, &count);
+        ok(count == 1 && std::strcmp(labels[0], "neg") == 0,
+           "compact signed: lowest value of the domain");
+        sField.value(0);
+        bt_field_enumeration_signed_get_mapping_labels(sField.libObjPtr(), &labels, &count);
+        ok(count == 0, "compact signed: value within the gap");
+        sField.value(2);
+        bt_field_enumeration_signed_get_mapping_labels(sField.libObjPtr(), &labels, &count);
+        ok(count == 1 && std::strcmp(labels[0], "pos") == 0,
+           "compact signed: highest value of the domain");
+        sField.value(3);
+        bt_field_enumeration_signed_get_mapping_labels(sField.libObjPtr(), &labels, &count);
+        ok(count == 0, "compact signed: value following the domain");
+
+        wideField.value(0);
+        ok(wideField.labels().length() == 1 && wideField.labels()[0] == "wide",
+           "whole domain: minimum value");
+        wideField.value(UINT64_MAX - 1);
+        ok(wideField.labels().length() == 1 && wideField.labels()[0] == "wide",
+           "whole domain: highest value of the range");
+        wideField.value(UINT64_MAX);
+        ok(wideField.labels().length() == 0, "whole domain: maximum value");
+    }
+};
+
 } /* namespace */
 
 int main()
@@ -53,5 +230,11 @@ int main()
     TestStringClear testStringClear;
     runIn(testStringClear, 0);
 
+    TestEnumLabels testEnumLabels;
+    runIn(testEnumLabels, 0);
+
+    TestCompactEnumLabels testCompactEnumLabels;
+    runIn(testCompactEnumLabels, 0);
+
     return exit_status();
 }
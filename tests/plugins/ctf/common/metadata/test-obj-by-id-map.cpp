@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Copyright (C) 2024 EfficiOS Inc.
+ */
+
+#include <vector>
+
+#include "plugins/ctf/common/metadata/ctf-ir.hpp"
+
+#include "tap/tap.h"
+
+namespace {
+
+struct Obj final
+{
+    unsigned long long id;
+};
+
+using Map = ctf::ir::internal::ObjByIdMap<Obj>;
+
+/*
+ * Inserts the objects `objs` into `map`, in order.
+ */
+void insertObjs(Map& map, std::vector<Obj>& objs)
+{
+    for (auto& obj : objs) {
+        map.insert(obj.id, obj);
+    }
+}
+
+/*
+ * Returns whether or not `map` maps the ID of each object of `objs` to
+ * this object.
+ */
+bool findsObjs(const Map& map, std::vector<Obj>& objs)
+{
+    for (auto& obj : objs) {
+        if (map.find(obj.id) != &obj) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void testEmpty()
+{
+    const Map map;
+
+    ok(!map.find(0) && !map.find(1) && !map.find(Map::minDenseLen) && !map.find(-1ULL),
+       "Empty map finds nothing");
+}
+
+void testDense()
+{
+    Map map;
+    std::vector<Obj> objs;
+
+    for (unsigned long long id = 0; id < 100; ++id) {
+        objs.push_back(Obj {id});
+    }
+
+    insertObjs(map, objs);
+    ok(findsObjs(map, objs), "Dense IDs: map finds all the objects");
+    ok(!map.find(100) && !map.find(127) && !map.find(Map::minDenseLen),
+       "Dense IDs: map finds nothing for other IDs");
+}
+
+void testDenseReverse()
+{
+    Map map;
+    std::vector<Obj> objs;
+
+    for (unsigned long long id = 500; id > 0; --id) {
+        objs.push_back(Obj {id - 1});
+    }
+
+    insertObjs(map, objs);
+    ok(findsObjs(map, objs), "Dense IDs in reverse order: map finds all the objects");
+    ok(!map.find(500), "Dense IDs in reverse order: map finds nothing for another ID");
+}
+
+void testSparse()
+{
+    Map map;
+    std::vector<Obj> objs {
+        Obj {3}, Obj {Map::minDenseLen}, Obj {5000}, Obj {1ULL << 40}, Obj {-1ULL},
+    };
+
+    insertObjs(map, objs);
+    ok(findsObjs(map, objs), "Sparse IDs: map finds all the objects");
+    ok(!map.find(0) && !map.find(4) && !map.find(Map::minDenseLen - 1) &&
+           !map.find(Map::minDenseLen + 1) && !map.find(4999) && !map.find((1ULL << 40) + 1) &&
+           !map.find(-2ULL),
+       "Sparse IDs: map finds nothing for other IDs");
+}
+
+void testSparseMovedToDense()
+{
+    Map map;
+    std::vector<Obj> sparseObjs {Obj {1500}, Obj {2047}, Obj {2048}, Obj {100000}};
+    std::vector<Obj> denseObjs;
+
+    /* Beyond the initial maximum length of the vector: sparse */
+    insertObjs(map, sparseObjs);
+    ok(findsObjs(map, sparseObjs), "Sparse IDs before growth: map finds all the objects");
+
+    /*
+     * Insert enough dense objects for the vector to grow up to 2048
+     * elements, covering some of the sparse IDs above.
+     */
+    for (unsigned long long id = 0; id <= Map::minDenseLen; ++id) {
+        denseObjs.push_back(Obj {id});
+    }
+
+    insertObjs(map, denseObjs);
+    ok(findsObjs(map, denseObjs), "Growth: map finds all the dense objects");
+    ok(findsObjs(map, sparseObjs), "Growth: map finds all the previously sparse objects");
+    ok(!map.find(1499) && !map.find(1501) && !map.find(2046) && !map.find(2049) &&
+           !map.find(99999),
+       "Growth: map finds nothing for other IDs");
+
+    /* Replace a moved object */
+    Obj otherObj {1500};
+
+    map.insert(otherObj.id, otherObj);
+    ok(map.find(1500) == &otherObj, "Growth: map finds a replaced moved object");
+}
+
+} /* namespace */
+
+int main()
+{
+    plan_tests(12);
+    testEmpty();
+    testDense();
+    testDenseReverse();
+    testSparse();
+    testSparseMovedToDense();
+    return exit_status();
+}
@@ -0,0 +1,192 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Copyright (C) 2024 EfficiOS Inc.
+ */
+
+#include <climits>
+#include <initializer_list>
+#include <vector>
+
+#include "plugins/ctf/common/metadata/ctf-ir.hpp"
+
+#include "tap/tap.h"
+
+namespace {
+
+/*
+ * Variant field class option of which the selector value type
+ * is `ValT`.
+ */
+template <typename ValT>
+class Opt final
+{
+public:
+    using RangeSet = ctf::IntRangeSet<ValT>;
+
+    explicit Opt(const std::initializer_list<typename RangeSet::Range> ranges) :
+        _mRanges {typename RangeSet::Set {ranges}}
+    {
+    }
+
+    const RangeSet& selFieldRanges() const noexcept
+    {
+        return _mRanges;
+    }
+
+private:
+    RangeSet _mRanges;
+};
+
+using UOpt = Opt<unsigned long long>;
+using SOpt = Opt<long long>;
+using ULookup = ctf::ir::internal::VariantFcOptLookup<unsigned long long>;
+using SLookup = ctf::ir::internal::VariantFcOptLookup<long long>;
+using URange = UOpt::RangeSet::Range;
+using SRange = SOpt::RangeSet::Range;
+
+constexpr auto uNoOpt = ULookup::noOpt;
+constexpr auto sNoOpt = SLookup::noOpt;
+
+void testEmpty()
+{
+    const std::vector<UOpt> opts;
+    const ULookup lookup {opts};
+
+    ok(lookup.isBuilt() && lookup.find(0) == uNoOpt && lookup.find(ULLONG_MAX) == uNoOpt,
+       "No options: selects nothing");
+}
+
+void testUnsignedCompact()
+{
+    const std::vector<UOpt> opts {
+        UOpt {URange {0, 2}},
+        UOpt {URange {4, 4}, URange {6, 7}},
+    };
+    const ULookup lookup {opts};
+
+    ok(lookup.isBuilt(), "Compact unsigned ranges: built");
+    ok(lookup.find(0) == 0 && lookup.find(2) == 0 && lookup.find(4) == 1 &&
+           lookup.find(6) == 1 && lookup.find(7) == 1,
+       "Compact unsigned ranges: selects the options");
+    ok(lookup.find(3) == uNoOpt && lookup.find(5) == uNoOpt && lookup.find(8) == uNoOpt &&
+           lookup.find(ULLONG_MAX) == uNoOpt,
+       "Compact unsigned ranges: selects nothing for other values");
+}
+
+void testUnsignedSparse()
+{
+    const std::vector<UOpt> opts {
+        UOpt {URange {1000000, 1000000}},
+        UOpt {URange {5, 7}, URange {1ULL << 40, (1ULL << 40) + 10}},
+        UOpt {URange {ULLONG_MAX, ULLONG_MAX}},
+    };
+    const ULookup lookup {opts};
+
+    ok(lookup.isBuilt(), "Sparse unsigned ranges: built");
+    ok(lookup.find(1000000) == 0 && lookup.find(5) == 1 && lookup.find(7) == 1 &&
+           lookup.find(1ULL << 40) == 1 && lookup.find((1ULL << 40) + 10) == 1 &&
+           lookup.find(ULLONG_MAX) == 2,
+       "Sparse unsigned ranges: selects the options");
+    ok(lookup.find(0) == uNoOpt && lookup.find(4) == uNoOpt && lookup.find(8) == uNoOpt &&
+           lookup.find(999999) == uNoOpt && lookup.find(1000001) == uNoOpt &&
+           lookup.find((1ULL << 40) + 11) == uNoOpt && lookup.find(ULLONG_MAX - 1) == uNoOpt,
+       "Sparse unsigned ranges: selects nothing for other values");
+}
+
+void testSignedCompact()
+{
+    const std::vector<SOpt> opts {
+        SOpt {SRange {-3, -1}},
+        SOpt {SRange {0, 0}},
+        SOpt {SRange {2, 3}},
+    };
+    const SLookup lookup {opts};
+
+    ok(lookup.isBuilt(), "Compact negative ranges: built");
+    ok(lookup.find(-3) == 0 && lookup.find(-1) == 0 && lookup.find(0) == 1 &&
+           lookup.find(2) == 2 && lookup.find(3) == 2,
+       "Compact negative ranges: selects the options");
+    ok(lookup.find(LLONG_MIN) == sNoOpt && lookup.find(-4) == sNoOpt &&
+           lookup.find(1) == sNoOpt && lookup.find(4) == sNoOpt &&
+           lookup.find(LLONG_MAX) == sNoOpt,
+       "Compact negative ranges: selects nothing for other values");
+}
+
+void testSignedSparse()
+{
+    const std::vector<SOpt> opts {
+        SOpt {SRange {LLONG_MIN, -1000000}},
+        SOpt {SRange {-5, -3}, SRange {100000, 100000}},
+        SOpt {SRange {LLONG_MAX, LLONG_MAX}},
+    };
+    const SLookup lookup {opts};
+
+    ok(lookup.isBuilt(), "Sparse negative ranges: built");
+    ok(lookup.find(LLONG_MIN) == 0 && lookup.find(-1000000) == 0 && lookup.find(-5) == 1 &&
+           lookup.find(-3) == 1 && lookup.find(100000) == 1 && lookup.find(LLONG_MAX) == 2,
+       "Sparse negative ranges: selects the options");
+    ok(lookup.find(-999999) == sNoOpt && lookup.find(-6) == sNoOpt &&
+           lookup.find(-2) == sNoOpt && lookup.find(0) == sNoOpt &&
+           lookup.find(99999) == sNoOpt && lookup.find(LLONG_MAX - 1) == sNoOpt,
+       "Sparse negative ranges: selects nothing for other values");
+}
+
+void testSignedWholeDomain()
+{
+    const std::vector<SOpt> opts {SOpt {SRange {LLONG_MIN, LLONG_MAX}}};
+    const SLookup lookup {opts};
+
+    ok(lookup.isBuilt() && lookup.find(LLONG_MIN) == 0 && lookup.find(0) == 0 &&
+           lookup.find(LLONG_MAX) == 0,
+       "Whole signed domain: selects the option");
+}
+
+void testOverlapping()
+{
+    {
+        const std::vector<UOpt> opts {UOpt {URange {0, 10}}, UOpt {URange {5, 5}}};
+
+        ok(!ULookup {opts}.isBuilt(), "Overlapping ranges: not built");
+    }
+
+    {
+        const std::vector<UOpt> opts {UOpt {URange {0, 4}}, UOpt {URange {4, 9}}};
+
+        ok(!ULookup {opts}.isBuilt(), "Ranges sharing a value: not built");
+    }
+
+    {
+        /* The third option overlaps the first one, not the second one */
+        const std::vector<SOpt> opts {
+            SOpt {SRange {-100, 100}},
+            SOpt {SRange {200, 300}},
+            SOpt {SRange {-50, -40}},
+        };
+
+        ok(!SLookup {opts}.isBuilt(), "Overlapping non-consecutive ranges: not built");
+    }
+
+    {
+        const std::vector<UOpt> opts {UOpt {URange {0, 4}}, UOpt {URange {5, 9}}};
+        const ULookup lookup {opts};
+
+        ok(lookup.isBuilt() && lookup.find(4) == 0 && lookup.find(5) == 1,
+           "Contiguous ranges: built");
+    }
+}
+
+} /* namespace */
+
+int main()
+{
+    plan_tests(18);
+    testEmpty();
+    testUnsignedCompact();
+    testUnsignedSparse();
+    testSignedCompact();
+    testSignedSparse();
+    testSignedWholeDomain();
+    testOverlapping();
+    return exit_status();
+}
@@ -197,7 +197,7 @@ static void test_bin_info_build_id(const char *bin_info_dir)
         exit(EXIT_FAILURE);
     }
 
-    ret = bt_fd_cache_init(&fdc, BT_LOG_OUTPUT_LEVEL);
+    ret = bt_fd_cache_init(&fdc, 0, BT_LOG_OUTPUT_LEVEL);
     if (ret != 0) {
         diag("Failed to initialize FD cache");
         exit(EXIT_FAILURE);
@@ -247,7 +247,7 @@ static void test_bin_info_debug_link(const char *bin_info_dir)
         exit(EXIT_FAILURE);
     }
 
-    ret = bt_fd_cache_init(&fdc, BT_LOG_OUTPUT_LEVEL);
+    ret = bt_fd_cache_init(&fdc, 0, BT_LOG_OUTPUT_LEVEL);
     if (ret != 0) {
         diag("Failed to initialize FD cache");
         exit(EXIT_FAILURE);
@@ -294,7 +294,7 @@ static void test_bin_info_elf(const char *bin_info_dir)
         exit(EXIT_FAILURE);
     }
 
-    ret = bt_fd_cache_init(&fdc, BT_LOG_OUTPUT_LEVEL);
+    ret = bt_fd_cache_init(&fdc, 0, BT_LOG_OUTPUT_LEVEL);
     if (ret != 0) {
         diag("Failed to initialize FD cache");
         exit(EXIT_FAILURE);
@@ -337,7 +337,7 @@ static void test_bin_info_bundled(const char *bin_info_dir)
         exit(EXIT_FAILURE);
     }
 
-    ret = bt_fd_cache_init(&fdc, BT_LOG_OUTPUT_LEVEL);
+    ret = bt_fd_cache_init(&fdc, 0, BT_LOG_OUTPUT_LEVEL);
     if (ret != 0) {
         diag("Failed to initialize FD cache");
         exit(EXIT_FAILURE);
@@ -0,0 +1,134 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Copyright (C) 2024 EfficiOS Inc.
+ *
+ * Babeltrace file descriptor cache tests
+ */
+
+#include <fcntl.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <babeltrace2/babeltrace.h>
+
+#include "fd-cache/fd-cache.hpp"
+
+#include "tap/tap.h"
+
+#define NR_TESTS 12
+
+#define FILE_COUNT 3
+
+static bool fd_is_open(int fd)
+{
+    return fcntl(fd, F_GETFD) != -1;
+}
+
+static void test_sharing(gchar **paths, const gchar *link_path)
+{
+    struct bt_fd_cache fdc;
+    struct bt_fd_cache_handle *handle, *link_handle;
+
+    ok(bt_fd_cache_init(&fdc, 0, BT_LOGGING_LEVEL_NONE) == 0, "bt_fd_cache_init succeeds");
+    handle = bt_fd_cache_get_handle(&fdc, paths[0]);
+    link_handle = bt_fd_cache_get_handle(&fdc, link_path);
+    ok(handle && handle == link_handle, "different paths of the same file share a handle");
+    ok(fdc.stats.opens == 1 && fdc.stats.hits == 1, "file is opened once");
+    bt_fd_cache_put_handle(&fdc, link_handle);
+    bt_fd_cache_put_handle(&fdc, handle);
+    ok(fd_is_open(handle->fd), "unreferenced file descriptor stays open");
+
+    handle = bt_fd_cache_get_handle(&fdc, paths[0]);
+    ok(fdc.stats.opens == 1 && fdc.stats.hits == 2, "unreferenced handle is reused");
+    bt_fd_cache_put_handle(&fdc, handle);
+    bt_fd_cache_fini(&fdc);
+}
+
+static void test_eviction(gchar **paths)
+{
+    struct bt_fd_cache fdc;
+    struct bt_fd_cache_handle *handles[FILE_COUNT];
+    int fds[FILE_COUNT];
+    unsigned int i;
+
+    bt_fd_cache_init(&fdc, 2, BT_LOGGING_LEVEL_NONE);
+
+    for (i = 0; i < FILE_COUNT; i++) {
+        handles[i] = bt_fd_cache_get_handle(&fdc, paths[i]);
+        fds[i] = handles[i]->fd;
+    }
+
+    ok(fdc.stats.evictions == 0 && fd_is_open(fds[0]) && fd_is_open(fds[1]) &&
+           fd_is_open(fds[2]),
+       "referenced handles are never evicted");
+
+    /* Put the handles in the order 1, 0, 2: 1 is the LRU one */
+    bt_fd_cache_put_handle(&fdc, handles[1]);
+    ok(fdc.stats.evictions == 1 && !fd_is_open(fds[1]),
+       "putting a handle over the maximum evicts it");
+    bt_fd_cache_put_handle(&fdc, handles[0]);
+    bt_fd_cache_put_handle(&fdc, handles[2]);
+    ok(fdc.stats.evictions == 1 && fd_is_open(fds[0]) && fd_is_open(fds[2]),
+       "unreferenced handles stay open up to the maximum");
+
+    /* Get 0 again: 2 becomes the LRU unreferenced handle */
+    handles[0] = bt_fd_cache_get_handle(&fdc, paths[0]);
+    ok(handles[0]->fd == fds[0] && fdc.stats.opens == 3, "unreferenced handle is reused");
+    handles[1] = bt_fd_cache_get_handle(&fdc, paths[1]);
+    ok(fdc.stats.opens == 4 && fdc.stats.evictions == 2 && g_hash_table_size(fdc.cache) == 2,
+       "opening a file evicts the least recently used handle");
+    fds[1] = handles[1]->fd;
+    bt_fd_cache_put_handle(&fdc, handles[0]);
+    bt_fd_cache_put_handle(&fdc, handles[1]);
+    bt_fd_cache_fini(&fdc);
+    ok(!fd_is_open(fds[0]) && !fd_is_open(fds[1]),
+       "finalizing the cache closes the unreferenced file descriptors");
+    ok(fdc.stats.opens == 4 && fdc.stats.hits == 1, "open and hit counts are correct");
+}
+
+int main(void)
+{
+    gchar *paths[FILE_COUNT];
+    gchar *dir_path, *link_path;
+    unsigned int i;
+
+    plan_tests(NR_TESTS);
+
+    dir_path = g_dir_make_tmp("test-fd-cache.XXXXXX", nullptr);
+    if (!dir_path) {
+        diag("Failed to create temporary directory");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < FILE_COUNT; i++) {
+        gchar *name = g_strdup_printf("file%u", i);
+
+        paths[i] = g_build_filename(dir_path, name, nullptr);
+        g_file_set_contents(paths[i], name, -1, nullptr);
+        g_free(name);
+    }
+
+    link_path = g_build_filename(dir_path, "link", nullptr);
+    if (symlink(paths[0], link_path) != 0) {
+        diag("Failed to create symbolic link");
+        return EXIT_FAILURE;
+    }
+
+    test_sharing(paths, link_path);
+    test_eviction(paths);
+
+    g_unlink(link_path);
+    g_free(link_path);
+
+    for (i = 0; i < FILE_COUNT; i++) {
+        g_unlink(paths[i]);
+        g_free(paths[i]);
+    }
+
+    g_rmdir(dir_path);
+    g_free(dir_path);
+    return exit_status();
+}
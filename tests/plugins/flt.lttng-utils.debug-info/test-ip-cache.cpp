@@ -0,0 +1,157 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Copyright (C) 2024 EfficiOS Inc.
+ *
+ * Babeltrace (VPID, IP) cache tests
+ */
+
+#include <lttng-utils/debug-info/ip-cache.hpp>
+
+#include <glib.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "tap/tap.h"
+
+#define NR_TESTS 17
+
+static unsigned int destroyed_value_count;
+
+static void value_destroy(gpointer value)
+{
+    g_free(value);
+    destroyed_value_count++;
+}
+
+static gpointer new_value(uint64_t ip)
+{
+    uint64_t *value = g_new0(uint64_t, 1);
+
+    *value = ip;
+    return value;
+}
+
+static bool has_entry(struct ip_cache *cache, int64_t vpid, uint64_t ip)
+{
+    const uint64_t *value = static_cast<const uint64_t *>(ip_cache_lookup(cache, vpid, ip));
+
+    return value && *value == ip;
+}
+
+static void test_lookup_insert(void)
+{
+    struct ip_cache *cache = ip_cache_create(4, value_destroy);
+
+    ok(cache, "ip_cache_create succeeds");
+    ok(!ip_cache_lookup(cache, 1, 0x1000), "lookup misses in empty cache");
+
+    ip_cache_insert(cache, 1, 0x1000, new_value(0x1000));
+    ok(has_entry(cache, 1, 0x1000), "lookup hits after insertion");
+    ok(!ip_cache_lookup(cache, 2, 0x1000), "lookup misses with other VPID");
+
+    ok(cache->stats.lookups == 3 && cache->stats.hits == 1, "lookup and hit counts are correct");
+    ok(ip_cache_contains(cache, 1, 0x1000) && !ip_cache_contains(cache, 2, 0x1000) &&
+           cache->stats.lookups == 3,
+       "ip_cache_contains() doesn't count lookups");
+
+    destroyed_value_count = 0;
+    ip_cache_destroy(cache);
+    ok(destroyed_value_count == 1, "destroying the cache destroys its values");
+}
+
+static void test_lru_eviction(void)
+{
+    struct ip_cache *cache = ip_cache_create(3, value_destroy);
+    uint64_t ip;
+
+    for (ip = 1; ip <= 3; ip++) {
+        ip_cache_insert(cache, 1, ip, new_value(ip));
+    }
+
+    /* Make 1 the most recently used entry: 2 is now the LRU one */
+    ip_cache_lookup(cache, 1, 1);
+    destroyed_value_count = 0;
+    ip_cache_insert(cache, 1, 4, new_value(4));
+    ok(destroyed_value_count == 1 && cache->stats.evictions == 1,
+       "insertion in full cache evicts one entry");
+    ok(!ip_cache_lookup(cache, 1, 2), "least recently used entry is evicted");
+    ok(has_entry(cache, 1, 1) && has_entry(cache, 1, 3) && has_entry(cache, 1, 4),
+       "other entries remain");
+    ip_cache_destroy(cache);
+}
+
+static void test_invalidation(void)
+{
+    struct ip_cache *cache = ip_cache_create(8, value_destroy);
+    uint64_t ip;
+
+    for (ip = 0x1000; ip < 0x1004; ip++) {
+        ip_cache_insert(cache, 1, ip, new_value(ip));
+        ip_cache_insert(cache, 2, ip, new_value(ip));
+    }
+
+    ip_cache_invalidate_range(cache, 1, 0x1001, 0x1003);
+    ok(!ip_cache_lookup(cache, 1, 0x1001) && !ip_cache_lookup(cache, 1, 0x1002),
+       "range invalidation removes the entries within the range");
+    ok(has_entry(cache, 1, 0x1000) && has_entry(cache, 1, 0x1003),
+       "range invalidation keeps the entries outside the range");
+    ok(has_entry(cache, 2, 0x1001) && has_entry(cache, 2, 0x1002),
+       "range invalidation keeps the entries of other VPIDs");
+
+    ip_cache_invalidate_vpid(cache, 2);
+    ok(cache->count == 2 && cache->stats.invalidations == 6,
+       "VPID invalidation removes all the entries of the VPID");
+    ip_cache_destroy(cache);
+}
+
+/*
+ * Fill a small cache through many evictions and invalidations so that
+ * the probe sequences collide, and make sure that all the remaining
+ * entries are still reachable.
+ */
+static void test_stress(void)
+{
+    const guint capacity = 64;
+    struct ip_cache *cache = ip_cache_create(capacity, value_destroy);
+    bool all_found = true;
+    uint64_t ip;
+
+    for (ip = 0; ip < 10000; ip++) {
+        if (!ip_cache_lookup(cache, (int64_t) (ip % 3), ip / 3)) {
+            ip_cache_insert(cache, (int64_t) (ip % 3), ip / 3, new_value(ip / 3));
+        }
+
+        if (ip % 500 == 0) {
+            ip_cache_invalidate_range(cache, 1, ip / 3 - ip / 6, ip / 3);
+        }
+    }
+
+    ok(cache->count == capacity, "cache is full");
+
+    for (ip = 10000 - capacity; ip < 10000; ip++) {
+        all_found = all_found && has_entry(cache, (int64_t) (ip % 3), ip / 3);
+    }
+
+    ok(all_found, "most recently inserted entries are found");
+
+    destroyed_value_count = 0;
+    ip_cache_invalidate_vpid(cache, 0);
+    ip_cache_invalidate_vpid(cache, 1);
+    ip_cache_invalidate_vpid(cache, 2);
+    ok(cache->count == 0 && destroyed_value_count == capacity,
+       "invalidating all VPIDs empties the cache");
+    ip_cache_destroy(cache);
+}
+
+int main(void)
+{
+    plan_tests(NR_TESTS);
+
+    test_lookup_insert();
+    test_lru_eviction();
+    test_invalidation();
+    test_stress();
+
+    return exit_status();
+}
@@ -45,6 +45,56 @@ test_debug_info() {
 	done
 }
 
+test_debug_info_sym_cache() {
+	local name="$1"
+	local cache_dir
+	local num_cache_files
+
+	cache_dir=$(mktemp -d -t test-debug-info-sym-cache.XXXXXX)
+
+	local local_args=(
+		"-c" "flt.lttng-utils.debug-info"
+		"-p" "target-prefix=\"$binary_artefact_dir/x86-64-linux-gnu/dwarf-full\""
+		"-p" "cache-dir=\"$cache_dir/cache\""
+		"-c" "sink.text.details"
+		"-p" "with-trace-name=no,with-stream-name=no"
+	)
+
+	# The first run populates the cache and the second one uses it
+	for run in first second; do
+		bt_test_cli "Trace '$name' gives the expected output with a symbolization cache ($run run)" \
+			--expect-stdout "$expect_dir/trace-$name-mip0.expect" -- \
+			"$succeed_trace_dir/$name" "${local_args[@]}" \
+			"--allowed-mip-versions=0"
+	done
+
+	[ -d "$cache_dir/cache" ]
+	ok $? "Symbolization cache directory is created"
+	num_cache_files=$(find "$cache_dir/cache" -type f | wc -l)
+	diag "Symbolization cache files: $num_cache_files"
+
+	rm -rf "$cache_dir"
+}
+
+test_debug_info_symbolization_threads() {
+	local name="$1"
+
+	for thread_count in 1 4; do
+		local local_args=(
+			"-c" "flt.lttng-utils.debug-info"
+			"-p" "target-prefix=\"$binary_artefact_dir/x86-64-linux-gnu/dwarf-full\""
+			"-p" "symbolization-threads=$thread_count"
+			"-c" "sink.text.details"
+			"-p" "with-trace-name=no,with-stream-name=no"
+		)
+
+		bt_test_cli "Trace '$name' gives the expected output with $thread_count symbolization thread(s)" \
+			--expect-stdout "$expect_dir/trace-$name-mip0.expect" -- \
+			"$succeed_trace_dir/$name" "${local_args[@]}" \
+			"--allowed-mip-versions=0"
+	done
+}
+
 test_compare_to_ctf_fs() {
 	# Compare the `sink.text.details` output of a graph with and without a
 	# `flt.lttng-utils.debug-info` component. Both should be identical for
@@ -123,9 +173,11 @@ test_compare_complete_src_trace() {
 	done
 }
 
-plan_tests 22
+plan_tests 35
 
 test_debug_info debug-info
+test_debug_info_sym_cache debug-info
+test_debug_info_symbolization_threads debug-info
 
 test_compare_ctf_src_trace smalltrace
 test_compare_ctf_src_trace 2packets
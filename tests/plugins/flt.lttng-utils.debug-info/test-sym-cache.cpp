@@ -0,0 +1,180 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Copyright (C) 2024 EfficiOS Inc.
+ *
+ * Babeltrace persistent symbolization cache tests
+ */
+
+#include <lttng-utils/debug-info/bin-info.hpp>
+#include <lttng-utils/debug-info/sym-cache.hpp>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tap/tap.h"
+
+#define NR_TESTS 11
+
+static uint8_t build_id[] = {0xde, 0xad, 0xbe, 0xef, 0xca, 0xfe};
+
+static void init_bin(struct bin_info *bin)
+{
+    memset(bin, 0, sizeof(*bin));
+    bin->build_id = build_id;
+    bin->build_id_len = sizeof(build_id);
+}
+
+static struct sym_cache_result make_result(uint64_t offset, char *func_buf, size_t func_buf_size)
+{
+    struct sym_cache_result result = {};
+
+    g_snprintf(func_buf, func_buf_size, "func%" PRIu64, offset);
+    result.func = func_buf;
+
+    /* Odd offsets: unknown source location */
+    if (offset % 2 == 0) {
+        result.has_src_loc = true;
+        result.src_path = "src.c";
+        result.line_no = offset;
+    }
+
+    return result;
+}
+
+static bool is_expected_result(const struct sym_cache_result *result, uint64_t offset)
+{
+    char func_buf[32];
+    const struct sym_cache_result expected = make_result(offset, func_buf, sizeof(func_buf));
+
+    if (!result->func || strcmp(result->func, expected.func) != 0 ||
+        result->has_src_loc != expected.has_src_loc) {
+        return false;
+    }
+
+    return !expected.has_src_loc ||
+           (result->src_path && strcmp(result->src_path, expected.src_path) == 0 &&
+            result->line_no == expected.line_no);
+}
+
+/*
+ * Adds the results of the offsets `first`, `first + step`, ... up to
+ * `last` (excluded) to a new cache using `dir_path`, and then destroys
+ * it to write them back.
+ */
+static void add_results(const char *dir_path, uint64_t first, uint64_t last, uint64_t step)
+{
+    struct sym_cache *cache = sym_cache_create(dir_path, BT_LOGGING_LEVEL_NONE, nullptr);
+    struct sym_cache_file *file;
+    struct bin_info bin;
+    uint64_t offset;
+
+    init_bin(&bin);
+    file = sym_cache_borrow_file(cache, &bin);
+
+    for (offset = first; offset < last; offset += step) {
+        char func_buf[32];
+        const struct sym_cache_result result = make_result(offset, func_buf, sizeof(func_buf));
+
+        sym_cache_file_add(file, offset, &result);
+    }
+
+    sym_cache_destroy(cache);
+}
+
+static bool has_results(struct sym_cache_file *file, uint64_t first, uint64_t last, uint64_t step)
+{
+    uint64_t offset;
+
+    for (offset = first; offset < last; offset += step) {
+        struct sym_cache_result result;
+
+        if (!sym_cache_file_lookup(file, offset, &result) ||
+            !is_expected_result(&result, offset)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(void)
+{
+    struct sym_cache *cache;
+    struct sym_cache_file *file;
+    struct sym_cache_result result;
+    struct bin_info bin;
+    gchar *dir_path;
+    gchar *file_path;
+
+    plan_tests(NR_TESTS);
+
+    dir_path = g_dir_make_tmp("test-sym-cache.XXXXXX", nullptr);
+    if (!dir_path) {
+        diag("Failed to create temporary directory");
+        return EXIT_FAILURE;
+    }
+
+    init_bin(&bin);
+
+    /* No identity: no cache file */
+    cache = sym_cache_create(dir_path, BT_LOGGING_LEVEL_NONE, nullptr);
+    ok(cache, "sym_cache_create succeeds");
+
+    bin.build_id = nullptr;
+    bin.build_id_len = 0;
+    ok(!sym_cache_borrow_file(cache, &bin), "binary without build ID or debug link has no file");
+
+    /* Debug link identity */
+    bin.dbg_link_filename = g_strdup("libfoo.so.debug");
+    bin.dbg_link_crc = 0x1234abcd;
+    file = sym_cache_borrow_file(cache, &bin);
+    ok(file, "binary with a debug link has a file");
+    ok(file && !sym_cache_file_lookup(file, 0x10, &result), "lookup misses in new file");
+    g_free(bin.dbg_link_filename);
+    sym_cache_destroy(cache);
+
+    /* Write, then reload and merge */
+    add_results(dir_path, 0, 1000, 7);
+    file_path = g_build_filename(dir_path, "deadbeefcafe.sym", nullptr);
+    ok(g_file_test(file_path, G_FILE_TEST_IS_REGULAR), "cache file is named after the build ID");
+
+    add_results(dir_path, 3, 1000, 7);
+
+    init_bin(&bin);
+    cache = sym_cache_create(dir_path, BT_LOGGING_LEVEL_NONE, nullptr);
+    file = sym_cache_borrow_file(cache, &bin);
+    ok(has_results(file, 0, 1000, 7), "results of the first run are loaded");
+    ok(has_results(file, 3, 1000, 7), "results of the second run are loaded");
+    ok(!sym_cache_file_lookup(file, 1, &result), "lookup misses for an unknown offset");
+
+    /* New results are found before being written back */
+    {
+        char func_buf[32];
+        const struct sym_cache_result new_result = make_result(1, func_buf, sizeof(func_buf));
+
+        sym_cache_file_add(file, 1, &new_result);
+    }
+
+    ok(sym_cache_file_lookup(file, 1, &result) && is_expected_result(&result, 1),
+       "lookup hits for a new result");
+    sym_cache_destroy(cache);
+
+    /* Invalid file is ignored */
+    g_file_set_contents(file_path, "garbage", -1, nullptr);
+    cache = sym_cache_create(dir_path, BT_LOGGING_LEVEL_NONE, nullptr);
+    file = sym_cache_borrow_file(cache, &bin);
+    ok(file, "binary with an invalid cache file has a file");
+    ok(file && !sym_cache_file_lookup(file, 0, &result), "invalid cache file is ignored");
+    sym_cache_destroy(cache);
+
+    g_unlink(file_path);
+    g_rmdir(dir_path);
+    g_free(file_path);
+    g_free(dir_path);
+    return exit_status();
+}
@@ -0,0 +1,227 @@
+#!/bin/bash
+#
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Copyright (C) 2024 EfficiOS Inc.
+#
+
+# This file tests the sampling modes of flt.utils.sampler: the output
+# must contain the expected number of events, and discarded events
+# messages must report all the other events.
+#
+# It also checks that a sink.ctf.fs component accepts the discarded
+# events messages of the sampler, and that reading the resulting trace
+# gives the same events and discarded events messages back.
+
+SH_TAP=1
+
+if [ -n "${BT_TESTS_SRCDIR:-}" ]; then
+	UTILSSH="$BT_TESTS_SRCDIR/utils/utils.sh"
+else
+	UTILSSH="$(dirname "$0")/../../utils/utils.sh"
+fi
+
+# shellcheck source=../../utils/utils.sh
+source "$UTILSSH"
+
+data_dir="$BT_TESTS_DATADIR/plugins/flt.utils.sampler"
+
+# The generated trace has two streams with 20 and 14 events of the
+# classes `a` and `b`, 100 ns apart, within packets of which the first
+# one contains a single event. The `value` payload member field of the
+# events varies from 0 to 4.
+#
+# The third packet of the first stream has 2 discarded events: the
+# source emits a discarded events message before it.
+temp_trace_dir=$(mktemp -d)
+total_event_count=34
+upstream_discarded_event_count=2
+
+temp_expected_stdout=$(mktemp)
+temp_stdout=$(mktemp)
+temp_stderr=$(mktemp)
+temp_expected_lines=$(mktemp)
+temp_lines=$(mktemp)
+
+details_args=(-c sink.text.details -p 'compact=yes,with-metadata=no')
+pretty_args=(-c sink.text.pretty -p 'no-delta=yes')
+
+# Prints the number of event messages of the compact
+# `sink.text.details` output file `$1`.
+event_count() {
+	grep -c '} Event `' "$1"
+}
+
+# Prints the sum of the counts of the discarded events messages of the
+# compact `sink.text.details` output file `$1`.
+discarded_event_count() {
+	grep -o 'Discarded events ([0-9,]* events)' "$1" | tr -dc '0-9\n' |
+		awk '{ sum += $1 } END { print sum + 0 }'
+}
+
+# Prints the number of events of which the `value` payload member
+# field is `$2` in the `sink.text.pretty` output file `$1`.
+value_event_count() {
+	grep -c "{ value = $2 }" "$1"
+}
+
+# Runs flt.utils.sampler with the parameter arguments `$@` and a
+# sink.text.details component, writing the output to `$temp_stdout`,
+# and records a TAP result with the description `$desc`.
+run_sampling() {
+	bt_cli --stdout-file "$temp_stdout" --stderr-file "$temp_stderr" -- \
+		"$temp_trace_dir" -c flt.utils.sampler "$@" "${details_args[@]}"
+	if ! ok $? "$desc: exit status"; then
+		diag "stderr:"
+		diag_file "$temp_stderr"
+	fi
+}
+
+# Checks that the discarded events messages of `$temp_stdout` report
+# all the events which aren't in `$temp_stdout`.
+check_discarded_event_count() {
+	local -r kept_event_count=$(event_count "$temp_stdout")
+
+	is "$(discarded_event_count "$temp_stdout")" \
+		"$((total_event_count - kept_event_count + upstream_discarded_event_count))" \
+		"$desc: discarded event count"
+}
+
+# Runs flt.utils.sampler with the parameter arguments `${@:3}`, and
+# then checks that the output contains `$2` events. `$1` is the
+# test description.
+test_sampling() {
+	local -r desc="$1"
+	local -r expected_event_count="$2"
+	shift 2
+
+	run_sampling "$@"
+	is "$(event_count "$temp_stdout")" "$expected_event_count" \
+		"$desc: event count"
+	check_discarded_event_count
+}
+
+# Runs flt.utils.sampler in hash mode, hashing the `value` payload
+# member field with the interval `$1`, and then checks that:
+#
+# • The discarded events messages report the other events.
+#
+# • For each value, the output contains either all the events having
+#   this value or none of them.
+#
+# This doesn't check which values the output contains: this depends on
+# their hash.
+test_hash_sampling() {
+	local -r interval=$1
+	local -r desc="hash mode, interval $interval"
+	local -r params="mode=\"hash\",field=\"value\",interval=+$interval"
+	local ret=0
+	local value
+	local expected_count
+	local count
+
+	run_sampling -p "$params"
+	check_discarded_event_count
+
+	bt_cli --stdout-file "$temp_stdout" -- \
+		"$temp_trace_dir" -c flt.utils.sampler -p "$params" "${pretty_args[@]}"
+
+	for value in 0 1 2 3 4; do
+		expected_count=$(value_event_count "$temp_expected_stdout" "$value")
+		count=$(value_event_count "$temp_stdout" "$value")
+
+		if ((count != 0 && count != expected_count)); then
+			diag "value $value: $count events instead of 0 or $expected_count"
+			ret=1
+		fi
+	done
+
+	ok "$ret" "$desc: keeps or discards all the events having a given value"
+}
+
+# Runs flt.utils.sampler with the parameter arguments `$@`, and then
+# checks that it fails.
+test_sampling_fails() {
+	bt_cli --stderr-file "$temp_stderr" -- \
+		"$temp_trace_dir" -c flt.utils.sampler "$@" "${details_args[@]}"
+	isnt $? 0 "invalid parameters fail: $*"
+}
+
+plan_tests 47
+
+bt_gen_mctf_trace "$data_dir/trace.mctf" "$temp_trace_dir"
+
+# Baseline (without sampling)
+bt_cli --stdout-file "$temp_expected_stdout" -- "$temp_trace_dir" "${details_args[@]}"
+is "$(event_count "$temp_expected_stdout")" "$total_event_count" "baseline event count"
+is "$(discarded_event_count "$temp_expected_stdout")" "$upstream_discarded_event_count" \
+	"baseline discarded event count"
+
+bt_cli --stdout-file "$temp_stdout" -- \
+	"$temp_trace_dir" -c flt.utils.sampler -p 'interval=+1' "${details_args[@]}"
+bt_diff "$temp_expected_stdout" "$temp_stdout"
+ok $? "sampling interval 1 keeps all the messages"
+
+# Count mode: keep the events 0, 3, 6, ... of each class within each
+# stream (`a`: 14 and 11 events, `b`: 6 and 3 events).
+test_sampling "count mode, interval 3" 12 -p 'interval=+3'
+
+# Count mode with the default interval (10): keep the events 0 and 10 of
+# each class within each stream
+test_sampling "count mode, default interval" 6 -p 'mode="count"'
+
+# Time mode: keep the first event of each class within each stream and
+# time bucket
+test_sampling "time mode, 300-ns period" 25 -p 'mode="time",period=+300'
+test_sampling "time mode, 1000-ns period" 12 -p 'mode="time",period=+1000'
+test_sampling "time mode, 1000-second period" 4 -p 'mode="time",period=+1000000000000'
+
+# Hash mode
+test_sampling "hash mode, interval 1" "$total_event_count" \
+	-p 'mode="hash",field="value",interval=+1'
+test_sampling "hash mode, missing field" "$total_event_count" \
+	-p 'mode="hash",field="nope",interval=+2'
+
+bt_cli --stdout-file "$temp_expected_stdout" -- "$temp_trace_dir" "${pretty_args[@]}"
+
+for interval in 2 3 5; do
+	test_hash_sampling "$interval"
+done
+
+# Event class names: keep all the `b` events (9) and 9 `a` events
+test_sampling "sampled event class" 18 -p 'interval=+3,event-class-names=["a"]'
+test_sampling "not sampled event class" "$total_event_count" \
+	-p 'interval=+3,event-class-names=["nope"]'
+
+# Write the sampled trace with sink.ctf.fs and read it back
+temp_output_dir=$(mktemp -d)
+
+bt_cli --stderr-file "$temp_stderr" -- "$temp_trace_dir" \
+	-c flt.utils.sampler -p 'interval=+3' \
+	-c sink.ctf.fs -p "path=\"${temp_output_dir}\"" \
+	-p 'ctf-version="1"' -p 'quiet=true'
+if ! ok $? "sink.ctf.fs accepts the sampled messages"; then
+	diag "stderr:"
+	diag_file "$temp_stderr"
+fi
+
+bt_cli --stdout-file "$temp_expected_stdout" -- \
+	"$temp_trace_dir" -c flt.utils.sampler -p 'interval=+3' "${details_args[@]}"
+bt_cli --stdout-file "$temp_stdout" -- "$temp_output_dir" "${details_args[@]}"
+grep -E '} (Event `|Discarded events)' "$temp_expected_stdout" > "$temp_expected_lines"
+grep -E '} (Event `|Discarded events)' "$temp_stdout" > "$temp_lines"
+bt_diff "$temp_expected_lines" "$temp_lines"
+ok $? "written sampled trace has the same events and discarded events messages"
+rm -rf "$temp_output_dir"
+
+# Invalid parameters
+test_sampling_fails -p 'interval=+0'
+test_sampling_fails -p 'mode="time"'
+test_sampling_fails -p 'mode="time",period=+0'
+test_sampling_fails -p 'mode="hash"'
+test_sampling_fails -p 'mode="meow"'
+test_sampling_fails -p 'interval=3'
+
+rm -rf "$temp_trace_dir"
+rm -f "$temp_expected_stdout" "$temp_stdout" "$temp_stderr" "$temp_expected_lines" \
+	"$temp_lines"
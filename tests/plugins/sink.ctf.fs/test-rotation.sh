@@ -0,0 +1,226 @@
+#!/bin/bash
+#
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Copyright (C) 2024 EfficiOS Inc.
+#
+
+# This file tests the `rotate-size` and `rotate-duration` parameters of
+# sink.ctf.fs.
+#
+# The first part copies a generated single-stream trace of which the
+# packets all have the same size and known beginning/end times, so that
+# the trace chunks to expect (count, packets, size, duration) are
+# known exactly.
+#
+# The second part copies a multi-stream LTTng trace: the output trace
+# chunks must be complete CTF traces which, read together, contain the
+# same events as the input trace.
+
+SH_TAP=1
+
+if [ -n "${BT_TESTS_SRCDIR:-}" ]; then
+	UTILSSH="$BT_TESTS_SRCDIR/utils/utils.sh"
+else
+	UTILSSH="$(dirname "$0")/../../utils/utils.sh"
+fi
+
+# shellcheck source=../../utils/utils.sh
+source "$UTILSSH"
+
+data_dir="$BT_TESTS_DATADIR/plugins/sink.ctf.fs/rotation"
+
+temp_gen_trace_dir=$(mktemp -d)
+temp_expected_stdout=$(mktemp)
+temp_stdout=$(mktemp)
+temp_sorted_stdout=$(mktemp)
+temp_stderr=$(mktemp)
+temp_begins=$(mktemp)
+temp_ends=$(mktemp)
+
+plan_tests 27
+
+# Prints the path of the directory of trace chunk `$2` of the output
+# trace within the directory `$1`.
+chunk_dir() {
+	echo "$(find "$1" -type d -name archives)/chunk-$2"
+}
+
+# Prints the number of trace chunks of the output trace within the
+# directory `$1`.
+chunk_count() {
+	find "$1" -path '*/archives/chunk-*' -type d | wc -l | tr -d ' '
+}
+
+# Prints the total size, in bytes, of the data stream files of the
+# trace chunk directory `$1`.
+chunk_data_size() {
+	find "$1" -type f ! -name metadata -exec cat {} + | wc -c | tr -d ' '
+}
+
+# Prints the default clock snapshot values of the packet beginning
+# (`$2` is `beginning`) or packet end (`$2` is `end`) messages of the
+# trace chunk directory `$1`, one per line.
+chunk_packet_times() {
+	bt_cli --stdout-file "$temp_stdout" -- "$1" \
+		-c sink.text.details -p 'compact=yes,with-metadata=no,color="never"'
+	sed -n "s/^\[\([0-9,]*\) .*Packet $2\$/\1/p" "$temp_stdout" | tr -d ,
+}
+
+# Copies the generated trace with sink.ctf.fs parameter `$1` and then
+# checks:
+#
+# • The number of trace chunks (`$2`).
+# • That each chunk has its own metadata file.
+# • The space-separated numbers of packets of the chunks (`$3`).
+# • The size or duration bound of each chunk (`$4` is `size` or
+#   `duration`, with the bound `$5`).
+# • That the chunks, read together, contain the input events.
+#
+# For the `size` bound, `$6` is the size of a single output packet.
+test_gen_trace_rotation() {
+	local -r rotate_param=$1
+	local -r expected_chunk_count=$2
+	local -r expected_packet_counts=$3
+	local -r bound_kind=$4
+	local -r bound=$5
+	local -r packet_size=${6:-}
+	local -r temp_output_dir=$(mktemp -d)
+	local packet_counts=""
+	local bounds_ok=0
+	local metadata_ok=0
+	local i
+
+	bt_cli --stderr-file "$temp_stderr" -- "$temp_gen_trace_dir" \
+		-c sink.ctf.fs -p "path=\"${temp_output_dir}\"" \
+		-p 'ctf-version="1"' -p 'quiet=true' -p "$rotate_param"
+	ok "$?" "copy generated trace with $rotate_param"
+
+	bt_diff "/dev/null" "$temp_stderr"
+	ok "$?" "stderr is empty ($rotate_param)"
+
+	is "$(chunk_count "$temp_output_dir")" "$expected_chunk_count" \
+		"trace chunk count ($rotate_param)"
+
+	for ((i = 0; i < expected_chunk_count; i++)); do
+		local dir
+		local packet_count
+		local size
+
+		dir=$(chunk_dir "$temp_output_dir" "$i")
+
+		if [[ ! -f "$dir/metadata" ]]; then
+			diag "no metadata file in \`$dir\`"
+			metadata_ok=1
+		fi
+
+		chunk_packet_times "$dir" beginning > "$temp_begins"
+		chunk_packet_times "$dir" end > "$temp_ends"
+		packet_count=$(wc -l < "$temp_begins" | tr -d ' ')
+		packet_counts+="${packet_counts:+ }$packet_count"
+
+		if [[ $bound_kind == size ]]; then
+			size=$(chunk_data_size "$dir")
+
+			# The chunk only exceeds the bound because of its last packet
+			if ((size - packet_size >= bound)); then
+				diag "chunk $i: size $size exceeds bound $bound by more than one packet"
+				bounds_ok=1
+			fi
+
+			# Only the last chunk may be smaller than the bound
+			if ((i < expected_chunk_count - 1 && size < bound)); then
+				diag "chunk $i: size $size is less than bound $bound"
+				bounds_ok=1
+			fi
+		else
+			local first_begin
+			local last_end
+			local prev_end
+
+			first_begin=$(head -n 1 "$temp_begins")
+			last_end=$(tail -n 1 "$temp_ends")
+
+			# The chunk only exceeds the bound because of its last packet
+			if ((packet_count > 1)); then
+				prev_end=$(tail -n 2 "$temp_ends" | head -n 1)
+
+				if ((prev_end - first_begin >= bound)); then
+					diag "chunk $i: duration exceeds bound $bound by more than one packet"
+					bounds_ok=1
+				fi
+			fi
+
+			# Only the last chunk may be shorter than the bound
+			if ((i < expected_chunk_count - 1 && last_end - first_begin < bound)); then
+				diag "chunk $i: duration $((last_end - first_begin)) is less than bound $bound"
+				bounds_ok=1
+			fi
+		fi
+	done
+
+	ok "$metadata_ok" "one metadata file per trace chunk ($rotate_param)"
+	is "$packet_counts" "$expected_packet_counts" \
+		"packets per trace chunk ($rotate_param)"
+	ok "$bounds_ok" "$bound_kind bound of each trace chunk ($rotate_param)"
+
+	# Single stream: the order of the events is the same
+	bt_cli --stdout-file "$temp_stdout" --stderr-file "$temp_stderr" -- \
+		--no-delta "$temp_output_dir"
+	bt_diff "$temp_expected_stdout" "$temp_stdout"
+	ok "$?" "trace chunks contain the input events ($rotate_param)"
+
+	rm -rf "$temp_output_dir"
+}
+
+bt_gen_mctf_trace "$data_dir/trace.mctf" "$temp_gen_trace_dir"
+bt_cli --stdout-file "$temp_expected_stdout" -- --no-delta "$temp_gen_trace_dir"
+
+# Eight packets: one per trace chunk, which gives the size of an output
+# packet.
+temp_output_dir=$(mktemp -d)
+bt_cli -- "$temp_gen_trace_dir" -c sink.ctf.fs -p "path=\"${temp_output_dir}\"" \
+	-p 'ctf-version="1"' -p 'quiet=true' -p 'rotate-size=+1'
+packet_size=$(chunk_data_size "$(chunk_dir "$temp_output_dir" 0)")
+rm -rf "$temp_output_dir"
+
+test_gen_trace_rotation 'rotate-size=+1' 8 '1 1 1 1 1 1 1 1' size 1 "$packet_size"
+
+# Two packets are below the bound while three reach it
+test_gen_trace_rotation "rotate-size=+$((2 * packet_size + 1))" 3 '3 3 2' \
+	size $((2 * packet_size + 1)) "$packet_size"
+
+# Packet N spans [1000 N, 1000 N + 900] ns: packets 0 to 2 span 2900 ns,
+# packets 3 to 5 span 2900 ns, and packets 6 and 7 span 1900 ns.
+test_gen_trace_rotation 'rotate-duration=+2500' 3 '3 3 2' duration 2500
+
+input_trace="$BT_CTF_TRACES_PATH/1/succeed/lttng-tracefile-rotation"
+
+bt_cli --stdout-file "$temp_stdout" -- --no-delta "$input_trace"
+sort "$temp_stdout" > "$temp_expected_stdout"
+
+for rotate_param in 'rotate-size=+1' 'rotate-duration=+1000000'; do
+	temp_output_dir=$(mktemp -d)
+
+	bt_cli --stderr-file "$temp_stderr" -- "$input_trace" \
+		-c sink.ctf.fs -p "path=\"${temp_output_dir}\"" \
+		-p 'ctf-version="1"' -p 'quiet=true' -p "$rotate_param"
+	ok "$?" "copy LTTng trace with $rotate_param"
+
+	num_chunks=$(chunk_count "$temp_output_dir")
+	test "$num_chunks" -gt 1
+	ok "$?" "more than one trace chunk (LTTng, $rotate_param)"
+
+	# Streams interleave: events with the same time may be reordered
+	bt_cli --stdout-file "$temp_stdout" --stderr-file "$temp_stderr" -- \
+		--no-delta "$temp_output_dir"
+	sort "$temp_stdout" > "$temp_sorted_stdout"
+	bt_diff "$temp_expected_stdout" "$temp_sorted_stdout"
+	ok "$?" "trace chunks contain the input events (LTTng, $rotate_param)"
+
+	rm -rf "$temp_output_dir"
+done
+
+rm -rf "$temp_gen_trace_dir"
+rm -f "$temp_expected_stdout" "$temp_stdout" "$temp_sorted_stdout" "$temp_stderr" \
+	"$temp_begins" "$temp_ends"
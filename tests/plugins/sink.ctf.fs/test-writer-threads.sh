@@ -0,0 +1,148 @@
+#!/bin/bash
+#
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Copyright (C) 2024 EfficiOS Inc.
+#
+
+# This file tests the `writer-threads` parameter of sink.ctf.fs: the
+# output data stream files must be the same, byte for byte (except for
+# the random trace UUID), whatever the number of writer threads.
+
+SH_TAP=1
+
+if [ -n "${BT_TESTS_SRCDIR:-}" ]; then
+	UTILSSH="$BT_TESTS_SRCDIR/utils/utils.sh"
+else
+	UTILSSH="$(dirname "$0")/../../utils/utils.sh"
+fi
+
+# shellcheck source=../../utils/utils.sh
+source "$UTILSSH"
+
+# Directory containing the Python test source.
+data_dir="$BT_TESTS_DATADIR/plugins/sink.ctf.fs/writer-threads"
+
+temp_expected_hex=$(mktemp)
+temp_hex=$(mktemp)
+temp_stderr=$(mktemp)
+
+trace_names=(multi-domains no-packet-context smalltrace wk-heartbeat-u)
+thread_counts=(1 3)
+
+# Per trace: copy without writer threads, and then, for each thread
+# count, copy and compare
+tests_per_trace=$((1 + ${#thread_counts[@]} * 2))
+
+plan_tests $(((${#trace_names[@]} + 1) * tests_per_trace))
+
+# Prints the contents of the file `$1` as a single line of hexadecimal
+# bytes, replacing the trace UUID of its packet headers with `UUID`.
+#
+# The trace UUID is at offset 4 of the header of each packet.
+hex_without_uuid() {
+	local uuid
+
+	uuid=$(od -An -v -tx1 -j4 -N16 "$1" | tr -d ' \n')
+	od -An -v -tx1 "$1" | tr -d ' \n' | sed "s/$uuid/UUID/g"
+	echo
+}
+
+# Copies a trace with sink.ctf.fs into the directory `$2`, with `$3`
+# writer threads (0: none), passing the remaining arguments to bt_cli(),
+# and records a TAP result with the description `$1`.
+copy_trace() {
+	local -r desc=$1
+	local -r output_dir=$2
+	local -r thread_count=$3
+	local -a writer_threads_param=()
+
+	shift 3
+
+	if ((thread_count > 0)); then
+		writer_threads_param=(-p "writer-threads=+$thread_count")
+	fi
+
+	bt_cli --stderr-file "$temp_stderr" -- "$@" \
+		-c sink.ctf.fs -p "path=\"${output_dir}\"" \
+		-p 'ctf-version="1"' -p 'quiet=true' "${writer_threads_param[@]}"
+	if ! ok "$?" "copy trace ($desc)"; then
+		diag "stderr:"
+		diag_file "$temp_stderr"
+	fi
+}
+
+# Compares the data stream files of the output trace directories
+# `$2` (expected) and `$3`, and records a TAP result with the
+# description `$1`.
+compare_data_stream_files() {
+	local -r desc=$1
+	local -r expected_dir=$2
+	local -r actual_dir=$3
+	local expected_files
+	local actual_files
+	local ret=0
+	local file
+
+	expected_files=$(cd "$expected_dir" && find . -type f ! -name metadata | sort)
+	actual_files=$(cd "$actual_dir" && find . -type f ! -name metadata | sort)
+
+	if [[ -z $expected_files || $expected_files != "$actual_files" ]]; then
+		diag "different data stream files:"
+		diag "$expected_files"
+		diag "$actual_files"
+		ret=1
+	else
+		while read -r file; do
+			hex_without_uuid "$expected_dir/$file" > "$temp_expected_hex"
+			hex_without_uuid "$actual_dir/$file" > "$temp_hex"
+
+			if ! cmp -s "$temp_expected_hex" "$temp_hex"; then
+				diag "\`$file\` differs"
+				ret=1
+			fi
+		done <<< "$expected_files"
+	fi
+
+	ok "$ret" "data stream files are the same ($desc)"
+}
+
+# Copies a trace without writer threads and then with each count of
+# `thread_counts`, comparing the data stream files, passing the
+# arguments after `$1` (trace name) to bt_cli().
+test_writer_threads() {
+	local -r trace_name=$1
+	local -r expected_output_dir=$(mktemp -d)
+	local output_dir
+	local thread_count
+
+	shift
+
+	copy_trace "$trace_name, no writer threads" "$expected_output_dir" 0 "$@"
+
+	for thread_count in "${thread_counts[@]}"; do
+		local desc="$trace_name, $thread_count writer thread(s)"
+
+		output_dir=$(mktemp -d)
+		copy_trace "$desc" "$output_dir" "$thread_count" "$@"
+		compare_data_stream_files "$desc" "$expected_output_dir" "$output_dir"
+		rm -rf "$output_dir"
+	done
+
+	rm -rf "$expected_output_dir"
+}
+
+for trace_name in "${trace_names[@]}"; do
+	test_writer_threads "$trace_name" "$BT_CTF_TRACES_PATH/1/succeed/$trace_name"
+done
+
+# Streams without packets of which the component splits the events
+# into artificial packets of at least 4 MiB
+if [ "$BT_TESTS_ENABLE_PYTHON_PLUGINS" = "1" ]; then
+	test_writer_threads "streams without packets" \
+		"--plugin-path=${data_dir}" -c src.foo.TheSource
+else
+	skip 0 "This test requires the Python plugin provider" "$tests_per_trace"
+fi
+
+rm -f "$temp_expected_hex" "$temp_hex" "$temp_stderr"
@@ -15,9 +15,31 @@ fi
 # shellcheck source=../../utils/utils.sh
 source "$UTILSSH"
 
-plan_tests 3
+plan_tests 11
 
 bt_test_cli "show basic bit array fields with flags" \
 	--expect-stdout "$BT_TESTS_DATADIR/plugins/sink.text.pretty/fl-bm-ctf2.expect" \
 	-- \
 	"$BT_TESTS_DATADIR/ctf-traces/2/succeed/fl-bm"
+
+# The output doesn't depend on when the component writes it
+for size in 0 16; do
+	bt_test_cli "output buffer size $size" \
+		--expect-stdout "$BT_TESTS_DATADIR/plugins/sink.text.pretty/fl-bm-ctf2.expect" \
+		-- \
+		"$BT_TESTS_DATADIR/ctf-traces/2/succeed/fl-bm" \
+		-c sink.text.pretty -p "output-buffer-size=+$size"
+done
+
+# Failing to write the pending output makes the graph fail instead of
+# losing the output
+if [ -w /dev/full ]; then
+	bt_test_cli "output write error" \
+		--expect-exit-status 1 \
+		--expect-stderr-re 'Failed to write output' \
+		-- \
+		"$BT_TESTS_DATADIR/ctf-traces/2/succeed/fl-bm" \
+		-c sink.text.pretty -p "path=\"/dev/full\",output-buffer-size=+65536"
+else
+	skip 0 "\`/dev/full\` isn't available" 2
+fi
@@ -0,0 +1,107 @@
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Copyright (C) 2024 EfficiOS Inc.
+#
+
+import os
+import shutil
+import tempfile
+import unittest
+
+import bt2
+
+test_ctf_traces_path = os.environ["BT_CTF_TRACES_PATH"]
+query_object = "babeltrace.trace-infos"
+
+# Messages which `source.ctf.fs` logs when it builds and caches the
+# index of a data stream file, and when it uses a cached index.
+cached_msg = "Cached index of data stream file"
+using_cached_msg = "Using cached index of data stream file"
+
+
+# Returns what the library and the plugins log to the standard error
+# file descriptor while calling `func`.
+def capture_log(func):
+    with tempfile.TemporaryFile(mode="w+") as log_file:
+        saved_fd = os.dup(2)
+        os.dup2(log_file.fileno(), 2)
+
+        try:
+            func()
+        finally:
+            os.dup2(saved_fd, 2)
+            os.close(saved_fd)
+
+        log_file.seek(0)
+        return log_file.read()
+
+
+class QueryIndexCacheTestCase(unittest.TestCase):
+    def setUp(self):
+        ctf = bt2.find_plugin("ctf")
+        self._fs = ctf.source_component_classes["fs"]
+
+        # Work on a copy of the trace to be able to modify it
+        self._tmp_dir = tempfile.mkdtemp()
+        self._trace_path = os.path.join(self._tmp_dir, "trace")
+        shutil.copytree(
+            os.path.join(test_ctf_traces_path, "1", "intersection", "3eventsintersect"),
+            self._trace_path,
+        )
+
+    def tearDown(self):
+        shutil.rmtree(self._tmp_dir)
+
+    def _query(self):
+        query_exec = bt2.QueryExecutor(
+            self._fs, query_object, {"inputs": [self._trace_path]}
+        )
+        query_exec.logging_level = bt2.LoggingLevel.INFO
+        query_exec.query()
+
+    def _create_comp(self):
+        bt2.Graph().add_component(
+            self._fs,
+            "src",
+            {"inputs": [self._trace_path]},
+            logging_level=bt2.LoggingLevel.INFO,
+        )
+
+    # A query followed by the creation of a component indexes each of
+    # the two data stream files once.
+    def test_query_then_comp(self):
+        log = capture_log(self._query)
+        self.assertEqual(log.count(cached_msg), 2)
+        self.assertEqual(log.count(using_cached_msg), 0)
+
+        log = capture_log(self._create_comp)
+        self.assertEqual(log.count(cached_msg), 0)
+        self.assertEqual(log.count(using_cached_msg), 2)
+
+    # A data stream file rewritten with the same size during the same
+    # second as the query is indexed again.
+    def test_modified_file(self):
+        capture_log(self._query)
+
+        path = os.path.join(self._trace_path, "test_stream_0")
+
+        with open(path, "rb") as f:
+            data = f.read()
+
+        st = os.stat(path)
+
+        with open(path, "wb") as f:
+            f.write(data)
+
+        # Same second, different nanoseconds
+        sec_ns = st.st_mtime_ns - st.st_mtime_ns % 1000000000
+        mtime_ns = sec_ns + (st.st_mtime_ns + 1) % 1000000000
+        os.utime(path, ns=(st.st_atime_ns, mtime_ns))
+
+        log = capture_log(self._create_comp)
+        self.assertEqual(log.count(cached_msg), 1)
+        self.assertEqual(log.count(using_cached_msg), 1)
+
+
+if __name__ == "__main__":
+    unittest.main()